@@ -0,0 +1,490 @@
+#include "objgenerator.hpp"
+#include "../src/model/loader/meshcache.hpp"
+#include "../src/model/loader/modelloader.hpp"
+#include "../src/model/loader/objloader.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/** Benchmarked file with the phases of every run */
+struct Result
+{
+    std::string name;
+    std::size_t bytes;
+    std::size_t positions;
+    std::size_t vertices;
+    std::size_t triangles;
+    std::size_t objects;
+    std::vector<std::vector<ModelLoader::Phase>> run_stock;
+};
+
+static void printUsage(const char *const program)
+{
+    std::cerr << "usage: " << program << " [options] [file.obj|ply|stl|gltf|glb ...]\n"
+              << "Times the read phases of the model loader without a GL context. Without files and\n"
+              << "without --shape a fixed suite of synthetic models is generated and measured.\n\n"
+              << "  --shape grid|sphere|soup  generate a single model of this shape\n"
+              << "  --resolution N            segments per side of the generated model (256)\n"
+              << "  --triangles               write triangles instead of quads\n"
+              << "  --no-uv                   write no texture coordinates\n"
+              << "  --no-normals              write no normals\n"
+              << "  --materials N             materials in the library, 0 writes none (1)\n"
+              << "  --switches N              usemtl statements spread over the faces (1)\n"
+              << "  --seed N                  seed of the random soup and colors (1)\n"
+              << "  --scale F                 resolution factor of the suite models (1)\n"
+              << "  --runs N                  loads of every model (3)\n"
+              << "  --options N               loader options mask (" << ModelLoader::ALL_OPTIONS << ")\n"
+              << "  --lod-levels N            simplified levels with the LOD option (" << ModelLoader::getLodLevels() << ")\n"
+              << "  --mode stream|mapped      OBJ parser (mapped)\n"
+              << "  --threads N               parser threads, 0 uses every hardware thread (0)\n"
+              << "  --cache                   keep the binary mesh cache enabled\n"
+              << "  --format csv|json         output format (csv)\n"
+              << "  --output FILE             write the results to a file instead of stdout\n"
+              << "  --directory DIR           where the generated models are written (.)\n"
+              << "  --keep                    keep the generated models\n";
+}
+
+static bool parseSize(const std::string &text, std::size_t &value)
+{
+    char *end = nullptr;
+    const unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+
+    if (text.empty() || (*end != '\0'))
+    {
+        return false;
+    }
+
+    value = static_cast<std::size_t>(parsed);
+    return true;
+}
+
+static std::size_t fileSize(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file.is_open() ? static_cast<std::size_t>(file.tellg()) : 0U;
+}
+
+static std::string escape(const std::string &str)
+{
+    std::string result;
+
+    for (const char c : str)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            result += '\\';
+        }
+
+        result += c;
+    }
+
+    return result;
+}
+
+static double total(const std::vector<ModelLoader::Phase> &phase_stock)
+{
+    double seconds = 0.0;
+
+    for (const ModelLoader::Phase &phase : phase_stock)
+    {
+        seconds += phase.seconds;
+    }
+
+    return seconds;
+}
+
+static bool measure(const std::string &name, const std::string &path, const std::size_t &runs, const GLenum &options, Result &result)
+{
+    result.name = name;
+    result.bytes = fileSize(path);
+    result.run_stock.clear();
+
+    for (std::size_t run = 0U; run < runs; run++)
+    {
+        std::vector<ModelLoader::Phase> phase_stock;
+        ModelData *const model_data = ModelLoader::loadHeadless(path, ModelLoader::getFormat(path), options, phase_stock);
+        const bool open = model_data->model_open;
+
+        result.positions = model_data->vertices;
+        result.vertices = model_data->elements;
+        result.triangles = model_data->triangles;
+        result.objects = model_data->object_stock.size();
+        delete model_data;
+
+        if (!open)
+        {
+            std::cerr << "error: could not load `" << path << "'" << std::endl;
+            return false;
+        }
+
+        std::cerr << name << " run " << run + 1U << "/" << runs << ": " << total(phase_stock) << " s" << std::endl;
+        result.run_stock.emplace_back(phase_stock);
+    }
+
+    return true;
+}
+
+static void writeCSV(std::ostream &out, const std::vector<Result> &result_stock)
+{
+    out << "case,bytes,positions,vertices,triangles,objects,run,phase,seconds\n";
+
+    for (const Result &result : result_stock)
+    {
+        const std::string prefix = result.name + "," + std::to_string(result.bytes) + "," + std::to_string(result.positions) + "," + std::to_string(result.vertices) + "," +
+                                   std::to_string(result.triangles) + "," + std::to_string(result.objects) + ",";
+
+        for (std::size_t run = 0U; run < result.run_stock.size(); run++)
+        {
+            for (const ModelLoader::Phase &phase : result.run_stock[run])
+            {
+                out << prefix << run + 1U << "," << phase.name << "," << phase.seconds << "\n";
+            }
+
+            out << prefix << run + 1U << ",total," << total(result.run_stock[run]) << "\n";
+        }
+    }
+}
+
+/** Besides every run, each case reports the best time of every phase, the least noisy figure to compare nightly */
+static void writeJSON(std::ostream &out, const std::vector<Result> &result_stock, const GLenum &options)
+{
+    out << "{\n  \"mode\": \"" << (OBJLoader::getMode() == OBJLoader::STREAM ? "stream" : "mapped") << "\",\n"
+        << "  \"threads\": " << OBJLoader::getThreads() << ",\n"
+        << "  \"options\": " << options << ",\n"
+        << "  \"cases\": [";
+
+    for (std::size_t i = 0U; i < result_stock.size(); i++)
+    {
+        const Result &result = result_stock[i];
+        std::vector<std::pair<std::string, double>> best_stock;
+
+        out << (i == 0U ? "\n" : ",\n") << "    {\n"
+            << "      \"name\": \"" << escape(result.name) << "\",\n"
+            << "      \"bytes\": " << result.bytes << ",\n"
+            << "      \"positions\": " << result.positions << ",\n"
+            << "      \"vertices\": " << result.vertices << ",\n"
+            << "      \"triangles\": " << result.triangles << ",\n"
+            << "      \"objects\": " << result.objects << ",\n"
+            << "      \"runs\": [";
+
+        for (std::size_t run = 0U; run < result.run_stock.size(); run++)
+        {
+            const std::vector<ModelLoader::Phase> &phase_stock = result.run_stock[run];
+            out << (run == 0U ? "" : ", ") << "{";
+
+            for (std::size_t j = 0U; j <= phase_stock.size(); j++)
+            {
+                const std::string name = j < phase_stock.size() ? phase_stock[j].name : "total";
+                const double seconds = j < phase_stock.size() ? phase_stock[j].seconds : total(phase_stock);
+                std::vector<std::pair<std::string, double>>::iterator best = std::find_if(best_stock.begin(), best_stock.end(), [&name](const std::pair<std::string, double> &entry) { return entry.first == name; });
+
+                if (best == best_stock.end())
+                {
+                    best_stock.emplace_back(name, seconds);
+                }
+
+                else
+                {
+                    best->second = std::min(best->second, seconds);
+                }
+
+                out << (j == 0U ? "" : ", ") << "\"" << name << "\": " << seconds;
+            }
+
+            out << "}";
+        }
+
+        out << "],\n      \"best\": {";
+
+        for (std::size_t j = 0U; j < best_stock.size(); j++)
+        {
+            out << (j == 0U ? "" : ", ") << "\"" << best_stock[j].first << "\": " << best_stock[j].second;
+        }
+
+        out << "}\n    }";
+    }
+
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char **argv)
+{
+    OBJGenerator::Settings settings;
+    std::vector<std::string> file_stock;
+    std::string format = "csv";
+    std::string output;
+    std::string directory = ".";
+    std::size_t runs = 3U;
+    std::size_t value = 0U;
+    GLenum options = ModelLoader::ALL_OPTIONS;
+    double scale = 1.0;
+    bool single = false;
+    bool cache = false;
+    bool keep = false;
+
+    OBJLoader::setMode(OBJLoader::MAPPED);
+    OBJLoader::setThreads(0U);
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        const std::string next = has_value ? argv[i + 1] : std::string();
+        bool valid = true;
+
+        if ((arg == "-h") || (arg == "--help"))
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+
+        else if (arg == "--triangles")
+        {
+            settings.quads = false;
+        }
+
+        else if (arg == "--no-uv")
+        {
+            settings.uv_coords = false;
+        }
+
+        else if (arg == "--no-normals")
+        {
+            settings.normals = false;
+        }
+
+        else if (arg == "--cache")
+        {
+            cache = true;
+        }
+
+        else if (arg == "--keep")
+        {
+            keep = true;
+        }
+
+        else if (arg.compare(0U, 2U, "--") != 0)
+        {
+            file_stock.emplace_back(arg);
+        }
+
+        else if (!has_value)
+        {
+            valid = false;
+        }
+
+        else
+        {
+            i++;
+
+            if (arg == "--shape")
+            {
+                valid = OBJGenerator::parseShape(next, settings.shape);
+                single = true;
+            }
+
+            else if (arg == "--resolution")
+            {
+                valid = parseSize(next, settings.resolution) && (settings.resolution > 0U);
+            }
+
+            else if (arg == "--materials")
+            {
+                valid = parseSize(next, settings.materials);
+            }
+
+            else if (arg == "--switches")
+            {
+                valid = parseSize(next, settings.switches);
+            }
+
+            else if (arg == "--seed")
+            {
+                valid = parseSize(next, value);
+                settings.seed = static_cast<unsigned int>(value);
+            }
+
+            else if (arg == "--scale")
+            {
+                scale = std::atof(next.c_str());
+                valid = scale > 0.0;
+            }
+
+            else if (arg == "--runs")
+            {
+                valid = parseSize(next, runs) && (runs > 0U);
+            }
+
+            else if (arg == "--options")
+            {
+                valid = parseSize(next, value);
+                options = static_cast<GLenum>(value) & ModelLoader::ALL_OPTIONS;
+            }
+
+            else if (arg == "--lod-levels")
+            {
+                valid = parseSize(next, value);
+                ModelLoader::setLodLevels(value);
+            }
+
+            else if (arg == "--mode")
+            {
+                valid = (next == "stream") || (next == "mapped");
+                OBJLoader::setMode(next == "stream" ? OBJLoader::STREAM : OBJLoader::MAPPED);
+            }
+
+            else if (arg == "--threads")
+            {
+                valid = parseSize(next, value);
+                OBJLoader::setThreads(value);
+            }
+
+            else if (arg == "--format")
+            {
+                valid = (next == "csv") || (next == "json");
+                format = next;
+            }
+
+            else if (arg == "--output")
+            {
+                output = next;
+            }
+
+            else if (arg == "--directory")
+            {
+                directory = next;
+            }
+
+            else
+            {
+                valid = false;
+            }
+        }
+
+        if (!valid)
+        {
+            std::cerr << "error: invalid argument `" << arg << "'" << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    MeshCache::setEnabled(cache);
+
+    std::vector<OBJGenerator::Settings> case_stock;
+
+    if (single)
+    {
+        case_stock.emplace_back(settings);
+    }
+
+    // The suite covers the parser paths: every corner format, quads and triangles, unconnected faces and many materials
+    else if (file_stock.empty())
+    {
+        const struct
+        {
+            OBJGenerator::Shape shape;
+            std::size_t resolution;
+            bool quads;
+            bool uv_coords;
+            bool normals;
+            std::size_t materials;
+            std::size_t switches;
+        } suite[] = {{OBJGenerator::SPHERE, 256U, true, true, true, 1U, 1U},
+                     {OBJGenerator::SPHERE, 256U, false, true, true, 1U, 1U},
+                     {OBJGenerator::GRID, 512U, false, false, false, 0U, 0U},
+                     {OBJGenerator::GRID, 512U, true, true, false, 1U, 1U},
+                     {OBJGenerator::GRID, 512U, true, false, true, 1U, 1U},
+                     {OBJGenerator::SOUP, 256U, false, true, true, 1U, 1U},
+                     {OBJGenerator::GRID, 256U, true, true, true, 16U, 4096U}};
+
+        for (const auto &entry : suite)
+        {
+            OBJGenerator::Settings suite_settings;
+            suite_settings.shape = entry.shape;
+            suite_settings.resolution = std::max(static_cast<std::size_t>(static_cast<double>(entry.resolution) * scale), static_cast<std::size_t>(1U));
+            suite_settings.quads = entry.quads;
+            suite_settings.uv_coords = entry.uv_coords;
+            suite_settings.normals = entry.normals;
+            suite_settings.materials = entry.materials;
+            suite_settings.switches = entry.switches;
+            suite_settings.seed = settings.seed;
+            case_stock.emplace_back(suite_settings);
+        }
+    }
+
+    std::vector<Result> result_stock;
+    bool status = true;
+
+    for (const std::string &path : file_stock)
+    {
+        Result result;
+
+        if (!measure(path, path, runs, options, result))
+        {
+            status = false;
+            continue;
+        }
+
+        result_stock.emplace_back(result);
+    }
+
+    for (const OBJGenerator::Settings &entry : case_stock)
+    {
+        const std::string name = OBJGenerator::getName(entry);
+        const std::string path = directory + "/bench_" + name + ".obj";
+        Result result;
+
+        std::cerr << "generating " << path << std::endl;
+
+        if (!OBJGenerator::write(path, entry))
+        {
+            status = false;
+            continue;
+        }
+
+        status = measure(name, path, runs, options, result) && status;
+
+        if (!result.run_stock.empty())
+        {
+            result_stock.emplace_back(result);
+        }
+
+        if (!keep)
+        {
+            std::remove(path.c_str());
+            std::remove((path.substr(0U, path.size() - 4U) + ".mtl").c_str());
+            std::remove((path + MeshCache::getExtension()).c_str());
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output, std::ios::trunc);
+
+        if (!file.is_open())
+        {
+            std::cerr << "error: could not create the file `" << output << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostream &out = output.empty() ? std::cout : file;
+
+    if (format == "json")
+    {
+        writeJSON(out, result_stock, options);
+    }
+
+    else
+    {
+        writeCSV(out, result_stock);
+    }
+
+    return status ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "objgenerator.hpp"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+OBJGenerator::Settings::Settings() : shape(OBJGenerator::SPHERE),
+                                     resolution(256U),
+                                     quads(true),
+                                     uv_coords(true),
+                                     normals(true),
+                                     materials(1U),
+                                     switches(1U),
+                                     seed(1U) {}
+
+/** Linear congruential generator, the same seed writes the same file on every platform */
+float OBJGenerator::random(unsigned int &state)
+{
+    state = state * 1664525U + 1013904223U;
+    return static_cast<float>(state >> 8U) / 16777216.0F;
+}
+
+void OBJGenerator::writeVertex(std::string &buffer, const float &x, const float &y, const float &z, const float &u, const float &v, const float &nx, const float &ny, const float &nz, const OBJGenerator::Settings &settings)
+{
+    char line[128];
+
+    buffer.append(line, static_cast<std::size_t>(std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x, y, z)));
+
+    if (settings.uv_coords)
+    {
+        buffer.append(line, static_cast<std::size_t>(std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", u, v)));
+    }
+
+    if (settings.normals)
+    {
+        buffer.append(line, static_cast<std::size_t>(std::snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n", nx, ny, nz)));
+    }
+}
+
+/** Every vertex has its UV and normal at the same index, so a corner repeats the index in each slot written */
+void OBJGenerator::writeFace(std::string &buffer, const std::size_t *const corner, const std::size_t &count, const OBJGenerator::Settings &settings)
+{
+    char item[64];
+
+    buffer += 'f';
+
+    for (std::size_t i = 0U; i < count; i++)
+    {
+        const unsigned long index = static_cast<unsigned long>(corner[i] + 1U);
+        int length;
+
+        if (settings.uv_coords && settings.normals)
+        {
+            length = std::snprintf(item, sizeof(item), " %lu/%lu/%lu", index, index, index);
+        }
+
+        else if (settings.uv_coords)
+        {
+            length = std::snprintf(item, sizeof(item), " %lu/%lu", index, index);
+        }
+
+        else if (settings.normals)
+        {
+            length = std::snprintf(item, sizeof(item), " %lu//%lu", index, index);
+        }
+
+        else
+        {
+            length = std::snprintf(item, sizeof(item), " %lu", index);
+        }
+
+        buffer.append(item, static_cast<std::size_t>(length));
+    }
+
+    buffer += '\n';
+}
+
+/** Emits the usemtl statements due before `face', evenly spread over the faces and cycling through the materials */
+void OBJGenerator::writeMaterial(std::string &buffer, const std::size_t &face, const std::size_t &faces, std::size_t &next, const OBJGenerator::Settings &settings)
+{
+    const std::size_t switches = settings.switches == 0U ? 1U : settings.switches;
+
+    while ((settings.materials > 0U) && (next < switches) && (face >= next * faces / switches))
+    {
+        buffer += "usemtl material_" + std::to_string(next % settings.materials) + "\n";
+        next++;
+    }
+}
+
+void OBJGenerator::flush(std::ofstream &file, std::string &buffer, const bool &force)
+{
+    if (force || (buffer.size() >= (1U << 20U)))
+    {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+/** Writes the OBJ file and, with materials, its MTL library next to it with the same name */
+bool OBJGenerator::write(const std::string &path, const OBJGenerator::Settings &settings)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        std::cerr << "error: could not create the file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    const std::size_t n = settings.resolution == 0U ? 1U : settings.resolution;
+    const std::size_t faces = OBJGenerator::getFaces(settings);
+    const std::size_t separator = path.find_last_of("/\\");
+    const std::string stem = path.substr(0U, path.find_last_of('.'));
+    const std::string library = stem + ".mtl";
+    unsigned int state = settings.seed;
+    std::size_t next = 0U;
+    std::size_t face = 0U;
+    std::string buffer;
+
+    buffer = "# " + OBJGenerator::getName(settings) + "\n";
+
+    if (settings.materials > 0U)
+    {
+        buffer += "mtllib " + library.substr(separator == std::string::npos ? 0U : separator + 1U) + "\n";
+    }
+
+    if (settings.shape == OBJGenerator::SOUP)
+    {
+        const std::size_t corners = settings.quads ? 4U : 3U;
+        std::size_t corner[4];
+
+        // Unconnected faces with their own vertices, written right before each face
+        for (; face < faces; face++)
+        {
+            const float nx = 2.0F * OBJGenerator::random(state) - 1.0F;
+            const float ny = 2.0F * OBJGenerator::random(state) - 1.0F;
+            const float nz = 2.0F * OBJGenerator::random(state) - 1.0F;
+            const float length = std::sqrt(nx * nx + ny * ny + nz * nz) + 1e-6F;
+
+            for (std::size_t i = 0U; i < corners; i++)
+            {
+                const float x = 2.0F * OBJGenerator::random(state) - 1.0F;
+                const float y = 2.0F * OBJGenerator::random(state) - 1.0F;
+                const float z = 2.0F * OBJGenerator::random(state) - 1.0F;
+                const float u = OBJGenerator::random(state);
+                const float v = OBJGenerator::random(state);
+
+                OBJGenerator::writeVertex(buffer, x, y, z, u, v, nx / length, ny / length, nz / length, settings);
+                corner[i] = corners * face + i;
+            }
+
+            OBJGenerator::writeMaterial(buffer, face, faces, next, settings);
+            OBJGenerator::writeFace(buffer, corner, corners, settings);
+            OBJGenerator::flush(file, buffer);
+        }
+    }
+
+    else
+    {
+        const float pi = 3.14159265358979F;
+        const std::size_t rows = n;
+        const std::size_t columns = settings.shape == OBJGenerator::SPHERE ? 2U * n : n;
+
+        for (std::size_t i = 0U; i <= rows; i++)
+        {
+            for (std::size_t j = 0U; j <= columns; j++)
+            {
+                const float u = static_cast<float>(j) / static_cast<float>(columns);
+                const float v = static_cast<float>(i) / static_cast<float>(rows);
+
+                if (settings.shape == OBJGenerator::SPHERE)
+                {
+                    // From the south pole up, the seam column is repeated with its own UV
+                    const float theta = pi * v;
+                    const float phi = 2.0F * pi * u;
+                    const float x = std::sin(theta) * std::cos(phi);
+                    const float y = -std::cos(theta);
+                    const float z = -std::sin(theta) * std::sin(phi);
+
+                    OBJGenerator::writeVertex(buffer, x, y, z, u, v, x, y, z, settings);
+                }
+
+                else
+                {
+                    // Rolling height field over the unit square
+                    const float x = 2.0F * u - 1.0F;
+                    const float y = 2.0F * v - 1.0F;
+                    const float z = 0.05F * std::sin(3.0F * pi * x) * std::cos(3.0F * pi * y);
+                    const float dx = 0.15F * pi * std::cos(3.0F * pi * x) * std::cos(3.0F * pi * y);
+                    const float dy = -0.15F * pi * std::sin(3.0F * pi * x) * std::sin(3.0F * pi * y);
+                    const float length = std::sqrt(dx * dx + dy * dy + 1.0F);
+
+                    OBJGenerator::writeVertex(buffer, x, y, z, u, v, -dx / length, -dy / length, 1.0F / length, settings);
+                }
+            }
+
+            OBJGenerator::flush(file, buffer);
+        }
+
+        for (std::size_t i = 0U; i < rows; i++)
+        {
+            for (std::size_t j = 0U; j < columns; j++)
+            {
+                // Counter clockwise seen from outside
+                const std::size_t quad[4] = {i * (columns + 1U) + j, i * (columns + 1U) + j + 1U, (i + 1U) * (columns + 1U) + j + 1U, (i + 1U) * (columns + 1U) + j};
+
+                if (settings.quads)
+                {
+                    OBJGenerator::writeMaterial(buffer, face++, faces, next, settings);
+                    OBJGenerator::writeFace(buffer, quad, 4U, settings);
+                }
+
+                else
+                {
+                    const std::size_t second[3] = {quad[0], quad[2], quad[3]};
+
+                    OBJGenerator::writeMaterial(buffer, face++, faces, next, settings);
+                    OBJGenerator::writeFace(buffer, quad, 3U, settings);
+                    OBJGenerator::writeMaterial(buffer, face++, faces, next, settings);
+                    OBJGenerator::writeFace(buffer, second, 3U, settings);
+                }
+            }
+
+            OBJGenerator::flush(file, buffer);
+        }
+    }
+
+    OBJGenerator::flush(file, buffer, true);
+
+    if (!file.good())
+    {
+        std::cerr << "error: could not write the file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    if (settings.materials == 0U)
+    {
+        return true;
+    }
+
+    std::ofstream mtl(library, std::ios::binary | std::ios::trunc);
+
+    if (!mtl.is_open())
+    {
+        std::cerr << "error: could not create the file `" << library << "'" << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0U; i < settings.materials; i++)
+    {
+        char color[64];
+        std::snprintf(color, sizeof(color), "Kd %.3f %.3f %.3f\n", OBJGenerator::random(state), OBJGenerator::random(state), OBJGenerator::random(state));
+
+        mtl << "newmtl material_" << i << "\nNs 96.0\nKa 0.000 0.000 0.000\n" << color << "Ks 0.500 0.500 0.500\nd 1.0\nillum 2\n\n";
+    }
+
+    return mtl.good();
+}
+
+std::string OBJGenerator::getName(const OBJGenerator::Settings &settings)
+{
+    const char *const shape[] = {"grid", "sphere", "soup"};
+
+    return std::string(shape[settings.shape]) + "_" + std::to_string(settings.resolution) + (settings.quads ? "_quads" : "_triangles") +
+           (settings.uv_coords ? "_vt" : "") + (settings.normals ? "_vn" : "") + "_m" + std::to_string(settings.materials) + "_s" + std::to_string(settings.switches);
+}
+
+/** Face statements in the file, a grid and a soup take `resolution' squared quads and a sphere twice that */
+std::size_t OBJGenerator::getFaces(const OBJGenerator::Settings &settings)
+{
+    const std::size_t n = settings.resolution == 0U ? 1U : settings.resolution;
+    const std::size_t quads = settings.shape == OBJGenerator::SPHERE ? 2U * n * n : n * n;
+
+    return settings.quads ? quads : 2U * quads;
+}
+
+bool OBJGenerator::parseShape(const std::string &name, OBJGenerator::Shape &shape)
+{
+    if (name == "grid")
+    {
+        shape = OBJGenerator::GRID;
+    }
+
+    else if (name == "sphere")
+    {
+        shape = OBJGenerator::SPHERE;
+    }
+
+    else if (name == "soup")
+    {
+        shape = OBJGenerator::SOUP;
+    }
+
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef __OBJ_GENERATOR_HPP_
+#define __OBJ_GENERATOR_HPP_
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+/** Writes synthetic OBJ and MTL files of a known size and layout for the loader benchmarks */
+class OBJGenerator
+{
+public:
+    /** Surface written to the file */
+    enum Shape
+    {
+        GRID,
+        SPHERE,
+        SOUP
+    };
+
+    /** Content of a generated file */
+    struct Settings
+    {
+    public:
+        OBJGenerator::Shape shape;
+        std::size_t resolution;
+        bool quads;
+        bool uv_coords;
+        bool normals;
+        std::size_t materials;
+        std::size_t switches;
+        unsigned int seed;
+        Settings();
+    };
+
+private:
+    OBJGenerator() = delete;
+    OBJGenerator(const OBJGenerator &) = delete;
+    OBJGenerator &operator=(const OBJGenerator &) = delete;
+    static float random(unsigned int &state);
+    static void writeVertex(std::string &buffer, const float &x, const float &y, const float &z, const float &u, const float &v, const float &nx, const float &ny, const float &nz, const OBJGenerator::Settings &settings);
+    static void writeFace(std::string &buffer, const std::size_t *const corner, const std::size_t &count, const OBJGenerator::Settings &settings);
+    static void writeMaterial(std::string &buffer, const std::size_t &face, const std::size_t &faces, std::size_t &next, const OBJGenerator::Settings &settings);
+    static void flush(std::ofstream &file, std::string &buffer, const bool &force = false);
+
+public:
+    static bool write(const std::string &path, const OBJGenerator::Settings &settings);
+    static std::string getName(const OBJGenerator::Settings &settings);
+    static std::size_t getFaces(const OBJGenerator::Settings &settings);
+    static bool parseShape(const std::string &name, OBJGenerator::Shape &shape);
+};
+
+#endif
\ No newline at end of file
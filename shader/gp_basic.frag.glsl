@@ -1,29 +1,45 @@
 #version 330 core
 
+// Shininess encoding macro
+#define MAX_SHININESS 1000.0F
+
 // Location variables
-layout (location = 0) out vec3 l_position;
-layout (location = 1) out vec3 l_normal;
-layout (location = 2) out vec3 l_ambient;
-layout (location = 3) out vec4 l_diffuse;
-layout (location = 4) out vec3 l_specular;
-layout (location = 5) out vec4 l_metadata;
+layout (location = 0) out vec2 l_normal;
+layout (location = 1) out vec4 l_diffuse;
+layout (location = 2) out vec4 l_ambient;
+layout (location = 3) out vec4 l_specular;
+
+
+// Uniform block of the material, shared by the whole object
+layout (std140) uniform MaterialData {
+    vec3 u_ambient;
+    float u_shininess;
+    vec3 u_diffuse;
+    float u_roughness;
+    vec3 u_specular;
+    float u_metalness;
+    vec3 u_transmision;
+    float u_alpha;
+    float u_displacement;
+    float u_refractive_index;
+};
 
 
 // Uniform variables
-uniform vec3 u_ambient;
-uniform vec3 u_diffuse;
-uniform vec3 u_specular;
-
-uniform float u_shininess;
-uniform float u_roughness;
-uniform float u_metalness;
-uniform float u_alpha;
-
 uniform sampler2D u_ambient_tex;
 uniform sampler2D u_diffuse_tex;
 uniform sampler2D u_specular_tex;
 uniform sampler2D u_shininess_tex;
 
+uniform bool u_texture_array;
+uniform int u_material_index;
+uniform samplerBuffer u_material_buffer;
+
+uniform sampler2DArray u_ambient_array;
+uniform sampler2DArray u_diffuse_array;
+uniform sampler2DArray u_specular_array;
+uniform sampler2DArray u_shininess_array;
+
 
 // In variables
 in Vertex {
@@ -33,37 +49,58 @@ in Vertex {
 } vertex;
 
 
-// Main function
-void main () {
-    // Fragment position
-    l_position = vertex.position;
+// Octahedral normal, mapped to the unsigned two channel target
+vec2 encodeNormal(vec3 normal) {
+    normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+    vec2 octahedral = normal.z >= 0.0F ? normal.xy : (1.0F - abs(normal.yx)) * vec2(normal.x >= 0.0F ? 1.0F : -1.0F, normal.y >= 0.0F ? 1.0F : -1.0F);
+    return octahedral * 0.5F + 0.5F;
+}
 
-    // Normal
-    l_normal = normalize(vertex.normal);
+// Logarithmic shininess, so the low exponents keep their precision in eight bits
+float encodeShininess(float shininess) {
+    return log2(clamp(shininess, 0.0F, MAX_SHININESS) + 1.0F) / log2(MAX_SHININESS + 1.0F);
+}
 
-    // Ambient color
-    l_ambient = texture(u_ambient_tex, vertex.uv_coord).rgb * u_ambient;
+// Row of the material of a packed model, six texels per material
+vec4 materialRow(int row) {
+    return texelFetch(u_material_buffer, u_material_index * 6 + row);
+}
 
-    // Diffuse color and alpha
-    l_diffuse = texture(u_diffuse_tex, vertex.uv_coord);
-    l_diffuse.rgb *= u_diffuse;
-    l_diffuse.a   *= u_alpha;
+// Samples a texture, from its array layer when the model is packed. A material without one gets the fallback
+vec4 sampleTexture(sampler2D tex, sampler2DArray array, int slot, vec2 uv, vec4 fallback) {
+    if (!u_texture_array) {
+        return texture(tex, uv);
+    }
 
-    // Specular color
-    l_specular = texture(u_specular_tex, vertex.uv_coord).rgb * u_specular;
+    float layer = materialRow(4 + slot / 4)[slot % 4];
+    return layer < 0.0F ? fallback : texture(array, vec3(uv, layer));
+}
 
 
-    // Metadata
+// Main function
+void main () {
+    // Material values, from the material rows when the model is packed
+    vec3 ambient    = u_texture_array ? materialRow(0).rgb : u_ambient;
+    vec3 diffuse    = u_texture_array ? materialRow(1).rgb : u_diffuse;
+    vec3 specular   = u_texture_array ? materialRow(2).rgb : u_specular;
+    float alpha     = u_texture_array ? materialRow(0).a : u_alpha;
+    float shininess = u_texture_array ? materialRow(1).a : u_shininess;
+    float roughness = u_texture_array ? materialRow(2).a : u_roughness;
+    float metalness = u_texture_array ? materialRow(3).x : u_metalness;
 
-    // Shininess
-    l_metadata.x = texture(u_shininess_tex, vertex.uv_coord).r * u_shininess;
+    // Normal
+    l_normal = encodeNormal(normalize(vertex.normal));
 
-    // Roughness
-    l_metadata.y = u_roughness;
+    // Diffuse color, the alpha is only zero for transparent fragments and keeps the metalness otherwise
+    vec4 diffuse_alpha = sampleTexture(u_diffuse_tex, u_diffuse_array, 1, vertex.uv_coord, vec4(1.0F));
+    l_diffuse.rgb = diffuse_alpha.rgb * diffuse;
+    l_diffuse.a   = diffuse_alpha.a * alpha < 0.5F / 255.0F ? 0.0F : mix(1.0F / 255.0F, 1.0F, clamp(metalness, 0.0F, 1.0F));
 
-    // Metalness
-    l_metadata.z = u_metalness;
+    // Ambient color and shininess
+    l_ambient.rgb = sampleTexture(u_ambient_tex, u_ambient_array, 0, vertex.uv_coord, vec4(1.0F)).rgb * ambient;
+    l_ambient.a   = encodeShininess(sampleTexture(u_shininess_tex, u_shininess_array, 3, vertex.uv_coord, vec4(1.0F)).r * shininess);
 
-    // Refractive index
-    l_metadata.w = 0.0F;
+    // Specular color and roughness
+    l_specular.rgb = sampleTexture(u_specular_tex, u_specular_array, 2, vertex.uv_coord, vec4(1.0F)).rgb * specular;
+    l_specular.a   = roughness;
 }
\ No newline at end of file
@@ -6,12 +6,28 @@ layout (location = 1) in vec2 l_uv_coord;
 layout (location = 2) in vec3 l_normal;
 
 
-// Uniform variables
-uniform mat4 u_view_mat;
-uniform mat4 u_projection_mat;
-
-uniform mat4 u_model_mat;
-uniform mat3 u_normal_mat;
+// Uniform blocks, camera of the frame and transform of the model
+layout (std140) uniform FrameData {
+    mat4 u_view_mat;
+    mat4 u_projection_mat;
+    vec3 u_view_pos;
+};
+
+layout (std140) uniform ObjectData {
+    mat4 u_model_mat;
+    mat3 u_normal_mat;
+    bool u_packed_vertex;
+};
+
+
+// Octahedral decoding of the packed normal and tangent
+vec3 octDecode(vec2 e) {
+    vec3 v = vec3(e, 1.0F - abs(e.x) - abs(e.y));
+    if (v.z < 0.0F) {
+        v.xy = (1.0F - abs(v.yx)) * vec2(v.x >= 0.0F ? 1.0F : -1.0F, v.y >= 0.0F ? 1.0F : -1.0F);
+    }
+    return normalize(v);
+}
 
 
 // Out variables
@@ -30,7 +46,7 @@ void main() {
     // Set out variables
     vertex.position = pos.xyz;
     vertex.uv_coord = l_uv_coord;
-    vertex.normal = u_normal_mat * l_normal;
+    vertex.normal = u_normal_mat * (u_packed_vertex ? octDecode(l_normal.xy) : l_normal);
 
     // Set vertex position
     gl_Position = u_projection_mat * u_view_mat * pos;
@@ -7,14 +7,28 @@ layout (location = 2) in vec3 l_normal;
 layout (location = 3) in vec3 l_tangent;
 
 
-// Uniform variables
-uniform vec3 u_view_pos;
-
-uniform mat4 u_view_mat;
-uniform mat4 u_projection_mat;
-
-uniform mat4 u_model_mat;
-uniform mat3 u_normal_mat;
+// Uniform blocks, camera of the frame and transform of the model
+layout (std140) uniform FrameData {
+    mat4 u_view_mat;
+    mat4 u_projection_mat;
+    vec3 u_view_pos;
+};
+
+layout (std140) uniform ObjectData {
+    mat4 u_model_mat;
+    mat3 u_normal_mat;
+    bool u_packed_vertex;
+};
+
+
+// Octahedral decoding of the packed normal and tangent
+vec3 octDecode(vec2 e) {
+    vec3 v = vec3(e, 1.0F - abs(e.x) - abs(e.y));
+    if (v.z < 0.0F) {
+        v.xy = (1.0F - abs(v.yx)) * vec2(v.x >= 0.0F ? 1.0F : -1.0F, v.y >= 0.0F ? 1.0F : -1.0F);
+    }
+    return normalize(v);
+}
 
 
 // Out variables
@@ -35,8 +49,8 @@ void main() {
     vec4 pos = u_model_mat * vec4(l_position, 1.0F);
 
     // Build the TBN matrix
-    vec3 t = u_normal_mat * l_tangent;
-    vec3 n = u_normal_mat * l_normal;
+    vec3 t = u_normal_mat * (u_packed_vertex ? octDecode(l_tangent.xy) : l_tangent);
+    vec3 n = u_normal_mat * (u_packed_vertex ? octDecode(l_normal.xy) : l_normal);
     vec3 b = normalize(cross(n, t));
     tbn = mat3(t, b, n);
 
@@ -5,71 +5,126 @@
 #define POINT       1
 #define SPOTLIGHT   2
 
+// Shininess encoding macro
+#define MAX_SHININESS 1000.0F
+
 
 // Out color
 out vec4 color;
 
 
-// Uniform variables
-uniform int u_light_type;
-
-uniform vec3 u_light_direction;
-uniform vec3 u_light_position;
-uniform vec3 u_light_attenuation;
-uniform vec2 u_light_cutoff;
+// Uniform block of the light drawn by the pass, not read by the buffered lights
+layout (std140) uniform LightData {
+    mat4 u_volume_mat;
+    vec3 u_light_direction;
+    int u_light_type;
+    vec3 u_light_position;
+    float u_shininess;
+    vec3 u_light_attenuation;
+    vec2 u_light_cutoff;
+    vec3 u_ambient;
+    vec3 u_diffuse;
+    vec3 u_specular;
+};
 
-uniform vec3 u_ambient;
-uniform vec3 u_diffuse;
-uniform vec3 u_specular;
-uniform float u_shininess;
 
+// Uniform variables
 uniform vec3 u_view_pos;
 
 uniform vec3 u_background_color;
 
-uniform sampler2D u_position_tex;
+uniform mat4 u_inverse_view_projection_mat;
+
 uniform sampler2D u_normal_tex;
-uniform sampler2D u_ambient_tex;
 uniform sampler2D u_diffuse_tex;
+uniform sampler2D u_ambient_tex;
 uniform sampler2D u_specular_tex;
-uniform sampler2D u_metadata_tex;
+uniform sampler2D u_depth_tex;
 
+uniform bool u_buffered_lights;
+uniform mat4 u_view_mat;
+uniform ivec3 u_cluster_size;
+uniform vec2 u_cluster_depth;
+uniform int u_global_lights;
 
-// In variables
-in vec2 uv_coord;
+uniform samplerBuffer u_light_buffer;
+uniform usamplerBuffer u_cluster_buffer;
+uniform usamplerBuffer u_light_index_buffer;
 
 
-// Main function
-void main() {
-    // Get the normal and fissue data from the buffer textures
-    vec3 normal        = texture(u_normal_tex, uv_coord).rgb;
-    vec4 diffuse_alpha = texture(u_diffuse_tex, uv_coord);
-
-    // Discard black normals and transparent fragments
-    if ((diffuse_alpha.a == 0.0F) || (normal == vec3(0.0F))) {
-        color = vec4(u_background_color, 1.0F);
-        return;
-    }
+// Light data
+struct Light {
+    int type;
+    vec3 direction;
+    vec3 position;
+    vec3 attenuation;
+    vec2 cutoff;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+};
 
-    // Get the position, ambient, specular and other metadata from the buffer textures
-    vec3 position = texture(u_position_tex, uv_coord).rgb;
-    vec3 ambient  = texture(u_ambient_tex, uv_coord).rgb;
-    vec3 specular = texture(u_specular_tex, uv_coord).rgb;
-    vec4 metadata = texture(u_metadata_tex, uv_coord);
 
-    // Decompose diffuse and shininess data
-    vec3 diffuse    = diffuse_alpha.rgb;
-    float shininess = metadata.x * u_shininess;
+// In variables
+in vec2 uv_coord;
 
 
+// World position rebuilt from the depth buffer
+vec3 decodePosition(vec2 uv, float depth) {
+    vec4 position = u_inverse_view_projection_mat * vec4(vec3(uv, depth) * 2.0F - 1.0F, 1.0F);
+    return position.xyz / position.w;
+}
+
+// Unit normal from its octahedral encoding
+vec3 decodeNormal(vec2 octahedral) {
+    octahedral = octahedral * 2.0F - 1.0F;
+    vec3 normal = vec3(octahedral, 1.0F - abs(octahedral.x) - abs(octahedral.y));
+    float fold = max(-normal.z, 0.0F);
+    normal.xy += vec2(normal.x >= 0.0F ? -fold : fold, normal.y >= 0.0F ? -fold : fold);
+    return normalize(normal);
+}
+
+// Shininess exponent from its logarithmic encoding
+float decodeShininess(float shininess) {
+    return exp2(shininess * log2(MAX_SHININESS + 1.0F)) - 1.0F;
+}
+
+
+// Light of the pass, from the light uniforms
+Light uniformLight() {
+    return Light(u_light_type, u_light_direction, u_light_position, u_light_attenuation, u_light_cutoff, u_ambient, u_diffuse, u_specular, u_shininess);
+}
+
+// Light of the clustered pass, from its six rows in the light buffer
+Light bufferLight(int index) {
+    vec4 position_type      = texelFetch(u_light_buffer, index * 6);
+    vec4 direction_cutoff   = texelFetch(u_light_buffer, index * 6 + 1);
+    vec4 attenuation_cutoff = texelFetch(u_light_buffer, index * 6 + 2);
+    vec4 ambient_shininess  = texelFetch(u_light_buffer, index * 6 + 3);
+    vec3 diffuse            = texelFetch(u_light_buffer, index * 6 + 4).rgb;
+    vec3 specular           = texelFetch(u_light_buffer, index * 6 + 5).rgb;
+    return Light(int(position_type.w), direction_cutoff.xyz, position_type.xyz, attenuation_cutoff.xyz, vec2(direction_cutoff.w, attenuation_cutoff.w), ambient_shininess.rgb, diffuse, specular, ambient_shininess.w);
+}
+
+// Cluster of a position, from its screen tile and exponential depth slice
+int clusterIndex(vec3 position) {
+    float depth = -(u_view_mat * vec4(position, 1.0F)).z;
+    ivec3 cluster = ivec3(floor(vec3(uv_coord * vec2(u_cluster_size.xy), log(max(depth, 1e-6F)) * u_cluster_depth.x + u_cluster_depth.y)));
+    cluster = clamp(cluster, ivec3(0), u_cluster_size - 1);
+    return (cluster.z * u_cluster_size.y + cluster.y) * u_cluster_size.x + cluster.x;
+}
+
+// Light reaching a fragment
+vec3 shade(Light light, vec3 position, vec3 normal, vec3 ambient, vec3 diffuse, vec3 specular, float shininess) {
     // Light direction, attenuation and intensity
     vec3 light_dir;
     float attenuation;
     float intensity;
 
     // Directional light
-    if (u_light_type == DIRECTIONAL) {
-        light_dir = u_light_direction;
+    if (light.type == DIRECTIONAL) {
+        light_dir = light.direction;
         attenuation = 1.0F;
         intensity = 1.0F;
     }
@@ -77,18 +132,18 @@ void main() {
     // Non directional light
     else {
         // Attenuation
-        light_dir = u_light_position - position;
+        light_dir = light.position - position;
         float dist = length(light_dir);
-        attenuation = 1.0F / (u_light_attenuation.x + u_light_attenuation.y * dist + u_light_attenuation.z * dist * dist);
+        attenuation = 1.0F / (light.attenuation.x + light.attenuation.y * dist + light.attenuation.z * dist * dist);
 
         // Normalize the light direction
         light_dir = normalize(light_dir);
 
         // Spotlight intensity
-        if (u_light_type == SPOTLIGHT) {
-            float theta = dot(light_dir, u_light_direction);
-            float epsilon = u_light_cutoff.x - u_light_cutoff.y;
-            intensity = clamp((theta - u_light_cutoff.y) / epsilon, 0.0F, 1.0F);
+        if (light.type == SPOTLIGHT) {
+            float theta = dot(light_dir, light.direction);
+            float epsilon = light.cutoff.x - light.cutoff.y;
+            intensity = clamp((theta - light.cutoff.y) / epsilon, 0.0F, 1.0F);
         }
 
         // Non spotlight light default intensity
@@ -105,18 +160,64 @@ void main() {
     // Specular Blinn-Phong
     vec3 halfway = normalize(light_dir + view_dir);
     float nh = max(dot(normal, halfway), 0.0F);
-    float blinn_phong = pow(nh, shininess);
+    float blinn_phong = pow(nh, shininess * light.shininess);
 
 
     // Calcule color components
-    ambient  *= u_ambient;
-    diffuse  *= u_diffuse  * nl;
-    specular *= u_specular * blinn_phong;
+    ambient  *= light.ambient;
+    diffuse  *= light.diffuse  * nl;
+    specular *= light.specular * blinn_phong;
 
 
     // Final light
     vec3 lighting = attenuation * (ambient + intensity * (diffuse + specular));
 
+    return lighting;
+}
+
+
+// Main function
+void main() {
+    // Get the depth and diffuse data from the buffer textures
+    float depth        = texture(u_depth_tex, uv_coord).r;
+    vec4 diffuse_alpha = texture(u_diffuse_tex, uv_coord);
+
+    // Discard the background and transparent fragments
+    if ((diffuse_alpha.a == 0.0F) || (depth == 1.0F)) {
+        color = vec4(u_background_color, 1.0F);
+        return;
+    }
+
+    // Get the position, normal, ambient, specular and packed metadata from the buffer textures
+    vec3 position           = decodePosition(uv_coord, depth);
+    vec3 normal             = decodeNormal(texture(u_normal_tex, uv_coord).rg);
+    vec4 ambient_shininess  = texture(u_ambient_tex, uv_coord);
+    vec4 specular_roughness = texture(u_specular_tex, uv_coord);
+    vec3 ambient            = ambient_shininess.rgb;
+    vec3 specular           = specular_roughness.rgb;
+
+    // Decompose diffuse and shininess data
+    vec3 diffuse    = diffuse_alpha.rgb;
+    float shininess = decodeShininess(ambient_shininess.a);
+
+
+    // Single light of the pass
+    if (!u_buffered_lights) {
+        color = vec4(shade(uniformLight(), position, normal, ambient, diffuse, specular, shininess), 1.0F);
+        return;
+    }
+
+    // Lights reaching every cluster, then the ones binned into the cluster of the fragment
+    vec3 lighting = vec3(0.0F);
+    for (int i = 0; i < u_global_lights; i++) {
+        lighting += shade(bufferLight(i), position, normal, ambient, diffuse, specular, shininess);
+    }
+
+    uvec2 cell = texelFetch(u_cluster_buffer, clusterIndex(position)).rg;
+    for (uint i = 0U; i < cell.y; i++) {
+        lighting += shade(bufferLight(int(texelFetch(u_light_index_buffer, int(cell.x + i)).r)), position, normal, ambient, diffuse, specular, shininess);
+    }
+
     // Set the color
     color = vec4(lighting, 1.0F);
 }
\ No newline at end of file
@@ -8,23 +8,35 @@ out vec4 color;
 uniform vec3 u_background_color;
 
 uniform sampler2D u_normal_tex;
+uniform sampler2D u_depth_tex;
 
 
 // In variables
 in vec2 uv_coord;
 
 
+// Unit normal from its octahedral encoding
+vec3 decodeNormal(vec2 octahedral) {
+    octahedral = octahedral * 2.0F - 1.0F;
+    vec3 normal = vec3(octahedral, 1.0F - abs(octahedral.x) - abs(octahedral.y));
+    float fold = max(-normal.z, 0.0F);
+    normal.xy += vec2(normal.x >= 0.0F ? -fold : fold, normal.y >= 0.0F ? -fold : fold);
+    return normalize(normal);
+}
+
+
 // Main function
 void main() {
     // Get the data from the buffer textures
-    vec3 normal = texture(u_normal_tex, uv_coord).rgb;
+    float depth = texture(u_depth_tex, uv_coord).r;
 
-    // Discard if the normal is black
-    if (normal == vec3(0.0F)) {
+    // Discard the background
+    if (depth == 1.0F) {
         color = vec4(u_background_color, 1.0F);
         return;
     }
 
     // Set the normal as color
+    vec3 normal = decodeNormal(texture(u_normal_tex, uv_coord).rg);
     color = vec4(normal, 1.0F);
 }
\ No newline at end of file
@@ -7,26 +7,34 @@ out vec4 color;
 // Uniform variables
 uniform vec3 u_background_color;
 
-uniform sampler2D u_position_tex;
-uniform sampler2D u_normal_tex;
+uniform mat4 u_inverse_view_projection_mat;
+
+uniform sampler2D u_depth_tex;
 
 
 // In variables
 in vec2 uv_coord;
 
 
+// World position rebuilt from the depth buffer
+vec3 decodePosition(vec2 uv, float depth) {
+    vec4 position = u_inverse_view_projection_mat * vec4(vec3(uv, depth) * 2.0F - 1.0F, 1.0F);
+    return position.xyz / position.w;
+}
+
+
 // Main function
 void main() {
     // Get the data from the buffer textures
-    vec3 normal = texture(u_normal_tex, uv_coord).rgb;
+    float depth = texture(u_depth_tex, uv_coord).r;
 
-    // Discard if the normal is black
-    if (normal == vec3(0.0F)) {
+    // Discard the background
+    if (depth == 1.0F) {
         color = vec4(u_background_color, 1.0F);
         return;
     }
 
     // Set the position as color
-    vec3 position = texture(u_position_tex, uv_coord).rgb;
+    vec3 position = decodePosition(uv_coord, depth);
     color = vec4(position, 1.0F);
 }
\ No newline at end of file
@@ -0,0 +1,5 @@
+#version 330 core
+
+// Main function, the light volume only writes the stencil
+void main() {
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#version 330 core
+
+// Location variables
+layout (location = 0) in vec3 l_position;
+
+
+// Uniform blocks, camera of the frame and the light with the transform of its volume
+layout (std140) uniform FrameData {
+    mat4 u_view_mat;
+    mat4 u_projection_mat;
+    vec3 u_view_pos;
+};
+
+layout (std140) uniform LightData {
+    mat4 u_volume_mat;
+    vec3 u_light_direction;
+    int u_light_type;
+    vec3 u_light_position;
+    float u_shininess;
+    vec3 u_light_attenuation;
+    vec2 u_light_cutoff;
+    vec3 u_ambient;
+    vec3 u_diffuse;
+    vec3 u_specular;
+};
+
+
+// Main function
+void main() {
+    // Set vertex position
+    gl_Position = u_projection_mat * u_view_mat * u_volume_mat * vec4(l_position, 1.0F);
+}
\ No newline at end of file
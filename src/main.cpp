@@ -30,6 +30,7 @@ int main(int argc, char **argv)
     const std::string commonLpPath = shaderPath + "lp_common.vert.glsl";
     scene->setDefaultGeometryPassProgram("[GP] Basic shading", shaderPath + "gp_basic.vert.glsl", shaderPath + "gp_basic.frag.glsl");
     scene->setDefaultLightingPassProgram("[LP] Normals", commonLpPath, shaderPath + "lp_normals.frag.glsl");
+    scene->setLightVolumeProgram(shaderPath + "lv_volume.vert.glsl", shaderPath + "lv_volume.frag.glsl");
 
     const std::string gpNormalVertPath = shaderPath + "gp_normal.vert.glsl";
     std::size_t normal = scene->addProgram("[GP] Normal mapping", gpNormalVertPath, shaderPath + "gp_normal.frag.glsl");
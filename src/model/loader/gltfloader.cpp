@@ -0,0 +1,706 @@
+#include "gltfloader.hpp"
+#include "../../dirsep.h"
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+const std::uint32_t GLTFLoader::GLB_MAGIC = 0x46546C67U;
+const std::uint32_t GLTFLoader::JSON_CHUNK = 0x4E4F534AU;
+const std::uint32_t GLTFLoader::BIN_CHUNK = 0x004E4942U;
+const std::size_t GLTFLoader::MAX_DEPTH = 64U;
+const std::size_t GLTFLoader::NONE = std::numeric_limits<std::size_t>::max();
+
+GLTFLoader::GLTFLoader(const std::string &path) : ModelLoader(path),
+                                                  binary{nullptr, 0U},
+                                                  default_material(nullptr) {}
+
+bool GLTFLoader::decodeBase64(const char *cursor, const char *const end, std::vector<GLubyte> &data)
+{
+    std::uint32_t bits = 0U;
+    std::size_t count = 0U;
+
+    data.clear();
+    data.reserve(static_cast<std::size_t>(end - cursor) / 4U * 3U);
+
+    for (; (cursor < end) && (*cursor != '='); cursor++)
+    {
+        const char *const alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const char *const digit = *cursor == '\0' ? nullptr : std::strchr(alphabet, *cursor);
+
+        if (digit == nullptr)
+        {
+            return false;
+        }
+
+        bits = (bits << 6U) | static_cast<std::uint32_t>(digit - alphabet);
+        count += 6U;
+
+        if (count >= 8U)
+        {
+            count -= 8U;
+            data.emplace_back(static_cast<GLubyte>(bits >> count));
+        }
+    }
+
+    return true;
+}
+
+/** Undoes the percent escapes of a relative URI, so it can be opened as a path */
+std::string GLTFLoader::decodeURI(const std::string &uri)
+{
+    std::string path;
+
+    for (std::size_t i = 0U; i < uri.size(); i++)
+    {
+        if ((uri[i] == '%') && (i + 2U < uri.size()) && std::isxdigit(static_cast<unsigned char>(uri[i + 1U])) && std::isxdigit(static_cast<unsigned char>(uri[i + 2U])))
+        {
+            path += static_cast<char>(std::stoi(uri.substr(i + 1U, 2U), nullptr, 16));
+            i += 2U;
+        }
+
+        else
+        {
+            path += uri[i] == '/' ? DIR_SEP : uri[i];
+        }
+    }
+
+    return path;
+}
+
+/** Maps the file and parses its JSON, a GLB file also gives the range of its binary chunk */
+bool GLTFLoader::readDocument(const std::string &path)
+{
+    file.reset(new MappedFile(path));
+    relative = path.substr(0U, path.find_last_of(DIR_SEP) + 1U);
+    binary = GLTFLoader::Buffer{nullptr, 0U};
+
+    if (!file->isOpen())
+    {
+        std::cerr << "error: could not open the file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    const char *json = file->getData();
+    const char *json_end = file->getEnd();
+    std::uint32_t header[3] = {0U, 0U, 0U};
+
+    if (file->getSize() >= sizeof(header))
+    {
+        for (std::size_t i = 0U; i < 3U; i++)
+        {
+            ModelLoader::readBinary(json + i * sizeof(std::uint32_t), &header[i], sizeof(std::uint32_t), !ModelLoader::isLittleEndian());
+        }
+    }
+
+    // Binary container: a header, then a JSON chunk and an optional binary one, both 4 byte aligned
+    if (header[0] == GLTFLoader::GLB_MAGIC)
+    {
+        const char *cursor = file->getData() + sizeof(header);
+        const char *const end = file->getData() + std::min<std::size_t>(header[2], file->getSize());
+        std::uint32_t chunk[2] = {0U, 0U};
+
+        for (std::size_t i = 0U; (i < 2U) && (end - cursor >= 8); i++)
+        {
+            ModelLoader::readBinary(cursor, &chunk[0], sizeof(std::uint32_t), !ModelLoader::isLittleEndian());
+            ModelLoader::readBinary(cursor + sizeof(std::uint32_t), &chunk[1], sizeof(std::uint32_t), !ModelLoader::isLittleEndian());
+            cursor += 8;
+
+            if (static_cast<std::size_t>(end - cursor) < chunk[0])
+            {
+                break;
+            }
+
+            if ((i == 0U) && (chunk[1] == GLTFLoader::JSON_CHUNK))
+            {
+                json = cursor;
+                json_end = cursor + chunk[0];
+            }
+
+            else if ((i == 1U) && (chunk[1] == GLTFLoader::BIN_CHUNK))
+            {
+                binary = GLTFLoader::Buffer{cursor, chunk[0]};
+            }
+
+            cursor += chunk[0];
+        }
+
+        if ((header[1] != 2U) || (json == file->getData()))
+        {
+            std::cerr << "error: `" << path << "' is not a glTF 2.0 binary file" << std::endl;
+            return false;
+        }
+    }
+
+    if (!JSONValue::parse(json, json_end, document))
+    {
+        std::cerr << "error: invalid JSON in `" << path << "'" << std::endl;
+        return false;
+    }
+
+    if (document.getMember("asset").getMember("version").getString().compare(0U, 2U, "2.") != 0)
+    {
+        std::cerr << "error: `" << path << "' is not a glTF 2.0 file" << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0U; i < document.getMember("extensionsRequired").getSize(); i++)
+    {
+        std::cerr << "warning: the glTF extension `" << document.getMember("extensionsRequired").getElement(i).getString() << "' required by `" << path << "' is not supported" << std::endl;
+    }
+
+    return true;
+}
+
+/** Resolves every buffer to a byte range: the GLB binary chunk, a data URI or an external file mapped as well */
+bool GLTFLoader::readBuffers()
+{
+    const JSONValue &buffers = document.getMember("buffers");
+
+    buffer_stock.clear();
+
+    for (std::size_t i = 0U; i < buffers.getSize(); i++)
+    {
+        const JSONValue &buffer = buffers.getElement(i);
+        const std::string uri = buffer.getMember("uri").getString();
+        const std::size_t size = GLTFLoader::getIndex(buffer.getMember("byteLength"), 0U);
+        GLTFLoader::Buffer range{nullptr, 0U};
+
+        if (uri.empty())
+        {
+            range = binary;
+        }
+
+        else if (uri.compare(0U, 5U, "data:") == 0)
+        {
+            const std::size_t comma = uri.find(',');
+            data_stock.emplace_back();
+
+            if ((comma == std::string::npos) || !GLTFLoader::decodeBase64(uri.data() + comma + 1U, uri.data() + uri.size(), data_stock.back()))
+            {
+                std::cerr << "error: invalid data URI in the buffer " << i << " of `" << model_data->model_path << "'" << std::endl;
+                return false;
+            }
+
+            range = GLTFLoader::Buffer{reinterpret_cast<const char *>(data_stock.back().data()), data_stock.back().size()};
+        }
+
+        else
+        {
+            file_stock.emplace_back(new MappedFile(relative + GLTFLoader::decodeURI(uri)));
+
+            if (!file_stock.back()->isOpen())
+            {
+                std::cerr << "error: could not open the buffer `" << relative + GLTFLoader::decodeURI(uri) << "'" << std::endl;
+                return false;
+            }
+
+            range = GLTFLoader::Buffer{file_stock.back()->getData(), file_stock.back()->getSize()};
+        }
+
+        if (range.size < size)
+        {
+            std::cerr << "error: the buffer " << i << " of `" << model_data->model_path << "' is truncated" << std::endl;
+            return false;
+        }
+
+        buffer_stock.emplace_back(GLTFLoader::Buffer{range.data, size});
+    }
+
+    return true;
+}
+
+/** Reads an index, count or byte size, anything but a whole non negative number is `NONE', past the end of every array */
+std::size_t GLTFLoader::getIndex(const JSONValue &value, const std::size_t &fallback)
+{
+    const double number = value.getNumber(-1.0);
+
+    if (value.isNone())
+    {
+        return fallback;
+    }
+
+    return (number >= 0.0) && (number < static_cast<double>(GLTFLoader::NONE)) && (number == std::floor(number)) ? static_cast<std::size_t>(number) : GLTFLoader::NONE;
+}
+
+/** Checks that the accessor has `components' per element and lies inside its buffer view */
+bool GLTFLoader::getAccessor(const JSONValue &index, const std::size_t &components, GLTFLoader::Accessor &accessor) const
+{
+    const JSONValue &value = document.getMember("accessors").getElement(GLTFLoader::getIndex(index));
+    const JSONValue &view = document.getMember("bufferViews").getElement(GLTFLoader::getIndex(value.getMember("bufferView")));
+    const std::string type = value.getMember("type").getString();
+    const char *const types[] = {"SCALAR", "VEC2", "VEC3", "VEC4"};
+    const std::size_t buffer = GLTFLoader::getIndex(view.getMember("buffer"));
+
+    if (value.isNone() || view.isNone() || (buffer >= buffer_stock.size()) || (components < 1U) || (components > 4U) || (type != types[components - 1U]))
+    {
+        return false;
+    }
+
+    std::size_t size;
+    accessor.component_type = static_cast<GLenum>(GLTFLoader::getIndex(value.getMember("componentType"), 0U));
+
+    switch (accessor.component_type)
+    {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        size = 1U;
+        break;
+
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+        size = 2U;
+        break;
+
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+        size = 4U;
+        break;
+
+    default:
+        return false;
+    }
+
+    const std::size_t view_offset = GLTFLoader::getIndex(view.getMember("byteOffset"), 0U);
+    const std::size_t view_size = GLTFLoader::getIndex(view.getMember("byteLength"), 0U);
+    const std::size_t offset = GLTFLoader::getIndex(value.getMember("byteOffset"), 0U);
+
+    accessor.count = GLTFLoader::getIndex(value.getMember("count"), 0U);
+    accessor.components = components;
+    accessor.normalized = value.getMember("normalized").getBoolean();
+    accessor.stride = GLTFLoader::getIndex(view.getMember("byteStride"), size * components);
+    accessor.data = buffer_stock[buffer].data + view_offset + offset;
+
+    if (!value.getMember("sparse").isNone())
+    {
+        std::cerr << "warning: sparse glTF accessors are not supported, `" << model_data->model_path << "' is read without them" << std::endl;
+    }
+
+    // The last element must end inside the view, and the view inside its buffer
+    return (view_offset <= buffer_stock[buffer].size) && (view_size <= buffer_stock[buffer].size - view_offset) && (accessor.count > 0U) &&
+           (accessor.stride >= size * components) && (offset <= view_size) && ((view_size - offset - size * components) / accessor.stride >= accessor.count - 1U) &&
+           (view_size - offset >= size * components);
+}
+
+/** Reads an element as floats, normalized integers are mapped to [0, 1] or [-1, 1] */
+glm::vec4 GLTFLoader::readElement(const GLTFLoader::Accessor &accessor, const std::size_t &index)
+{
+    const char *const source = accessor.data + index * accessor.stride;
+    const bool swap = !ModelLoader::isLittleEndian();
+    glm::vec4 value(0.0F);
+
+    if ((accessor.component_type == GL_FLOAT) && !swap)
+    {
+        std::memcpy(&value[0], source, sizeof(float) * accessor.components);
+        return value;
+    }
+
+    for (std::size_t i = 0U; i < accessor.components; i++)
+    {
+        switch (accessor.component_type)
+        {
+        case GL_BYTE:
+        {
+            const float component = static_cast<float>(static_cast<signed char>(source[i]));
+            value[i] = accessor.normalized ? glm::max(component / 127.0F, -1.0F) : component;
+            break;
+        }
+
+        case GL_UNSIGNED_BYTE:
+        {
+            const float component = static_cast<float>(static_cast<unsigned char>(source[i]));
+            value[i] = accessor.normalized ? component / 255.0F : component;
+            break;
+        }
+
+        case GL_SHORT:
+        {
+            std::int16_t component;
+            ModelLoader::readBinary(source + i * sizeof(component), &component, sizeof(component), swap);
+            value[i] = accessor.normalized ? glm::max(static_cast<float>(component) / 32767.0F, -1.0F) : static_cast<float>(component);
+            break;
+        }
+
+        case GL_UNSIGNED_SHORT:
+        {
+            std::uint16_t component;
+            ModelLoader::readBinary(source + i * sizeof(component), &component, sizeof(component), swap);
+            value[i] = accessor.normalized ? static_cast<float>(component) / 65535.0F : static_cast<float>(component);
+            break;
+        }
+
+        case GL_UNSIGNED_INT:
+        {
+            std::uint32_t component;
+            ModelLoader::readBinary(source + i * sizeof(component), &component, sizeof(component), swap);
+            value[i] = static_cast<float>(component);
+            break;
+        }
+
+        default:
+            ModelLoader::readBinary(source + i * sizeof(float), &value[i], sizeof(float), swap);
+        }
+    }
+
+    return value;
+}
+
+std::size_t GLTFLoader::readIndex(const GLTFLoader::Accessor &accessor, const std::size_t &index)
+{
+    const char *const source = accessor.data + index * accessor.stride;
+    const bool swap = !ModelLoader::isLittleEndian();
+
+    if (accessor.component_type == GL_UNSIGNED_BYTE)
+    {
+        return static_cast<unsigned char>(*source);
+    }
+
+    if (accessor.component_type == GL_UNSIGNED_SHORT)
+    {
+        std::uint16_t value;
+        ModelLoader::readBinary(source, &value, sizeof(value), swap);
+        return value;
+    }
+
+    std::uint32_t value;
+    ModelLoader::readBinary(source, &value, sizeof(value), swap);
+    return value;
+}
+
+/** Images are read from their files, embedded ones are kept encoded in the material and named after the model */
+void GLTFLoader::readTexture(Material *const material, const Material::Attribute &attrib, const JSONValue &info)
+{
+    const JSONValue &texture = document.getMember("textures").getElement(GLTFLoader::getIndex(info.getMember("index")));
+    const std::size_t source = GLTFLoader::getIndex(texture.getMember("source"));
+    const JSONValue &image = document.getMember("images").getElement(source);
+    const std::string uri = image.getMember("uri").getString();
+    const std::string name = model_data->model_path + "#image" + std::to_string(source);
+
+    if (image.isNone())
+    {
+        return;
+    }
+
+    if (uri.compare(0U, 5U, "data:") == 0)
+    {
+        std::vector<GLubyte> data;
+        const std::size_t comma = uri.find(',');
+
+        if ((comma == std::string::npos) || !GLTFLoader::decodeBase64(uri.data() + comma + 1U, uri.data() + uri.size(), data))
+        {
+            std::cerr << "error: invalid data URI in the image " << source << " of `" << model_data->model_path << "'" << std::endl;
+            return;
+        }
+
+        material->setTextureData(attrib, name, data, false);
+    }
+
+    else if (!uri.empty())
+    {
+        material->setTexturePath(attrib, relative + GLTFLoader::decodeURI(uri), false);
+    }
+
+    else
+    {
+        const JSONValue &view = document.getMember("bufferViews").getElement(GLTFLoader::getIndex(image.getMember("bufferView")));
+        const std::size_t buffer = GLTFLoader::getIndex(view.getMember("buffer"));
+        const std::size_t offset = GLTFLoader::getIndex(view.getMember("byteOffset"), 0U);
+        const std::size_t size = GLTFLoader::getIndex(view.getMember("byteLength"), 0U);
+
+        if ((buffer >= buffer_stock.size()) || (offset > buffer_stock[buffer].size) || (size > buffer_stock[buffer].size - offset))
+        {
+            std::cerr << "error: invalid buffer view in the image " << source << " of `" << model_data->model_path << "'" << std::endl;
+            return;
+        }
+
+        const GLubyte *const data = reinterpret_cast<const GLubyte *>(buffer_stock[buffer].data + offset);
+        material->setTextureData(attrib, name, std::vector<GLubyte>(data, data + size), false);
+    }
+
+    model_data->textures++;
+}
+
+/**
+ * Maps the metallic roughness materials to the existing attributes. The names are made unique, since the cache
+ * finds the materials by name, and the default material is only added when a primitive has none.
+ */
+void GLTFLoader::readMaterials()
+{
+    const JSONValue &materials = document.getMember("materials");
+    const JSONValue &meshes = document.getMember("meshes");
+    const std::size_t first_material = model_data->material_stock.size();
+    bool unassigned = false;
+
+    for (std::size_t i = 0U; i < meshes.getSize(); i++)
+    {
+        const JSONValue &primitives = meshes.getElement(i).getMember("primitives");
+
+        for (std::size_t j = 0U; j < primitives.getSize(); j++)
+        {
+            const std::size_t material = GLTFLoader::getIndex(primitives.getElement(j).getMember("material"));
+            unassigned = unassigned || (material >= materials.getSize());
+        }
+    }
+
+    for (std::size_t i = 0U; i <= materials.getSize(); i++)
+    {
+        const JSONValue &material = materials.getElement(i);
+        std::string name = i < materials.getSize() ? material.getMember("name").getString("material_" + std::to_string(i)) : "default";
+
+        if ((i == materials.getSize()) && !unassigned)
+        {
+            break;
+        }
+
+        for (std::size_t j = 0U; j < model_data->material_stock.size(); j++)
+        {
+            if (model_data->material_stock[j]->getName() == name)
+            {
+                name += "_" + std::to_string(i);
+                j = static_cast<std::size_t>(-1);
+            }
+        }
+
+        Material *const new_material = new Material(name);
+        model_data->material_stock.emplace_back(new_material);
+
+        if (i == materials.getSize())
+        {
+            default_material = new_material;
+            break;
+        }
+
+        const JSONValue &pbr = material.getMember("pbrMetallicRoughness");
+        const JSONValue &factor = pbr.getMember("baseColorFactor");
+        const float roughness = static_cast<float>(pbr.getMember("roughnessFactor").getNumber(1.0));
+        const float alpha = static_cast<float>(factor.getElement(3U).getNumber(1.0));
+
+        new_material->setColor(Material::DIFFUSE, glm::vec3(factor.getElement(0U).getNumber(1.0), factor.getElement(1U).getNumber(1.0), factor.getElement(2U).getNumber(1.0)));
+        new_material->setValue(Material::METALNESS, static_cast<float>(pbr.getMember("metallicFactor").getNumber(1.0)));
+        new_material->setValue(Material::ROUGHNESS, roughness);
+
+        // Blinn-Phong exponent with a similar highlight to the roughness
+        new_material->setValue(Material::SHININESS, glm::clamp(2.0F / glm::max(roughness * roughness * roughness * roughness, 1e-6F) - 2.0F, 1.0F, 1000.0F));
+
+        if (material.getMember("alphaMode").getString("OPAQUE") != "OPAQUE")
+        {
+            new_material->setValue(Material::TRANSPARENCY, 1.0F - alpha);
+        }
+
+        readTexture(new_material, Material::DIFFUSE, pbr.getMember("baseColorTexture"));
+        readTexture(new_material, Material::NORMAL, material.getMember("normalTexture"));
+    }
+
+    decodeTextures(first_material);
+    model_data->material_open = true;
+}
+
+/** Node transforms are baked into the vertices, a node is either a matrix or translation, rotation and scale */
+void GLTFLoader::readNode(const std::size_t &node, const glm::mat4 &parent_mat, const std::size_t &depth)
+{
+    const JSONValue &value = document.getMember("nodes").getElement(node);
+
+    if (value.isNone() || (depth > GLTFLoader::MAX_DEPTH))
+    {
+        return;
+    }
+
+    glm::mat4 node_mat(1.0F);
+    const JSONValue &matrix = value.getMember("matrix");
+
+    if (matrix.getSize() == 16U)
+    {
+        for (glm::mat4::length_type i = 0; i < 16; i++)
+        {
+            node_mat[i / 4][i % 4] = static_cast<float>(matrix.getElement(static_cast<std::size_t>(i)).getNumber());
+        }
+    }
+
+    else
+    {
+        const JSONValue &translation = value.getMember("translation");
+        const JSONValue &rotation = value.getMember("rotation");
+        const JSONValue &scale = value.getMember("scale");
+
+        const glm::quat quaternion(static_cast<float>(rotation.getElement(3U).getNumber(1.0)), static_cast<float>(rotation.getElement(0U).getNumber()),
+                                   static_cast<float>(rotation.getElement(1U).getNumber()), static_cast<float>(rotation.getElement(2U).getNumber()));
+
+        node_mat = glm::translate(node_mat, glm::vec3(translation.getElement(0U).getNumber(), translation.getElement(1U).getNumber(), translation.getElement(2U).getNumber()));
+        node_mat *= glm::mat4_cast(quaternion);
+        node_mat = glm::scale(node_mat, glm::vec3(scale.getElement(0U).getNumber(1.0), scale.getElement(1U).getNumber(1.0), scale.getElement(2U).getNumber(1.0)));
+    }
+
+    node_mat = parent_mat * node_mat;
+
+    if (!value.getMember("mesh").isNone())
+    {
+        readMesh(GLTFLoader::getIndex(value.getMember("mesh")), node_mat);
+    }
+
+    const JSONValue &children = value.getMember("children");
+
+    for (std::size_t i = 0U; i < children.getSize(); i++)
+    {
+        readNode(GLTFLoader::getIndex(children.getElement(i)), node_mat, depth + 1U);
+    }
+}
+
+/** Every triangle primitive becomes an object, its vertices and indices are copied without looking for duplicates */
+void GLTFLoader::readMesh(const std::size_t &mesh, const glm::mat4 &node_mat)
+{
+    const JSONValue &primitives = document.getMember("meshes").getElement(mesh).getMember("primitives");
+    const glm::mat3 normal_mat = glm::transpose(glm::inverse(glm::mat3(node_mat)));
+    const bool mirrored = glm::determinant(glm::mat3(node_mat)) < 0.0F;
+
+    for (std::size_t i = 0U; i < primitives.getSize(); i++)
+    {
+        const JSONValue &primitive = primitives.getElement(i);
+        const JSONValue &attributes = primitive.getMember("attributes");
+        const std::size_t mode = GLTFLoader::getIndex(primitive.getMember("mode"), 4U);
+        const std::size_t first_vertex = vertex_stock.size();
+        const std::size_t first_index = index_stock.size();
+        GLTFLoader::Accessor position;
+        GLTFLoader::Accessor normal;
+        GLTFLoader::Accessor uv_coord;
+        GLTFLoader::Accessor index;
+
+        if (mode != 4U)
+        {
+            std::cerr << "warning: skipped a glTF primitive of `" << model_data->model_path << "' drawn with the mode " << mode << ", only triangles are read" << std::endl;
+            continue;
+        }
+
+        if (!getAccessor(attributes.getMember("POSITION"), 3U, position))
+        {
+            std::cerr << "warning: skipped a glTF primitive of `" << model_data->model_path << "' without valid positions" << std::endl;
+            continue;
+        }
+
+        const bool normals = getAccessor(attributes.getMember("NORMAL"), 3U, normal) && (normal.count == position.count);
+        const bool uv_coords = getAccessor(attributes.getMember("TEXCOORD_0"), 2U, uv_coord) && (uv_coord.count == position.count);
+        const bool indices = !primitive.getMember("indices").isNone();
+
+        if (indices && (!getAccessor(primitive.getMember("indices"), 1U, index) || (index.component_type == GL_BYTE) || (index.component_type == GL_SHORT) || (index.component_type == GL_FLOAT)))
+        {
+            std::cerr << "warning: skipped a glTF primitive of `" << model_data->model_path << "' with invalid indices" << std::endl;
+            continue;
+        }
+
+        vertex_stock.resize(first_vertex + position.count);
+
+        for (std::size_t j = 0U; j < position.count; j++)
+        {
+            ModelLoader::Vertex &vertex = vertex_stock[first_vertex + j];
+
+            vertex.position = glm::vec3(node_mat * glm::vec4(glm::vec3(GLTFLoader::readElement(position, j)), 1.0F));
+            model_data->min = glm::min(model_data->min, vertex.position);
+            model_data->max = glm::max(model_data->max, vertex.position);
+
+            if (normals)
+            {
+                const glm::vec3 direction = normal_mat * glm::vec3(GLTFLoader::readElement(normal, j));
+                const float length = glm::length(direction);
+                vertex.normal = length > 0.0F ? direction / length : direction;
+            }
+
+            // The images are flipped on load, so the V axis goes up as in the OBJ files
+            if (uv_coords)
+            {
+                const glm::vec4 value = GLTFLoader::readElement(uv_coord, j);
+                vertex.uv_coord = glm::vec2(value.x, 1.0F - value.y);
+            }
+        }
+
+        const std::size_t count = indices ? index.count - index.count % 3U : position.count - position.count % 3U;
+        index_stock.resize(first_index + count);
+
+        for (std::size_t j = 0U; j < count; j++)
+        {
+            // A mirroring transform turns the faces around, swapping two corners keeps them counter clockwise
+            const std::size_t corner = mirrored ? j - j % 3U + (3U - j % 3U) % 3U : j;
+            const std::size_t value = indices ? GLTFLoader::readIndex(index, corner) : corner;
+
+            if (value >= position.count)
+            {
+                std::cerr << "warning: skipped a glTF primitive of `" << model_data->model_path << "' with indices out of range" << std::endl;
+                index_stock.resize(first_index);
+                break;
+            }
+
+            index_stock[first_index + j] = static_cast<GLsizei>(first_vertex + value);
+        }
+
+        if (index_stock.size() == first_index)
+        {
+            vertex_stock.resize(first_vertex);
+            continue;
+        }
+
+        if (!normals)
+        {
+            calcNormals(first_vertex, first_index);
+        }
+
+        const std::size_t material = GLTFLoader::getIndex(primitive.getMember("material"));
+        Material *const object_material = material < document.getMember("materials").getSize() ? model_data->material_stock[material] : default_material;
+
+        model_data->object_stock.emplace_back(new ModelData::Object(static_cast<GLsizei>(count), static_cast<GLsizei>(first_index), object_material));
+    }
+}
+
+/** Reads the file up to its materials, the buffers are needed for the embedded images */
+bool GLTFLoader::readMaterial(const std::string &path)
+{
+    library_stock.emplace_back(path);
+    model_data->material_path = path;
+
+    if (!readDocument(path) || !readBuffers())
+    {
+        return false;
+    }
+
+    readMaterials();
+    return true;
+}
+
+bool GLTFLoader::read()
+{
+    if (!readMaterial(model_data->model_path))
+    {
+        return false;
+    }
+
+    const JSONValue &scenes = document.getMember("scenes");
+    const JSONValue &scene = scenes.getElement(GLTFLoader::getIndex(document.getMember("scene"), 0U));
+
+    // Without scenes nothing would be shown, so every mesh is read once untransformed
+    if (scenes.getSize() == 0U)
+    {
+        for (std::size_t i = 0U; i < document.getMember("meshes").getSize(); i++)
+        {
+            readMesh(i, glm::mat4(1.0F));
+        }
+    }
+
+    for (std::size_t i = 0U; i < scene.getMember("nodes").getSize(); i++)
+    {
+        readNode(GLTFLoader::getIndex(scene.getMember("nodes").getElement(i)), glm::mat4(1.0F), 0U);
+    }
+
+    finishRead(vertex_stock.size());
+
+    document = JSONValue();
+    buffer_stock.clear();
+    data_stock.clear();
+    file_stock.clear();
+    file.reset();
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef __GLTF_LOADER_HPP_
+#define __GLTF_LOADER_HPP_
+#include "modelloader.hpp"
+#include "jsonvalue.hpp"
+#include "mappedfile.hpp"
+#include <glm/mat4x4.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** glTF 2.0 reader for .gltf and .glb files, the indexed primitives are copied as they are without welding */
+class GLTFLoader : public ModelLoader
+{
+private:
+    /** Byte range of a buffer, inside a mapped file or a decoded data URI */
+    struct Buffer
+    {
+        const char *data;
+        std::size_t size;
+    };
+
+    /** Typed view of a buffer, the element `i' starts at `data + i * stride' */
+    struct Accessor
+    {
+        const char *data;
+        std::size_t count;
+        std::size_t stride;
+        std::size_t components;
+        GLenum component_type;
+        bool normalized;
+    };
+
+    JSONValue document;
+    GLTFLoader::Buffer binary;
+    std::string relative;
+    std::unique_ptr<MappedFile> file;
+    std::vector<std::unique_ptr<MappedFile>> file_stock;
+    std::vector<std::vector<GLubyte>> data_stock;
+    std::vector<GLTFLoader::Buffer> buffer_stock;
+    Material *default_material;
+
+    GLTFLoader() = delete;
+    GLTFLoader(const GLTFLoader &) = delete;
+    GLTFLoader &operator=(const GLTFLoader &) = delete;
+    bool readDocument(const std::string &path);
+    bool readBuffers();
+    bool getAccessor(const JSONValue &index, const std::size_t &components, GLTFLoader::Accessor &accessor) const;
+    void readMaterials();
+    void readTexture(Material *const material, const Material::Attribute &attrib, const JSONValue &info);
+    void readNode(const std::size_t &node, const glm::mat4 &parent_mat, const std::size_t &depth);
+    void readMesh(const std::size_t &mesh, const glm::mat4 &node_mat);
+    bool read();
+    bool readMaterial(const std::string &path);
+    static const std::uint32_t GLB_MAGIC;
+    static const std::uint32_t JSON_CHUNK;
+    static const std::uint32_t BIN_CHUNK;
+    static const std::size_t MAX_DEPTH;
+    static const std::size_t NONE;
+    static std::size_t getIndex(const JSONValue &value, const std::size_t &fallback = GLTFLoader::NONE);
+    static glm::vec4 readElement(const GLTFLoader::Accessor &accessor, const std::size_t &index);
+    static std::size_t readIndex(const GLTFLoader::Accessor &accessor, const std::size_t &index);
+    static bool decodeBase64(const char *cursor, const char *const end, std::vector<GLubyte> &data);
+    static std::string decodeURI(const std::string &uri);
+
+public:
+    GLTFLoader(const std::string &path);
+};
+
+#endif
\ No newline at end of file
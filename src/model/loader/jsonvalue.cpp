@@ -0,0 +1,300 @@
+#include "jsonvalue.hpp"
+#include <cstdlib>
+#include <cstring>
+
+const std::size_t JSONValue::MAX_DEPTH = 256U;
+const JSONValue JSONValue::none;
+
+JSONValue::JSONValue() : type(JSONValue::NONE),
+                         number(0.0) {}
+
+const char *JSONValue::skipSpace(const char *cursor, const char *const end)
+{
+    while ((cursor < end) && ((*cursor == ' ') || (*cursor == '\t') || (*cursor == '\n') || (*cursor == '\r')))
+    {
+        cursor++;
+    }
+
+    return cursor;
+}
+
+/** Reads a quoted string, the escapes are decoded and \u code points written as UTF-8 */
+bool JSONValue::parseString(const char *&cursor, const char *const end, std::string &str)
+{
+    if ((cursor >= end) || (*cursor != '"'))
+    {
+        return false;
+    }
+
+    str.clear();
+    cursor++;
+
+    while (cursor < end)
+    {
+        const char c = *cursor++;
+
+        if (c == '"')
+        {
+            return true;
+        }
+
+        if (c != '\\')
+        {
+            str += c;
+            continue;
+        }
+
+        if (cursor >= end)
+        {
+            return false;
+        }
+
+        const char escape = *cursor++;
+        const char *const simple = std::strchr("\"\\/bfnrt", escape);
+
+        if ((escape != '\0') && (simple != nullptr))
+        {
+            str += "\"\\/\b\f\n\r\t"[simple - "\"\\/bfnrt"];
+            continue;
+        }
+
+        if ((escape != 'u') || (end - cursor < 4))
+        {
+            return false;
+        }
+
+        unsigned long code = std::strtoul(std::string(cursor, cursor + 4).c_str(), nullptr, 16);
+        cursor += 4;
+
+        // A high surrogate followed by a low one makes a single code point
+        if ((code >= 0xD800UL) && (code < 0xDC00UL) && (end - cursor >= 6) && (cursor[0] == '\\') && (cursor[1] == 'u'))
+        {
+            const unsigned long low = std::strtoul(std::string(cursor + 2, cursor + 6).c_str(), nullptr, 16);
+
+            if ((low >= 0xDC00UL) && (low < 0xE000UL))
+            {
+                code = 0x10000UL + ((code - 0xD800UL) << 10U) + (low - 0xDC00UL);
+                cursor += 6;
+            }
+        }
+
+        if (code < 0x80UL)
+        {
+            str += static_cast<char>(code);
+        }
+
+        else if (code < 0x800UL)
+        {
+            str += static_cast<char>(0xC0UL | (code >> 6U));
+            str += static_cast<char>(0x80UL | (code & 0x3FUL));
+        }
+
+        else if (code < 0x10000UL)
+        {
+            str += static_cast<char>(0xE0UL | (code >> 12U));
+            str += static_cast<char>(0x80UL | ((code >> 6U) & 0x3FUL));
+            str += static_cast<char>(0x80UL | (code & 0x3FUL));
+        }
+
+        else
+        {
+            str += static_cast<char>(0xF0UL | (code >> 18U));
+            str += static_cast<char>(0x80UL | ((code >> 12U) & 0x3FUL));
+            str += static_cast<char>(0x80UL | ((code >> 6U) & 0x3FUL));
+            str += static_cast<char>(0x80UL | (code & 0x3FUL));
+        }
+    }
+
+    return false;
+}
+
+bool JSONValue::parseNumber(const char *&cursor, const char *const end, double &number)
+{
+    const char *const begin = cursor;
+
+    while ((cursor < end) && (std::strchr("+-0123456789.eE", *cursor) != nullptr) && (*cursor != '\0'))
+    {
+        cursor++;
+    }
+
+    // The mapped text is not null terminated, so the digits are copied before the conversion
+    const std::string digits(begin, cursor);
+    char *last = nullptr;
+    number = std::strtod(digits.c_str(), &last);
+
+    return !digits.empty() && (last == digits.c_str() + digits.size());
+}
+
+bool JSONValue::parseValue(const char *&cursor, const char *const end, JSONValue &value, const std::size_t &depth)
+{
+    cursor = JSONValue::skipSpace(cursor, end);
+
+    if ((cursor >= end) || (depth > JSONValue::MAX_DEPTH))
+    {
+        return false;
+    }
+
+    if (*cursor == '{')
+    {
+        value.type = JSONValue::OBJECT;
+        cursor = JSONValue::skipSpace(cursor + 1, end);
+
+        if ((cursor < end) && (*cursor == '}'))
+        {
+            cursor++;
+            return true;
+        }
+
+        while (cursor < end)
+        {
+            value.key_stock.emplace_back();
+            value.element_stock.emplace_back();
+            cursor = JSONValue::skipSpace(cursor, end);
+
+            if (!JSONValue::parseString(cursor, end, value.key_stock.back()))
+            {
+                return false;
+            }
+
+            cursor = JSONValue::skipSpace(cursor, end);
+
+            if ((cursor >= end) || (*cursor++ != ':') || !JSONValue::parseValue(cursor, end, value.element_stock.back(), depth + 1U))
+            {
+                return false;
+            }
+
+            cursor = JSONValue::skipSpace(cursor, end);
+
+            if ((cursor < end) && (*cursor == '}'))
+            {
+                cursor++;
+                return true;
+            }
+
+            if ((cursor >= end) || (*cursor++ != ','))
+            {
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    if (*cursor == '[')
+    {
+        value.type = JSONValue::ARRAY;
+        cursor = JSONValue::skipSpace(cursor + 1, end);
+
+        if ((cursor < end) && (*cursor == ']'))
+        {
+            cursor++;
+            return true;
+        }
+
+        while (cursor < end)
+        {
+            value.element_stock.emplace_back();
+
+            if (!JSONValue::parseValue(cursor, end, value.element_stock.back(), depth + 1U))
+            {
+                return false;
+            }
+
+            cursor = JSONValue::skipSpace(cursor, end);
+
+            if ((cursor < end) && (*cursor == ']'))
+            {
+                cursor++;
+                return true;
+            }
+
+            if ((cursor >= end) || (*cursor++ != ','))
+            {
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    if (*cursor == '"')
+    {
+        value.type = JSONValue::STRING;
+        return JSONValue::parseString(cursor, end, value.str);
+    }
+
+    const char *const literal[] = {"true", "false", "null"};
+
+    for (std::size_t i = 0U; i < 3U; i++)
+    {
+        const std::size_t length = std::strlen(literal[i]);
+
+        if ((static_cast<std::size_t>(end - cursor) >= length) && (std::strncmp(cursor, literal[i], length) == 0))
+        {
+            value.type = i < 2U ? JSONValue::BOOLEAN : JSONValue::NONE;
+            value.number = i == 0U ? 1.0 : 0.0;
+            cursor += length;
+            return true;
+        }
+    }
+
+    value.type = JSONValue::NUMBER;
+    return JSONValue::parseNumber(cursor, end, value.number);
+}
+
+JSONValue::Type JSONValue::getType() const
+{
+    return type;
+}
+
+bool JSONValue::isNone() const
+{
+    return type == JSONValue::NONE;
+}
+
+std::size_t JSONValue::getSize() const
+{
+    return type == JSONValue::ARRAY ? element_stock.size() : 0U;
+}
+
+const JSONValue &JSONValue::getElement(const std::size_t &index) const
+{
+    return (type == JSONValue::ARRAY) && (index < element_stock.size()) ? element_stock[index] : JSONValue::none;
+}
+
+const JSONValue &JSONValue::getMember(const std::string &key) const
+{
+    for (std::size_t i = 0U; (type == JSONValue::OBJECT) && (i < key_stock.size()); i++)
+    {
+        if (key_stock[i] == key)
+        {
+            return element_stock[i];
+        }
+    }
+
+    return JSONValue::none;
+}
+
+bool JSONValue::getBoolean(const bool &fallback) const
+{
+    return type == JSONValue::BOOLEAN ? number != 0.0 : fallback;
+}
+
+double JSONValue::getNumber(const double &fallback) const
+{
+    return type == JSONValue::NUMBER ? number : fallback;
+}
+
+std::string JSONValue::getString(const std::string &fallback) const
+{
+    return type == JSONValue::STRING ? str : fallback;
+}
+
+/** Parses a whole document, anything but white space after the root value is an error */
+bool JSONValue::parse(const char *const begin, const char *const end, JSONValue &value)
+{
+    const char *cursor = begin;
+    value = JSONValue();
+
+    return JSONValue::parseValue(cursor, end, value, 0U) && (JSONValue::skipSpace(cursor, end) == end);
+}
\ No newline at end of file
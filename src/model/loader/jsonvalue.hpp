@@ -0,0 +1,48 @@
+#ifndef __JSON_VALUE_HPP_
+#define __JSON_VALUE_HPP_
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** Parsed JSON value, objects keep their members in file order and missing members read as null */
+class JSONValue
+{
+public:
+    enum Type
+    {
+        NONE,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+private:
+    JSONValue::Type type;
+    double number;
+    std::string str;
+    std::vector<std::string> key_stock;
+    std::vector<JSONValue> element_stock;
+
+    static const std::size_t MAX_DEPTH;
+    static const JSONValue none;
+    static const char *skipSpace(const char *cursor, const char *const end);
+    static bool parseValue(const char *&cursor, const char *const end, JSONValue &value, const std::size_t &depth);
+    static bool parseString(const char *&cursor, const char *const end, std::string &str);
+    static bool parseNumber(const char *&cursor, const char *const end, double &number);
+
+public:
+    JSONValue();
+    JSONValue::Type getType() const;
+    bool isNone() const;
+    std::size_t getSize() const;
+    const JSONValue &getElement(const std::size_t &index) const;
+    const JSONValue &getMember(const std::string &key) const;
+    bool getBoolean(const bool &fallback = false) const;
+    double getNumber(const double &fallback = 0.0) const;
+    std::string getString(const std::string &fallback = std::string()) const;
+    static bool parse(const char *const begin, const char *const end, JSONValue &value);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "mappedfile.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &path) : data(nullptr),
+                                                  size(0U),
+                                                  open(false),
+
+#if defined(_WIN32)
+                                                  file(INVALID_HANDLE_VALUE),
+                                                  mapping(nullptr)
+{
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file, &file_size) == FALSE)
+    {
+        return;
+    }
+
+    size = static_cast<std::size_t>(file_size.QuadPart);
+    open = true;
+
+    // Empty files cannot be mapped
+    if (size == 0U)
+    {
+        return;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        open = false;
+        return;
+    }
+
+    data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    open = data != nullptr;
+}
+#else
+                                                  descriptor(-1)
+{
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor == -1)
+    {
+        return;
+    }
+
+    struct stat status;
+    if ((fstat(descriptor, &status) == -1) || !S_ISREG(status.st_mode))
+    {
+        return;
+    }
+
+    size = static_cast<std::size_t>(status.st_size);
+    open = true;
+
+    // Empty files cannot be mapped
+    if (size == 0U)
+    {
+        return;
+    }
+
+    void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (address == MAP_FAILED)
+    {
+        open = false;
+        return;
+    }
+
+    madvise(address, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(address);
+}
+#endif
+
+bool MappedFile::isOpen() const
+{
+    return open;
+}
+
+const char *MappedFile::getData() const
+{
+    return data;
+}
+
+const char *MappedFile::getEnd() const
+{
+    return data + size;
+}
+
+std::size_t MappedFile::getSize() const
+{
+    return size;
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(_WIN32)
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    if (mapping != nullptr)
+    {
+        CloseHandle(mapping);
+    }
+
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+    }
+#else
+    if (data != nullptr)
+    {
+        munmap(const_cast<char *>(data), size);
+    }
+
+    if (descriptor != -1)
+    {
+        close(descriptor);
+    }
+#endif
+}
\ No newline at end of file
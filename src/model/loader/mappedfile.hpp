@@ -0,0 +1,34 @@
+#ifndef __MAPPED_FILE_HPP_
+#define __MAPPED_FILE_HPP_
+
+#include <string>
+
+/** Read only memory mapped file */
+class MappedFile
+{
+private:
+    const char *data;
+    std::size_t size;
+    bool open;
+
+#if defined(_WIN32)
+    void *file;
+    void *mapping;
+#else
+    int descriptor;
+#endif
+
+    MappedFile() = delete;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+public:
+    MappedFile(const std::string &path);
+    bool isOpen() const;
+    const char *getData() const;
+    const char *getEnd() const;
+    std::size_t getSize() const;
+    virtual ~MappedFile();
+};
+
+#endif
\ No newline at end of file
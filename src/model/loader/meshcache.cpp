@@ -0,0 +1,446 @@
+#include "meshcache.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+bool MeshCache::enabled = true;
+const char MeshCache::MAGIC[8] = {'O', 'B', 'J', 'C', 'A', 'C', 'H', 'E'};
+const std::uint32_t MeshCache::VERSION = 6U;
+const std::string MeshCache::EXTENSION = ".objcache";
+
+MeshCache::MeshCache(const std::string &path, const std::size_t &vertex_size, const GLenum &options, const std::size_t &lod_levels) : file(path + MeshCache::EXTENSION),
+                                                                                                                                      header(nullptr),
+                                                                                                                                      valid(false)
+{
+    valid = validate(path, vertex_size, options, lod_levels);
+
+    if (!valid)
+    {
+        library_stock.clear();
+        object_stock.clear();
+        lod_stock.clear();
+        cluster_stock.clear();
+    }
+}
+
+bool MeshCache::validate(const std::string &path, const std::size_t &vertex_size, const GLenum &options, const std::size_t &lod_levels)
+{
+    if (!file.isOpen() || (file.getSize() < sizeof(MeshCache::Header)))
+    {
+        return false;
+    }
+
+    header = reinterpret_cast<const MeshCache::Header *>(file.getData());
+
+    if ((std::memcmp(header->magic, MeshCache::MAGIC, sizeof(MeshCache::MAGIC)) != 0) || (header->version != MeshCache::VERSION) ||
+        (header->vertex_size != vertex_size) || (header->options != options) || (header->lod_levels != lod_levels) || (header->file_size != file.getSize()))
+    {
+        return false;
+    }
+
+    // Both arrays have to lie inside the file, aligned for direct use
+    if ((header->vertex_offset % 16U != 0U) || (header->index_offset % 16U != 0U) ||
+        (header->vertex_offset > header->file_size) || (header->vertex_count > (header->file_size - header->vertex_offset) / vertex_size) ||
+        (header->index_offset > header->file_size) || (header->index_size > header->file_size - header->index_offset))
+    {
+        return false;
+    }
+
+    const char *cursor = file.getData() + sizeof(MeshCache::Header);
+    const char *const end = file.getData() + std::min(header->vertex_offset, header->index_offset);
+
+    std::string source;
+    if (!MeshCache::readString(cursor, end, source) || (source != path))
+    {
+        return false;
+    }
+
+    // Every string takes at least its length and every object at least twenty bytes
+    if ((header->library_count > static_cast<std::size_t>(end - cursor) / sizeof(std::uint32_t)) ||
+        (header->object_count > static_cast<std::size_t>(end - cursor) / (4U * sizeof(std::uint32_t) + sizeof(std::uint32_t))))
+    {
+        return false;
+    }
+
+    library_stock.resize(header->library_count);
+    for (std::string &library : library_stock)
+    {
+        if (!MeshCache::readString(cursor, end, library))
+        {
+            return false;
+        }
+    }
+
+    object_stock.resize(header->object_count);
+    for (MeshCache::Object &object : object_stock)
+    {
+        if (static_cast<std::size_t>(end - cursor) < 4U * sizeof(std::uint32_t))
+        {
+            return false;
+        }
+
+        std::memcpy(&object.count, cursor, sizeof(GLsizei));
+        std::memcpy(&object.offset, cursor + sizeof(GLsizei), sizeof(GLsizei));
+        std::memcpy(&object.type, cursor + 2U * sizeof(GLsizei), sizeof(GLenum));
+        std::memcpy(&object.base_vertex, cursor + 2U * sizeof(GLsizei) + sizeof(GLenum), sizeof(GLint));
+        cursor += 4U * sizeof(std::uint32_t);
+
+        if ((object.count < 0) || (object.offset < 0) || ((object.type != GL_UNSIGNED_SHORT) && (object.type != GL_UNSIGNED_INT)) ||
+            (object.base_vertex < 0) || (static_cast<std::uint64_t>(object.base_vertex) > header->vertex_count) ||
+            ((static_cast<std::uint64_t>(object.count) + static_cast<std::uint64_t>(object.offset)) * static_cast<std::uint64_t>(ModelData::Object::getTypeSize(object.type)) > header->index_size) ||
+            !MeshCache::readString(cursor, end, object.material))
+        {
+            return false;
+        }
+    }
+
+    if (header->lod_count > static_cast<std::size_t>(end - cursor) / (2U * sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(float)))
+    {
+        return false;
+    }
+
+    lod_stock.resize(header->lod_count);
+    for (ModelData::Lod &lod : lod_stock)
+    {
+        std::uint32_t first;
+        std::uint32_t last;
+        std::uint64_t triangles;
+
+        std::memcpy(&first, cursor, sizeof(std::uint32_t));
+        std::memcpy(&last, cursor + sizeof(std::uint32_t), sizeof(std::uint32_t));
+        std::memcpy(&triangles, cursor + 2U * sizeof(std::uint32_t), sizeof(std::uint64_t));
+        std::memcpy(&lod.error, cursor + 2U * sizeof(std::uint32_t) + sizeof(std::uint64_t), sizeof(float));
+        cursor += 2U * sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(float);
+
+        if ((first > last) || (last > header->object_count))
+        {
+            return false;
+        }
+
+        lod.first = first;
+        lod.last = last;
+        lod.triangles = static_cast<std::size_t>(triangles);
+    }
+
+    // Clusters keep the order of their objects and lie inside the index array
+    if (header->cluster_count > static_cast<std::size_t>(end - cursor) / (3U * sizeof(std::uint32_t) + 8U * sizeof(float)))
+    {
+        return false;
+    }
+
+    cluster_stock.resize(header->cluster_count);
+    for (std::size_t i = 0U; i < cluster_stock.size(); i++)
+    {
+        ModelData::Cluster &cluster = cluster_stock[i];
+        std::uint32_t object;
+
+        std::memcpy(&object, cursor, sizeof(std::uint32_t));
+        std::memcpy(&cluster.count, cursor + sizeof(std::uint32_t), sizeof(GLsizei));
+        std::memcpy(&cluster.offset, cursor + 2U * sizeof(std::uint32_t), sizeof(GLsizei));
+        std::memcpy(&cluster.center, cursor + 3U * sizeof(std::uint32_t), 3U * sizeof(float));
+        std::memcpy(&cluster.radius, cursor + 3U * sizeof(std::uint32_t) + 3U * sizeof(float), sizeof(float));
+        std::memcpy(&cluster.cone_axis, cursor + 3U * sizeof(std::uint32_t) + 4U * sizeof(float), 3U * sizeof(float));
+        std::memcpy(&cluster.cone_cutoff, cursor + 3U * sizeof(std::uint32_t) + 7U * sizeof(float), sizeof(float));
+        cursor += 3U * sizeof(std::uint32_t) + 8U * sizeof(float);
+
+        if ((object >= header->object_count) || ((i > 0U) && (object < cluster_stock[i - 1U].object)) || (cluster.count < 0) || (cluster.offset < 0) ||
+            (static_cast<std::uint64_t>(cluster.offset) + static_cast<std::uint64_t>(cluster.count) * static_cast<std::uint64_t>(ModelData::Object::getTypeSize(object_stock[object].type)) > header->index_size))
+        {
+            return false;
+        }
+
+        cluster.object = object;
+    }
+
+    std::uint64_t source_size;
+    std::int64_t source_time;
+    if (!MeshCache::readStatus(path, source_size, source_time) || (source_size != header->source_size))
+    {
+        return false;
+    }
+
+    // A different modification time alone does not invalidate the cache if the content is the same
+    return (source_time == header->source_time) || (MeshCache::hash(path) == header->source_hash);
+}
+
+bool MeshCache::readString(const char *&cursor, const char *const end, std::string &str)
+{
+    std::uint32_t length;
+
+    if (static_cast<std::size_t>(end - cursor) < sizeof(std::uint32_t))
+    {
+        return false;
+    }
+
+    std::memcpy(&length, cursor, sizeof(std::uint32_t));
+    cursor += sizeof(std::uint32_t);
+
+    if (static_cast<std::size_t>(end - cursor) < length)
+    {
+        return false;
+    }
+
+    str.assign(cursor, length);
+    cursor += length;
+
+    return true;
+}
+
+void MeshCache::writeString(std::string &data, const std::string &str)
+{
+    const std::uint32_t length = static_cast<std::uint32_t>(str.size());
+
+    data.append(reinterpret_cast<const char *>(&length), sizeof(std::uint32_t));
+    data.append(str);
+}
+
+bool MeshCache::readStatus(const std::string &path, std::uint64_t &size, std::int64_t &time)
+{
+#if defined(_WIN32)
+    struct _stat64 status;
+    if (_stat64(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+#else
+    struct stat status;
+    if (::stat(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+#endif
+
+    size = static_cast<std::uint64_t>(status.st_size);
+    time = static_cast<std::int64_t>(status.st_mtime);
+
+    return true;
+}
+
+std::uint64_t MeshCache::hash(const std::string &path)
+{
+    const MappedFile source(path);
+    const char *cursor = source.getData();
+    const char *const end = source.getEnd();
+
+    std::uint64_t value = 0xCBF29CE484222325ULL ^ static_cast<std::uint64_t>(source.getSize());
+    std::uint64_t word;
+
+    // Eight bytes per step, the tail is zero padded
+    for (; (end - cursor) >= 8; cursor += 8)
+    {
+        std::memcpy(&word, cursor, 8U);
+        value = (value ^ word) * 0x9E3779B97F4A7C15ULL;
+        value ^= value >> 32U;
+    }
+
+    if (cursor < end)
+    {
+        word = 0U;
+        std::memcpy(&word, cursor, static_cast<std::size_t>(end - cursor));
+        value = (value ^ word) * 0x9E3779B97F4A7C15ULL;
+        value ^= value >> 32U;
+    }
+
+    return value;
+}
+
+bool MeshCache::isValid() const
+{
+    return valid;
+}
+
+const void *MeshCache::getVertices() const
+{
+    return file.getData() + header->vertex_offset;
+}
+
+std::size_t MeshCache::getVertexCount() const
+{
+    return static_cast<std::size_t>(header->vertex_count);
+}
+
+const void *MeshCache::getIndices() const
+{
+    return file.getData() + header->index_offset;
+}
+
+std::size_t MeshCache::getIndexSize() const
+{
+    return static_cast<std::size_t>(header->index_size);
+}
+
+std::size_t MeshCache::getPositions() const
+{
+    return static_cast<std::size_t>(header->positions);
+}
+
+std::size_t MeshCache::getTriangles() const
+{
+    return static_cast<std::size_t>(header->triangles);
+}
+
+glm::vec3 MeshCache::getMin() const
+{
+    return glm::make_vec3(header->min);
+}
+
+glm::vec3 MeshCache::getMax() const
+{
+    return glm::make_vec3(header->max);
+}
+
+glm::mat4 MeshCache::getOriginMatrix() const
+{
+    return glm::make_mat4(header->origin_mat);
+}
+
+void MeshCache::getStatistics(float &acmr_before, float &acmr_after, float &atvr_before, float &atvr_after) const
+{
+    acmr_before = header->statistics[0];
+    acmr_after = header->statistics[1];
+    atvr_before = header->statistics[2];
+    atvr_after = header->statistics[3];
+}
+
+const std::vector<std::string> &MeshCache::getLibraries() const
+{
+    return library_stock;
+}
+
+const std::vector<MeshCache::Object> &MeshCache::getObjects() const
+{
+    return object_stock;
+}
+
+const std::vector<ModelData::Lod> &MeshCache::getLods() const
+{
+    return lod_stock;
+}
+
+const std::vector<ModelData::Cluster> &MeshCache::getClusters() const
+{
+    return cluster_stock;
+}
+
+MeshCache::~MeshCache() {}
+
+bool MeshCache::write(const std::string &path, const ModelData &model_data, const std::vector<std::string> &library_stock, const void *const vertices, const std::size_t &vertex_size, const std::size_t &vertex_count, const void *const indices, const std::size_t &index_size, const GLenum &options, const std::size_t &lod_levels)
+{
+    MeshCache::Header header;
+    std::memset(&header, 0, sizeof(MeshCache::Header));
+
+    if (!MeshCache::readStatus(path, header.source_size, header.source_time))
+    {
+        return false;
+    }
+
+    std::string data;
+
+    MeshCache::writeString(data, path);
+
+    for (const std::string &library : library_stock)
+    {
+        MeshCache::writeString(data, library);
+    }
+
+    for (const ModelData::Object *const object : model_data.object_stock)
+    {
+        const GLsizei offset = object->offset / ModelData::Object::getTypeSize(object->type);
+        data.append(reinterpret_cast<const char *>(&object->count), sizeof(GLsizei));
+        data.append(reinterpret_cast<const char *>(&offset), sizeof(GLsizei));
+        data.append(reinterpret_cast<const char *>(&object->type), sizeof(GLenum));
+        data.append(reinterpret_cast<const char *>(&object->base_vertex), sizeof(GLint));
+        MeshCache::writeString(data, object->material->getName());
+    }
+
+    for (const ModelData::Lod &lod : model_data.lod_stock)
+    {
+        const std::uint32_t first = static_cast<std::uint32_t>(lod.first);
+        const std::uint32_t last = static_cast<std::uint32_t>(lod.last);
+        const std::uint64_t triangles = static_cast<std::uint64_t>(lod.triangles);
+
+        data.append(reinterpret_cast<const char *>(&first), sizeof(std::uint32_t));
+        data.append(reinterpret_cast<const char *>(&last), sizeof(std::uint32_t));
+        data.append(reinterpret_cast<const char *>(&triangles), sizeof(std::uint64_t));
+        data.append(reinterpret_cast<const char *>(&lod.error), sizeof(float));
+    }
+
+    for (const ModelData::Cluster &cluster : model_data.cluster_stock)
+    {
+        const std::uint32_t object = static_cast<std::uint32_t>(cluster.object);
+
+        data.append(reinterpret_cast<const char *>(&object), sizeof(std::uint32_t));
+        data.append(reinterpret_cast<const char *>(&cluster.count), sizeof(GLsizei));
+        data.append(reinterpret_cast<const char *>(&cluster.offset), sizeof(GLsizei));
+        data.append(reinterpret_cast<const char *>(glm::value_ptr(cluster.center)), 3U * sizeof(float));
+        data.append(reinterpret_cast<const char *>(&cluster.radius), sizeof(float));
+        data.append(reinterpret_cast<const char *>(glm::value_ptr(cluster.cone_axis)), 3U * sizeof(float));
+        data.append(reinterpret_cast<const char *>(&cluster.cone_cutoff), sizeof(float));
+    }
+
+    const std::size_t vertex_bytes = vertex_size * vertex_count;
+    const std::size_t vertex_offset = (sizeof(MeshCache::Header) + data.size() + 15U) & ~static_cast<std::size_t>(15U);
+    const std::size_t index_offset = (vertex_offset + vertex_bytes + 15U) & ~static_cast<std::size_t>(15U);
+
+    std::memcpy(header.magic, MeshCache::MAGIC, sizeof(MeshCache::MAGIC));
+    header.version = MeshCache::VERSION;
+    header.vertex_size = static_cast<std::uint32_t>(vertex_size);
+    header.options = static_cast<std::uint32_t>(options);
+    header.lod_levels = static_cast<std::uint32_t>(lod_levels);
+    header.file_size = index_offset + index_size;
+    header.source_hash = MeshCache::hash(path);
+    header.positions = model_data.vertices;
+    header.triangles = model_data.triangles;
+    header.vertex_count = vertex_count;
+    header.index_size = index_size;
+    header.vertex_offset = vertex_offset;
+    header.index_offset = index_offset;
+    header.object_count = static_cast<std::uint32_t>(model_data.object_stock.size());
+    header.library_count = static_cast<std::uint32_t>(library_stock.size());
+    header.lod_count = static_cast<std::uint32_t>(model_data.lod_stock.size());
+    header.cluster_count = static_cast<std::uint32_t>(model_data.cluster_stock.size());
+    std::memcpy(header.min, glm::value_ptr(model_data.min), sizeof(header.min));
+    std::memcpy(header.max, glm::value_ptr(model_data.max), sizeof(header.max));
+    std::memcpy(header.origin_mat, glm::value_ptr(model_data.origin_mat), sizeof(header.origin_mat));
+    header.statistics[0] = model_data.acmr_before;
+    header.statistics[1] = model_data.acmr_after;
+    header.statistics[2] = model_data.atvr_before;
+    header.statistics[3] = model_data.atvr_after;
+
+    std::ofstream file(path + MeshCache::EXTENSION, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "warning: could not write the mesh cache `" << path << MeshCache::EXTENSION << "'" << std::endl;
+        return false;
+    }
+
+    static const char padding[16] = {};
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(MeshCache::Header));
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    file.write(padding, static_cast<std::streamsize>(vertex_offset - sizeof(MeshCache::Header) - data.size()));
+    file.write(static_cast<const char *>(vertices), static_cast<std::streamsize>(vertex_bytes));
+    file.write(padding, static_cast<std::streamsize>(index_offset - vertex_offset - vertex_bytes));
+    file.write(static_cast<const char *>(indices), static_cast<std::streamsize>(index_size));
+
+    return file.good();
+}
+
+bool MeshCache::isEnabled()
+{
+    return MeshCache::enabled;
+}
+
+std::string MeshCache::getExtension()
+{
+    return MeshCache::EXTENSION;
+}
+
+void MeshCache::setEnabled(const bool &status)
+{
+    MeshCache::enabled = status;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef __MESH_CACHE_HPP_
+#define __MESH_CACHE_HPP_
+#include "mappedfile.hpp"
+#include "modeldata.hpp"
+#include "../../glad/glad.h"
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Binary copy of a loaded model stored next to the source file, read back through a memory mapping */
+class MeshCache
+{
+public:
+    /** Index range drawn with a material, the offset counts indices of its type */
+    struct Object
+    {
+        GLsizei count;
+        GLsizei offset;
+        GLenum type;
+        GLint base_vertex;
+        std::string material;
+    };
+
+private:
+    /** File header, followed by the source path, the material libraries, the objects, the levels of detail, the clusters, the vertices and the indices */
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t vertex_size;
+        std::uint32_t options;
+        std::uint32_t lod_levels;
+        std::uint64_t file_size;
+        std::uint64_t source_size;
+        std::int64_t source_time;
+        std::uint64_t source_hash;
+        std::uint64_t positions;
+        std::uint64_t triangles;
+        std::uint64_t vertex_count;
+        std::uint64_t index_size;
+        std::uint64_t vertex_offset;
+        std::uint64_t index_offset;
+        std::uint32_t object_count;
+        std::uint32_t library_count;
+        std::uint32_t lod_count;
+        std::uint32_t cluster_count;
+        float min[3];
+        float max[3];
+        float origin_mat[16];
+        float statistics[4];
+    };
+
+    MappedFile file;
+    const MeshCache::Header *header;
+    std::vector<std::string> library_stock;
+    std::vector<MeshCache::Object> object_stock;
+    std::vector<ModelData::Lod> lod_stock;
+    std::vector<ModelData::Cluster> cluster_stock;
+    bool valid;
+
+    static bool enabled;
+    static const char MAGIC[8];
+    static const std::uint32_t VERSION;
+    static const std::string EXTENSION;
+
+    MeshCache() = delete;
+    MeshCache(const MeshCache &) = delete;
+    MeshCache &operator=(const MeshCache &) = delete;
+    bool validate(const std::string &path, const std::size_t &vertex_size, const GLenum &options, const std::size_t &lod_levels);
+    static bool readString(const char *&cursor, const char *const end, std::string &str);
+    static void writeString(std::string &data, const std::string &str);
+    static bool readStatus(const std::string &path, std::uint64_t &size, std::int64_t &time);
+    static std::uint64_t hash(const std::string &path);
+
+public:
+    MeshCache(const std::string &path, const std::size_t &vertex_size, const GLenum &options, const std::size_t &lod_levels);
+    bool isValid() const;
+    const void *getVertices() const;
+    std::size_t getVertexCount() const;
+    const void *getIndices() const;
+    std::size_t getIndexSize() const;
+    std::size_t getPositions() const;
+    std::size_t getTriangles() const;
+    glm::vec3 getMin() const;
+    glm::vec3 getMax() const;
+    glm::mat4 getOriginMatrix() const;
+    void getStatistics(float &acmr_before, float &acmr_after, float &atvr_before, float &atvr_after) const;
+    const std::vector<std::string> &getLibraries() const;
+    const std::vector<MeshCache::Object> &getObjects() const;
+    const std::vector<ModelData::Lod> &getLods() const;
+    const std::vector<ModelData::Cluster> &getClusters() const;
+    virtual ~MeshCache();
+
+    static bool write(const std::string &path, const ModelData &model_data, const std::vector<std::string> &library_stock, const void *const vertices, const std::size_t &vertex_size, const std::size_t &vertex_count, const void *const indices, const std::size_t &index_size, const GLenum &options, const std::size_t &lod_levels);
+    static bool isEnabled();
+    static std::string getExtension();
+    static void setEnabled(const bool &status);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,581 @@
+#include "meshoptimizer.hpp"
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+const std::size_t MeshOptimizer::CACHE_SIZE = 16U;
+const std::size_t MeshOptimizer::CLUSTER_SIZE = 128U;
+const float MeshOptimizer::OVERDRAW_THRESHOLD = 1.05F;
+const float MeshOptimizer::CLUSTER_CONE = 0.5F;
+
+/**
+ * Tipsify (Sander, Nehab and Barczak, 2007): fans triangles around the vertex most likely to still be in the cache.
+ * Every time the fanning has to restart from a dead end the cache is considered flushed, those positions are stored
+ * in `cluster_stock' (in triangles) as boundaries the overdraw pass can reorder without hurting the cache.
+ */
+void MeshOptimizer::optimizeVertexCache(GLsizei *const indices, const std::size_t &count, std::vector<std::size_t> &cluster_stock)
+{
+    const std::size_t triangles = count / 3U;
+    cluster_stock.clear();
+
+    if (triangles == 0U)
+    {
+        return;
+    }
+
+    // Local vertex numbering so the tables only cover the vertices of this range
+    std::vector<GLsizei> unique_stock(indices, indices + 3U * triangles);
+    std::sort(unique_stock.begin(), unique_stock.end());
+    unique_stock.erase(std::unique(unique_stock.begin(), unique_stock.end()), unique_stock.end());
+
+    const std::size_t vertices = unique_stock.size();
+    std::vector<GLsizei> local(3U * triangles);
+
+    for (std::size_t i = 0U; i < local.size(); i++)
+    {
+        local[i] = static_cast<GLsizei>(std::lower_bound(unique_stock.begin(), unique_stock.end(), indices[i]) - unique_stock.begin());
+    }
+
+    // Triangles around every vertex
+    std::vector<std::size_t> offset(vertices + 1U, 0U);
+    for (const GLsizei vertex : local)
+    {
+        offset[vertex + 1U]++;
+    }
+
+    std::vector<GLsizei> live(vertices);
+    for (std::size_t i = 0U; i < vertices; i++)
+    {
+        live[i] = static_cast<GLsizei>(offset[i + 1U]);
+        offset[i + 1U] += offset[i];
+    }
+
+    std::vector<std::size_t> adjacency(local.size());
+    std::vector<std::size_t> cursor(offset.begin(), offset.end() - 1);
+    for (std::size_t i = 0U; i < local.size(); i++)
+    {
+        adjacency[cursor[local[i]]++] = i / 3U;
+    }
+
+    std::vector<std::size_t> stamp(vertices, 0U);
+    std::vector<bool> emitted(triangles, false);
+    std::vector<GLsizei> dead_end_stock;
+    std::vector<GLsizei> candidate_stock;
+    std::vector<GLsizei> output;
+    output.reserve(local.size());
+
+    std::size_t time = MeshOptimizer::CACHE_SIZE + 1U;
+    std::size_t scan = 0U;
+    GLsizei fan = local[0];
+
+    cluster_stock.emplace_back(0U);
+
+    while (fan >= 0)
+    {
+        candidate_stock.clear();
+
+        for (std::size_t i = offset[fan]; i < offset[fan + 1U]; i++)
+        {
+            const std::size_t triangle = adjacency[i];
+
+            if (emitted[triangle])
+            {
+                continue;
+            }
+
+            emitted[triangle] = true;
+
+            for (std::size_t j = 0U; j < 3U; j++)
+            {
+                const GLsizei vertex = local[3U * triangle + j];
+
+                output.emplace_back(vertex);
+                dead_end_stock.emplace_back(vertex);
+                candidate_stock.emplace_back(vertex);
+                live[vertex]--;
+
+                if ((time - stamp[vertex]) > MeshOptimizer::CACHE_SIZE)
+                {
+                    stamp[vertex] = time++;
+                }
+            }
+        }
+
+        // Prefer the oldest vertex in the cache that will still be in it after fanning all its triangles
+        GLsizei next = -1;
+        long long best = -1;
+
+        for (const GLsizei vertex : candidate_stock)
+        {
+            if (live[vertex] <= 0)
+            {
+                continue;
+            }
+
+            long long priority = 0;
+            if ((time - stamp[vertex] + 2U * static_cast<std::size_t>(live[vertex])) <= MeshOptimizer::CACHE_SIZE)
+            {
+                priority = static_cast<long long>(time - stamp[vertex]);
+            }
+
+            if (priority > best)
+            {
+                best = priority;
+                next = vertex;
+            }
+        }
+
+        if (next < 0)
+        {
+            while (!dead_end_stock.empty() && (next < 0))
+            {
+                if (live[dead_end_stock.back()] > 0)
+                {
+                    next = dead_end_stock.back();
+                }
+
+                dead_end_stock.pop_back();
+            }
+
+            for (; (next < 0) && (scan < vertices); scan++)
+            {
+                if (live[scan] > 0)
+                {
+                    next = static_cast<GLsizei>(scan);
+                }
+            }
+
+            if ((next >= 0) && (cluster_stock.back() != output.size() / 3U))
+            {
+                cluster_stock.emplace_back(output.size() / 3U);
+            }
+        }
+
+        fan = next;
+    }
+
+    for (std::size_t i = 0U; i < output.size(); i++)
+    {
+        indices[i] = unique_stock[output[i]];
+    }
+}
+
+/**
+ * Joins consecutive clusters until each one, drawn after a cache flush, misses at most `OVERDRAW_THRESHOLD'
+ * times as often as the whole range. Dead ends are frequent and sorting tiny clusters would undo most of the cache order.
+ */
+std::vector<std::size_t> MeshOptimizer::mergeClusters(const GLsizei *const indices, const std::size_t &triangles, const std::vector<std::size_t> &cluster_stock)
+{
+    const std::size_t vertex_count = static_cast<std::size_t>(*std::max_element(indices, indices + 3U * triangles)) + 1U;
+
+    float acmr;
+    float atvr;
+    MeshOptimizer::analyze(indices, 3U * triangles, vertex_count, acmr, atvr);
+
+    std::vector<std::size_t> merged_stock(1U, 0U);
+    std::vector<std::size_t> stamp(vertex_count, 0U);
+    std::size_t time = MeshOptimizer::CACHE_SIZE + 1U;
+    std::size_t misses = 0U;
+
+    for (std::size_t cluster = 0U; cluster < cluster_stock.size(); cluster++)
+    {
+        const std::size_t last = cluster + 1U < cluster_stock.size() ? cluster_stock[cluster + 1U] : triangles;
+
+        for (std::size_t i = 3U * cluster_stock[cluster]; i < 3U * last; i++)
+        {
+            const std::size_t vertex = static_cast<std::size_t>(indices[i]);
+
+            if ((time - stamp[vertex]) > MeshOptimizer::CACHE_SIZE)
+            {
+                stamp[vertex] = time++;
+                misses++;
+            }
+        }
+
+        if ((last < triangles) && (static_cast<float>(misses) <= MeshOptimizer::OVERDRAW_THRESHOLD * acmr * static_cast<float>(last - merged_stock.back())))
+        {
+            merged_stock.emplace_back(last);
+            time += MeshOptimizer::CACHE_SIZE + 1U;
+            misses = 0U;
+        }
+    }
+
+    return merged_stock;
+}
+
+/**
+ * Sorts the clusters found by the cache optimization so the ones facing away from the center are drawn first,
+ * they are the most likely to occlude the rest of the mesh. Vertices start with their position as three floats.
+ */
+void MeshOptimizer::optimizeOverdraw(GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, const std::vector<std::size_t> &cluster_stock)
+{
+    const std::size_t triangles = count / 3U;
+
+    if (cluster_stock.size() < 2U)
+    {
+        return;
+    }
+
+    const std::vector<std::size_t> merged_stock = MeshOptimizer::mergeClusters(indices, triangles, cluster_stock);
+    const std::size_t clusters = merged_stock.size();
+
+    const char *const data = static_cast<const char *>(vertices);
+    std::vector<glm::vec3> centroid_stock(clusters, glm::vec3(0.0F));
+    std::vector<glm::vec3> normal_stock(clusters, glm::vec3(0.0F));
+    std::vector<float> area_stock(clusters, 0.0F);
+    glm::vec3 center(0.0F);
+    float total_area = 0.0F;
+
+    for (std::size_t cluster = 0U; cluster < clusters; cluster++)
+    {
+        const std::size_t last = cluster + 1U < clusters ? merged_stock[cluster + 1U] : triangles;
+
+        for (std::size_t triangle = merged_stock[cluster]; triangle < last; triangle++)
+        {
+            glm::vec3 position[3];
+
+            for (std::size_t i = 0U; i < 3U; i++)
+            {
+                std::memcpy(&position[i], data + stride * static_cast<std::size_t>(indices[3U * triangle + i]), sizeof(glm::vec3));
+            }
+
+            const glm::vec3 normal = glm::cross(position[1] - position[0], position[2] - position[0]);
+            const float area = glm::length(normal);
+
+            centroid_stock[cluster] += (position[0] + position[1] + position[2]) * (area / 3.0F);
+            normal_stock[cluster] += normal;
+            area_stock[cluster] += area;
+        }
+
+        center += centroid_stock[cluster];
+        total_area += area_stock[cluster];
+    }
+
+    if (total_area <= 0.0F)
+    {
+        return;
+    }
+
+    center /= total_area;
+
+    std::vector<float> key_stock(clusters, 0.0F);
+    std::vector<std::size_t> order(clusters);
+
+    for (std::size_t cluster = 0U; cluster < clusters; cluster++)
+    {
+        order[cluster] = cluster;
+
+        const float length = glm::length(normal_stock[cluster]);
+        if ((area_stock[cluster] > 0.0F) && (length > 0.0F))
+        {
+            key_stock[cluster] = glm::dot(centroid_stock[cluster] / area_stock[cluster] - center, normal_stock[cluster] / length);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&key_stock](const std::size_t &a, const std::size_t &b) { return key_stock[a] > key_stock[b]; });
+
+    std::vector<GLsizei> source(indices, indices + 3U * triangles);
+    GLsizei *destination = indices;
+
+    for (const std::size_t cluster : order)
+    {
+        const std::size_t first = merged_stock[cluster];
+        const std::size_t last = cluster + 1U < clusters ? merged_stock[cluster + 1U] : triangles;
+
+        destination = std::copy(source.begin() + 3U * first, source.begin() + 3U * last, destination);
+    }
+}
+
+/** Renumbers the vertices in the order they are first used, returns the new index of every old vertex */
+std::vector<GLsizei> MeshOptimizer::optimizeVertexFetch(GLsizei *const indices, const std::size_t &count, const std::size_t &vertex_count)
+{
+    std::vector<GLsizei> remap(vertex_count, -1);
+    GLsizei next = 0;
+
+    for (std::size_t i = 0U; i < count; i++)
+    {
+        GLsizei &vertex = remap[indices[i]];
+
+        if (vertex < 0)
+        {
+            vertex = next++;
+        }
+
+        indices[i] = vertex;
+    }
+
+    // Unused vertices are kept at the end
+    for (GLsizei &vertex : remap)
+    {
+        if (vertex < 0)
+        {
+            vertex = next++;
+        }
+    }
+
+    return remap;
+}
+
+/**
+ * Regroups the triangles into clusters of at most `CLUSTER_SIZE' connected triangles facing roughly the same way,
+ * grown breadth first from the first free triangle. The start of every cluster (in triangles) is stored in `cluster_stock'.
+ */
+void MeshOptimizer::buildClusters(GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, std::vector<std::size_t> &cluster_stock)
+{
+    const std::size_t triangles = count / 3U;
+    cluster_stock.clear();
+
+    if (triangles == 0U)
+    {
+        return;
+    }
+
+    const char *const data = static_cast<const char *>(vertices);
+
+    // Local vertex numbering, welded by position so the clusters grow across the UV and normal seams
+    const std::pair<const GLsizei *, const GLsizei *> bounds = std::minmax_element(indices, indices + 3U * triangles);
+    std::vector<GLsizei> remap(static_cast<std::size_t>(*bounds.second - *bounds.first) + 1U, -1);
+    std::vector<std::pair<glm::vec3, GLsizei>> position_stock;
+
+    for (std::size_t i = 0U; i < 3U * triangles; i++)
+    {
+        GLsizei &vertex = remap[indices[i] - *bounds.first];
+
+        if (vertex < 0)
+        {
+            vertex = static_cast<GLsizei>(position_stock.size());
+            position_stock.emplace_back(glm::vec3(0.0F), vertex);
+            std::memcpy(&position_stock.back().first, data + stride * static_cast<std::size_t>(indices[i]), sizeof(glm::vec3));
+        }
+    }
+
+    std::sort(position_stock.begin(), position_stock.end(), [](const std::pair<glm::vec3, GLsizei> &a, const std::pair<glm::vec3, GLsizei> &b) {
+        return (a.first.x < b.first.x) || ((a.first.x == b.first.x) && ((a.first.y < b.first.y) || ((a.first.y == b.first.y) && (a.first.z < b.first.z))));
+    });
+
+    std::vector<GLsizei> group(position_stock.size());
+    std::size_t vertex_count = 0U;
+
+    for (std::size_t i = 0U; i < position_stock.size(); i++)
+    {
+        if ((i > 0U) && (position_stock[i].first != position_stock[i - 1U].first))
+        {
+            vertex_count++;
+        }
+
+        group[position_stock[i].second] = static_cast<GLsizei>(vertex_count);
+    }
+
+    vertex_count++;
+    std::vector<GLsizei> local(3U * triangles);
+
+    for (std::size_t i = 0U; i < local.size(); i++)
+    {
+        local[i] = group[remap[indices[i] - *bounds.first]];
+    }
+
+    // Triangles around every vertex
+    std::vector<std::size_t> offset(vertex_count + 1U, 0U);
+    for (const GLsizei vertex : local)
+    {
+        offset[vertex + 1U]++;
+    }
+
+    for (std::size_t i = 0U; i < vertex_count; i++)
+    {
+        offset[i + 1U] += offset[i];
+    }
+
+    std::vector<std::size_t> adjacency(local.size());
+    std::vector<std::size_t> cursor(offset.begin(), offset.end() - 1);
+    for (std::size_t i = 0U; i < local.size(); i++)
+    {
+        adjacency[cursor[local[i]]++] = i / 3U;
+    }
+
+    std::vector<glm::vec3> normal_stock(triangles);
+
+    for (std::size_t triangle = 0U; triangle < triangles; triangle++)
+    {
+        glm::vec3 position[3];
+
+        for (std::size_t i = 0U; i < 3U; i++)
+        {
+            std::memcpy(&position[i], data + stride * static_cast<std::size_t>(indices[3U * triangle + i]), sizeof(glm::vec3));
+        }
+
+        const glm::vec3 normal = glm::cross(position[1] - position[0], position[2] - position[0]);
+        const float length = glm::length(normal);
+        normal_stock[triangle] = length > 0.0F ? normal / length : glm::vec3(0.0F);
+    }
+
+    // Triangles queued for the current cluster are stamped with its number so they are queued only once
+    std::vector<bool> assigned(triangles, false);
+    std::vector<std::size_t> stamp(triangles, SIZE_MAX);
+    std::vector<GLsizei> output;
+    std::vector<std::size_t> queue;
+    std::size_t next = 0U;
+    output.reserve(3U * triangles);
+
+    while (output.size() < 3U * triangles)
+    {
+        // The next cluster starts on the border of the last one so no scattered leftovers remain
+        std::size_t seed = triangles;
+        for (const std::size_t triangle : queue)
+        {
+            if (!assigned[triangle])
+            {
+                seed = triangle;
+                break;
+            }
+        }
+
+        if (seed == triangles)
+        {
+            while (assigned[next])
+            {
+                next++;
+            }
+
+            seed = next;
+        }
+
+        const std::size_t cluster = cluster_stock.size();
+        glm::vec3 normal(0.0F);
+        glm::vec3 axis(0.0F);
+        std::size_t size = 0U;
+
+        cluster_stock.emplace_back(output.size() / 3U);
+        queue.assign(1U, seed);
+        stamp[seed] = cluster;
+
+        for (std::size_t head = 0U; (head < queue.size()) && (size < MeshOptimizer::CLUSTER_SIZE); head++)
+        {
+            const std::size_t triangle = queue[head];
+
+            // Triangles more than sixty degrees away from the cluster are left for another one, keeping the normal cone
+            // narrow. Degenerate triangles, and any triangle while the cluster has no direction yet, always fit
+            if (glm::dot(normal_stock[triangle], axis) < MeshOptimizer::CLUSTER_CONE * glm::length(normal_stock[triangle]) * glm::length(axis))
+            {
+                continue;
+            }
+
+            assigned[triangle] = true;
+            normal += normal_stock[triangle];
+            axis = glm::length(normal) > 0.0F ? glm::normalize(normal) : glm::vec3(0.0F);
+            size++;
+
+            for (std::size_t i = 0U; i < 3U; i++)
+            {
+                const GLsizei vertex = local[3U * triangle + i];
+                output.emplace_back(indices[3U * triangle + i]);
+
+                for (std::size_t j = offset[vertex]; j < offset[vertex + 1U]; j++)
+                {
+                    if (!assigned[adjacency[j]] && (stamp[adjacency[j]] != cluster))
+                    {
+                        stamp[adjacency[j]] = cluster;
+                        queue.emplace_back(adjacency[j]);
+                    }
+                }
+            }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+/**
+ * Bounding sphere and normal cone of a cluster. The cone cutoff is the sine of its half angle, or one when
+ * the triangles spread too much for the cone to cull anything.
+ */
+void MeshOptimizer::computeBounds(const GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, glm::vec3 &center, float &radius, glm::vec3 &cone_axis, float &cone_cutoff)
+{
+    const char *const data = static_cast<const char *>(vertices);
+    std::vector<glm::vec3> position(count);
+    glm::vec3 min(INFINITY);
+    glm::vec3 max(-INFINITY);
+
+    for (std::size_t i = 0U; i < count; i++)
+    {
+        std::memcpy(&position[i], data + stride * static_cast<std::size_t>(indices[i]), sizeof(glm::vec3));
+        min = glm::min(min, position[i]);
+        max = glm::max(max, position[i]);
+    }
+
+    center = count == 0U ? glm::vec3(0.0F) : (min + max) / 2.0F;
+    radius = 0.0F;
+    cone_axis = glm::vec3(0.0F);
+
+    for (std::size_t i = 0U; i < count; i++)
+    {
+        radius = std::max(radius, glm::length(position[i] - center));
+    }
+
+    std::vector<glm::vec3> normal_stock;
+    for (std::size_t i = 0U; i + 2U < count; i += 3U)
+    {
+        const glm::vec3 normal = glm::cross(position[i + 1U] - position[i], position[i + 2U] - position[i]);
+        const float length = glm::length(normal);
+
+        if (length > 0.0F)
+        {
+            normal_stock.emplace_back(normal / length);
+            cone_axis += normal_stock.back();
+        }
+    }
+
+    const float length = glm::length(cone_axis);
+    cone_cutoff = 1.0F;
+
+    if (!(length > 0.0F))
+    {
+        return;
+    }
+
+    cone_axis /= length;
+
+    float min_dot = 1.0F;
+    for (const glm::vec3 &normal : normal_stock)
+    {
+        min_dot = std::min(min_dot, glm::dot(normal, cone_axis));
+    }
+
+    if (min_dot > 0.1F)
+    {
+        cone_cutoff = std::sqrt(1.0F - min_dot * min_dot);
+    }
+}
+
+/** Average cache miss ratio (per triangle) and average transformed vertex ratio (per used vertex) of a FIFO cache */
+void MeshOptimizer::analyze(const GLsizei *const indices, const std::size_t &count, const std::size_t &vertex_count, float &acmr, float &atvr)
+{
+    std::vector<std::size_t> stamp(vertex_count, 0U);
+    std::vector<bool> used(vertex_count, false);
+    std::size_t time = MeshOptimizer::CACHE_SIZE + 1U;
+    std::size_t misses = 0U;
+    std::size_t vertices = 0U;
+
+    for (std::size_t i = 0U; i < count; i++)
+    {
+        const std::size_t vertex = static_cast<std::size_t>(indices[i]);
+
+        if ((time - stamp[vertex]) > MeshOptimizer::CACHE_SIZE)
+        {
+            stamp[vertex] = time++;
+            misses++;
+        }
+
+        if (!used[vertex])
+        {
+            used[vertex] = true;
+            vertices++;
+        }
+    }
+
+    acmr = count < 3U ? 0.0F : static_cast<float>(misses) / static_cast<float>(count / 3U);
+    atvr = vertices == 0U ? 0.0F : static_cast<float>(misses) / static_cast<float>(vertices);
+}
\ No newline at end of file
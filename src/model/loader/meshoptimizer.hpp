@@ -0,0 +1,30 @@
+#ifndef __MESH_OPTIMIZER_HPP_
+#define __MESH_OPTIMIZER_HPP_
+#include "../../glad/glad.h"
+#include <glm/vec3.hpp>
+#include <cstddef>
+#include <vector>
+
+/** Triangle and vertex reordering for the post-transform cache, overdraw and vertex fetch */
+class MeshOptimizer
+{
+private:
+    MeshOptimizer() = delete;
+    MeshOptimizer(const MeshOptimizer &) = delete;
+    MeshOptimizer &operator=(const MeshOptimizer &) = delete;
+    static const float OVERDRAW_THRESHOLD;
+    static const float CLUSTER_CONE;
+    static std::vector<std::size_t> mergeClusters(const GLsizei *const indices, const std::size_t &triangles, const std::vector<std::size_t> &cluster_stock);
+
+public:
+    static const std::size_t CACHE_SIZE;
+    static const std::size_t CLUSTER_SIZE;
+    static void optimizeVertexCache(GLsizei *const indices, const std::size_t &count, std::vector<std::size_t> &cluster_stock);
+    static void optimizeOverdraw(GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, const std::vector<std::size_t> &cluster_stock);
+    static std::vector<GLsizei> optimizeVertexFetch(GLsizei *const indices, const std::size_t &count, const std::size_t &vertex_count);
+    static void buildClusters(GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, std::vector<std::size_t> &cluster_stock);
+    static void computeBounds(const GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, glm::vec3 &center, float &radius, glm::vec3 &cone_axis, float &cone_cutoff);
+    static void analyze(const GLsizei *const indices, const std::size_t &count, const std::size_t &vertex_count, float &acmr, float &atvr);
+};
+
+#endif
\ No newline at end of file
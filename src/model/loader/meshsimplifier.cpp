@@ -0,0 +1,418 @@
+#include "meshsimplifier.hpp"
+#include <glm/geometric.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/vec3.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+MeshSimplifier::Quadric::Quadric() : a{0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+                                     b{0.0, 0.0, 0.0},
+                                     c(0.0),
+                                     weight(0.0) {}
+
+void MeshSimplifier::Quadric::add(const MeshSimplifier::Quadric &other)
+{
+    for (std::size_t i = 0U; i < 6U; i++)
+    {
+        a[i] += other.a[i];
+    }
+
+    for (std::size_t i = 0U; i < 3U; i++)
+    {
+        b[i] += other.b[i];
+    }
+
+    c += other.c;
+    weight += other.weight;
+}
+
+/** Root mean squared distance of a position to the planes */
+float MeshSimplifier::Quadric::error(const float *const position) const
+{
+    if (weight <= 0.0)
+    {
+        return 0.0F;
+    }
+
+    const double x = position[0];
+    const double y = position[1];
+    const double z = position[2];
+
+    const double value = a[0] * x * x + a[3] * y * y + a[5] * z * z + 2.0 * (a[1] * x * y + a[2] * x * z + a[4] * y * z) +
+                         2.0 * (b[0] * x + b[1] * y + b[2] * z) + c;
+
+    return static_cast<float>(std::sqrt(std::max(value, 0.0) / weight));
+}
+
+/**
+ * Pairs each wedge of a group, the vertices sharing its position, with the single wedge of the target group it has an
+ * edge to. Fails when a wedge still in use has no such edge or more than one, or two wedges would meet, since the
+ * seam would open. Wedges left without triangles are skipped.
+ */
+bool MeshSimplifier::matches(const std::vector<GLsizei> &indices, const std::vector<std::size_t> &offset, const std::vector<std::size_t> &adjacency, const std::vector<GLsizei> &group, const GLsizei *const wedge, const std::size_t &wedges, const GLsizei &target, std::vector<std::pair<GLsizei, GLsizei>> &collapse_stock)
+{
+    collapse_stock.clear();
+
+    for (std::size_t i = 0U; i < wedges; i++)
+    {
+        const GLsizei vertex = wedge[i];
+        GLsizei found = -1;
+
+        for (std::size_t j = offset[vertex]; j < offset[vertex + 1U]; j++)
+        {
+            for (std::size_t k = 0U; k < 3U; k++)
+            {
+                const GLsizei other = indices[3U * adjacency[j] + k];
+
+                if (group[other] != target)
+                {
+                    continue;
+                }
+
+                if ((found >= 0) && (found != other))
+                {
+                    return false;
+                }
+
+                found = other;
+            }
+        }
+
+        if (offset[vertex] == offset[vertex + 1U])
+        {
+            continue;
+        }
+
+        if (found < 0)
+        {
+            return false;
+        }
+
+        for (const std::pair<GLsizei, GLsizei> &collapse : collapse_stock)
+        {
+            if (collapse.second == found)
+            {
+                return false;
+            }
+        }
+
+        collapse_stock.emplace_back(vertex, found);
+    }
+
+    return !collapse_stock.empty();
+}
+
+/** Checks if moving a vertex onto the target turns any of its remaining triangles over */
+bool MeshSimplifier::flips(const std::vector<GLsizei> &indices, const std::vector<std::size_t> &offset, const std::vector<std::size_t> &adjacency, const std::vector<float> &position, const GLsizei &vertex, const GLsizei &target)
+{
+    const glm::vec3 moved = glm::make_vec3(&position[3U * static_cast<std::size_t>(target)]);
+
+    for (std::size_t i = offset[vertex]; i < offset[vertex + 1U]; i++)
+    {
+        const GLsizei *const face = &indices[3U * adjacency[i]];
+
+        if ((face[0] == target) || (face[1] == target) || (face[2] == target))
+        {
+            continue;
+        }
+
+        glm::vec3 before[3];
+        glm::vec3 after[3];
+
+        for (std::size_t j = 0U; j < 3U; j++)
+        {
+            before[j] = glm::make_vec3(&position[3U * static_cast<std::size_t>(face[j])]);
+            after[j] = face[j] == vertex ? moved : before[j];
+        }
+
+        const glm::vec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+        const glm::vec3 normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+        if (glm::dot(normal_before, normal_after) <= 0.0F)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Collapses vertices onto one of their neighbours in passes, cheapest quadric error first, until the index count
+ * reaches the target or nothing else can collapse. No vertex is created, so the result indexes the same buffer.
+ * Vertices on a border or on a non manifold edge never move. Vertices sharing their position (a UV or normal seam)
+ * collapse together, each along its own edge to the same target position, so the seam stays closed. `error'
+ * receives the largest error of the collapses, in the units of the positions.
+ */
+std::vector<GLsizei> MeshSimplifier::simplify(const GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, const std::size_t &target_count, float &error)
+{
+    const std::size_t triangles = count / 3U;
+    error = 0.0F;
+
+    // Local vertex numbering so the tables only cover the vertices of this range
+    std::vector<GLsizei> unique_stock(indices, indices + 3U * triangles);
+    std::sort(unique_stock.begin(), unique_stock.end());
+    unique_stock.erase(std::unique(unique_stock.begin(), unique_stock.end()), unique_stock.end());
+
+    const std::size_t vertex_count = unique_stock.size();
+    std::vector<GLsizei> result(3U * triangles);
+    std::vector<float> position(3U * vertex_count);
+
+    for (std::size_t i = 0U; i < result.size(); i++)
+    {
+        result[i] = static_cast<GLsizei>(std::lower_bound(unique_stock.begin(), unique_stock.end(), indices[i]) - unique_stock.begin());
+    }
+
+    for (std::size_t i = 0U; i < vertex_count; i++)
+    {
+        std::memcpy(&position[3U * i], static_cast<const char *>(vertices) + stride * static_cast<std::size_t>(unique_stock[i]), 3U * sizeof(float));
+    }
+
+    // Vertices sharing a position are the wedges of a group, the groups with more than one wedge lie on a seam
+    std::vector<GLsizei> order(vertex_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&position](const GLsizei &a, const GLsizei &b) {
+        return std::lexicographical_compare(&position[3U * a], &position[3U * a + 3U], &position[3U * b], &position[3U * b + 3U]);
+    });
+
+    std::vector<GLsizei> group(vertex_count);
+    std::vector<std::size_t> wedge_first(vertex_count, 0U);
+    std::vector<std::size_t> wedge_count(vertex_count, 0U);
+
+    for (std::size_t first = 0U, last = 0U; first < vertex_count; first = last)
+    {
+        for (last = first + 1U; (last < vertex_count) && std::equal(&position[3U * order[first]], &position[3U * order[first] + 3U], &position[3U * order[last]]); last++)
+        {
+        }
+
+        wedge_first[order[first]] = first;
+        wedge_count[order[first]] = last - first;
+
+        for (std::size_t i = first; i < last; i++)
+        {
+            group[order[i]] = order[first];
+        }
+    }
+
+    // Edges used by one triangle (borders) or more than two are kept as well
+    std::vector<std::pair<GLsizei, GLsizei>> edge_stock;
+    edge_stock.reserve(result.size());
+
+    for (std::size_t i = 0U; i < result.size(); i++)
+    {
+        const GLsizei a = group[result[i]];
+        const GLsizei b = group[result[i % 3U == 2U ? i - 2U : i + 1U]];
+
+        edge_stock.emplace_back(std::min(a, b), std::max(a, b));
+    }
+
+    std::sort(edge_stock.begin(), edge_stock.end());
+
+    std::vector<bool> locked_group(vertex_count, false);
+    for (std::size_t first = 0U, last = 0U; first < edge_stock.size(); first = last)
+    {
+        for (last = first + 1U; (last < edge_stock.size()) && (edge_stock[last] == edge_stock[first]); last++)
+        {
+        }
+
+        if ((last - first) != 2U)
+        {
+            locked_group[edge_stock[first].first] = true;
+            locked_group[edge_stock[first].second] = true;
+        }
+    }
+
+    // The quadrics, costs and targets belong to the groups, each one kept by its first wedge
+    std::vector<MeshSimplifier::Quadric> quadric(vertex_count);
+
+    for (std::size_t i = 0U; i < result.size(); i += 3U)
+    {
+        const glm::vec3 p0 = glm::make_vec3(&position[3U * result[i]]);
+        const glm::vec3 p1 = glm::make_vec3(&position[3U * result[i + 1U]]);
+        const glm::vec3 p2 = glm::make_vec3(&position[3U * result[i + 2U]]);
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const float length = glm::length(normal);
+
+        if (!(length > 0.0F))
+        {
+            continue;
+        }
+
+        normal /= length;
+
+        const double weight = 0.5 * length;
+        const double distance = -glm::dot(normal, p0);
+        MeshSimplifier::Quadric plane;
+
+        plane.a[0] = weight * normal.x * normal.x;
+        plane.a[1] = weight * normal.x * normal.y;
+        plane.a[2] = weight * normal.x * normal.z;
+        plane.a[3] = weight * normal.y * normal.y;
+        plane.a[4] = weight * normal.y * normal.z;
+        plane.a[5] = weight * normal.z * normal.z;
+        plane.b[0] = weight * distance * normal.x;
+        plane.b[1] = weight * distance * normal.y;
+        plane.b[2] = weight * distance * normal.z;
+        plane.c = weight * distance * distance;
+        plane.weight = weight;
+
+        for (std::size_t j = 0U; j < 3U; j++)
+        {
+            quadric[group[result[i + j]]].add(plane);
+        }
+    }
+
+    std::vector<std::size_t> offset;
+    std::vector<std::size_t> adjacency;
+    std::vector<float> cost;
+    std::vector<GLsizei> target;
+    std::vector<GLsizei> candidate_stock;
+    std::vector<GLsizei> remap(vertex_count);
+    std::vector<bool> touched;
+    std::vector<std::pair<GLsizei, GLsizei>> collapse_stock;
+
+    while (result.size() > target_count)
+    {
+        // Triangles around every vertex
+        offset.assign(vertex_count + 1U, 0U);
+        for (const GLsizei vertex : result)
+        {
+            offset[vertex + 1U]++;
+        }
+
+        std::partial_sum(offset.begin(), offset.end(), offset.begin());
+
+        std::vector<std::size_t> cursor(offset.begin(), offset.end() - 1);
+        adjacency.resize(result.size());
+        for (std::size_t i = 0U; i < result.size(); i++)
+        {
+            adjacency[cursor[result[i]]++] = i / 3U;
+        }
+
+        // Cheapest edge every free group can collapse along
+        cost.assign(vertex_count, FLT_MAX);
+        target.assign(vertex_count, -1);
+
+        for (std::size_t i = 0U; i < result.size(); i++)
+        {
+            const GLsizei vertex = group[result[i]];
+
+            if (locked_group[vertex])
+            {
+                continue;
+            }
+
+            for (std::size_t j = 1U; j < 3U; j++)
+            {
+                const GLsizei other = group[result[3U * (i / 3U) + (i % 3U + j) % 3U]];
+
+                if (other == vertex)
+                {
+                    continue;
+                }
+
+                const float value = quadric[vertex].error(&position[3U * static_cast<std::size_t>(other)]);
+
+                if ((value < cost[vertex]) && MeshSimplifier::matches(result, offset, adjacency, group, &order[wedge_first[vertex]], wedge_count[vertex], other, collapse_stock))
+                {
+                    cost[vertex] = value;
+                    target[vertex] = other;
+                }
+            }
+        }
+
+        candidate_stock.clear();
+        for (std::size_t i = 0U; i < vertex_count; i++)
+        {
+            if (target[i] >= 0)
+            {
+                candidate_stock.emplace_back(static_cast<GLsizei>(i));
+            }
+        }
+
+        std::sort(candidate_stock.begin(), candidate_stock.end(), [&cost](const GLsizei &a, const GLsizei &b) { return cost[a] < cost[b]; });
+
+        const std::size_t needed = (result.size() - target_count) / 3U;
+        std::size_t removed = 0U;
+        std::size_t collapses = 0U;
+
+        std::iota(remap.begin(), remap.end(), 0);
+        touched.assign(vertex_count, false);
+
+        for (const GLsizei vertex : candidate_stock)
+        {
+            const GLsizei other = target[vertex];
+            bool blocked = false;
+
+            MeshSimplifier::matches(result, offset, adjacency, group, &order[wedge_first[vertex]], wedge_count[vertex], other, collapse_stock);
+
+            for (const std::pair<GLsizei, GLsizei> &collapse : collapse_stock)
+            {
+                blocked = blocked || touched[collapse.first] || touched[collapse.second] || MeshSimplifier::flips(result, offset, adjacency, position, collapse.first, collapse.second);
+            }
+
+            if (blocked)
+            {
+                continue;
+            }
+
+            quadric[other].add(quadric[vertex]);
+            error = std::max(error, cost[vertex]);
+            collapses++;
+
+            for (const std::pair<GLsizei, GLsizei> &collapse : collapse_stock)
+            {
+                remap[collapse.first] = collapse.second;
+
+                // The neighbours keep their triangles during this pass so the flip tests stay valid
+                for (std::size_t i = offset[collapse.first]; i < offset[collapse.first + 1U]; i++)
+                {
+                    for (std::size_t j = 0U; j < 3U; j++)
+                    {
+                        touched[result[3U * adjacency[i] + j]] = true;
+                    }
+                }
+            }
+
+            // The edge takes two triangles with it, on a seam one on each side
+            removed += 2U;
+            if (removed >= needed)
+            {
+                break;
+            }
+        }
+
+        if (collapses == 0U)
+        {
+            break;
+        }
+
+        std::size_t size = 0U;
+        for (std::size_t i = 0U; i < result.size(); i += 3U)
+        {
+            const GLsizei a = remap[result[i]];
+            const GLsizei b = remap[result[i + 1U]];
+            const GLsizei c = remap[result[i + 2U]];
+
+            if ((a != b) && (b != c) && (a != c))
+            {
+                result[size++] = a;
+                result[size++] = b;
+                result[size++] = c;
+            }
+        }
+
+        result.resize(size);
+    }
+
+    for (GLsizei &vertex : result)
+    {
+        vertex = unique_stock[vertex];
+    }
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef __MESH_SIMPLIFIER_HPP_
+#define __MESH_SIMPLIFIER_HPP_
+#include "../../glad/glad.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/** Quadric error edge collapse simplification keeping the borders, the vertices on an attribute seam move together */
+class MeshSimplifier
+{
+private:
+    /** Sum of the squared distances to a set of planes, weighted by the triangle areas */
+    struct Quadric
+    {
+        double a[6];
+        double b[3];
+        double c;
+        double weight;
+        Quadric();
+        void add(const Quadric &other);
+        float error(const float *const position) const;
+    };
+
+    MeshSimplifier() = delete;
+    MeshSimplifier(const MeshSimplifier &) = delete;
+    MeshSimplifier &operator=(const MeshSimplifier &) = delete;
+    static bool matches(const std::vector<GLsizei> &indices, const std::vector<std::size_t> &offset, const std::vector<std::size_t> &adjacency, const std::vector<GLsizei> &group, const GLsizei *const wedge, const std::size_t &wedges, const GLsizei &target, std::vector<std::pair<GLsizei, GLsizei>> &collapse_stock);
+    static bool flips(const std::vector<GLsizei> &indices, const std::vector<std::size_t> &offset, const std::vector<std::size_t> &adjacency, const std::vector<float> &position, const GLsizei &vertex, const GLsizei &target);
+
+public:
+    static std::vector<GLsizei> simplify(const GLsizei *const indices, const std::size_t &count, const void *const vertices, const std::size_t &stride, const std::size_t &target_count, float &error);
+};
+
+#endif
\ No newline at end of file
@@ -1,10 +1,33 @@
 #include "modeldata.hpp"
 
-ModelData::Object::Object(const GLsizei &count, const GLsizei &offset, Material *const material) :
+ModelData::Object::Object(const GLsizei &count, const GLsizei &offset, Material *const material, const GLenum &type, const GLint &base_vertex) :
     count(count),
-    offset(sizeof(GLsizei) * offset),
-    material(material) {}
+    offset(ModelData::Object::getTypeSize(type) * offset),
+    material(material),
+    type(type),
+    base_vertex(base_vertex),
+    first_cluster(0U),
+    last_cluster(0U) {}
 
+GLsizei ModelData::Object::getTypeSize(const GLenum &type)
+{
+    return type == GL_UNSIGNED_SHORT ? static_cast<GLsizei>(sizeof(GLushort)) : static_cast<GLsizei>(sizeof(GLuint));
+}
+
+ModelData::Cluster::Cluster() :
+    object(0U),
+    count(0),
+    offset(0),
+    center(0.0F),
+    radius(0.0F),
+    cone_axis(0.0F),
+    cone_cutoff(1.0F) {}
+
+ModelData::Lod::Lod(const std::size_t &first, const std::size_t &last, const std::size_t &triangles, const float &error) :
+    first(first),
+    last(last),
+    triangles(triangles),
+    error(error) {}
 
 ModelData::ModelData(const std::string &path) :    
     model_path(path),
@@ -12,6 +35,7 @@ ModelData::ModelData(const std::string &path) :
     material_open(false),
 
     origin_mat(1.0F),
+    position_mat(1.0F),
     min(INFINITY),
     max(-INFINITY),
 
@@ -22,7 +46,13 @@ ModelData::ModelData(const std::string &path) :
     vertices(0U),
     elements(0U),
     triangles(0U),
-    textures(0U) {}
+    textures(0U),
+    packed_vertices(false),
+
+    acmr_before(0.0F),
+    acmr_after(0.0F),
+    atvr_before(0.0F),
+    atvr_after(0.0F) {}
 
 ModelData::~ModelData()
 {    
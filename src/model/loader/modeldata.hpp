@@ -12,12 +12,41 @@
 class ModelData
 {
 public:
+    /** Index range drawn with a material, the offset is in bytes and the indices are relative to the base vertex */
     struct Object
     {
         GLsizei count;
         GLsizei offset;
         Material *material;
-        Object(const GLsizei &count = 0, const GLsizei &offset = 0, Material *const material = nullptr);
+        GLenum type;
+        GLint base_vertex;
+        std::size_t first_cluster;
+        std::size_t last_cluster;
+        Object(const GLsizei &count = 0, const GLsizei &offset = 0, Material *const material = nullptr, const GLenum &type = GL_UNSIGNED_INT, const GLint &base_vertex = 0);
+        static GLsizei getTypeSize(const GLenum &type);
+    };
+
+    /** Triangles of an object culled together, the offset is in bytes and the bounds are in model units */
+    struct Cluster
+    {
+        std::size_t object;
+        GLsizei count;
+        GLsizei offset;
+        glm::vec3 center;
+        float radius;
+        glm::vec3 cone_axis;
+        float cone_cutoff;
+        Cluster();
+    };
+
+    /** Level of detail drawing the objects in [first, last), the error is in model units */
+    struct Lod
+    {
+        std::size_t first;
+        std::size_t last;
+        std::size_t triangles;
+        float error;
+        Lod(const std::size_t &first = 0U, const std::size_t &last = 0U, const std::size_t &triangles = 0U, const float &error = 0.0F);
     };
 
     std::string model_path;
@@ -25,17 +54,25 @@ public:
     bool model_open;
     bool material_open;
     glm::mat4 origin_mat;
+    glm::mat4 position_mat;
     glm::vec3 min;
     glm::vec3 max;
     GLuint vao;
     GLuint vbo;
     GLuint ebo;
     std::vector<ModelData::Object *> object_stock;
+    std::vector<ModelData::Lod> lod_stock;
+    std::vector<ModelData::Cluster> cluster_stock;
     std::vector<Material *> material_stock;
     std::size_t vertices;
     std::size_t elements;
     std::size_t triangles;
     std::size_t textures;
+    bool packed_vertices;
+    float acmr_before;
+    float acmr_after;
+    float atvr_before;
+    float atvr_after;
 
     ModelData() = delete;
     ModelData(const std::string &path);
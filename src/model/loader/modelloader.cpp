@@ -1,86 +1,1082 @@
 #include "modelloader.hpp"
+#include "gltfloader.hpp"
+#include "meshoptimizer.hpp"
+#include "meshsimplifier.hpp"
 #include "objloader.hpp"
+#include "plyloader.hpp"
+#include "stlloader.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <cfloat>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 const std::string ModelLoader::space = " \t\n\r\f\v";
+const std::size_t ModelLoader::MIN_TANGENT_BATCH = 1U << 16U;
+const std::size_t ModelLoader::MIN_SHORT_RANGE = 1U << 12U;
+const std::size_t ModelLoader::MIN_LOD_TRIANGLES = 256U;
+const float ModelLoader::LOD_REDUCTION = 0.5F;
+std::size_t ModelLoader::lod_levels = 4U;
 
 ModelLoader::Vertex::Vertex() : position(0.0F),
                                 uv_coord(0.0F),
                                 normal(0.0F),
                                 tangent(0.0F) {}
 
-ModelLoader::ModelLoader(const std::string &path) : model_data(new ModelData(path)) {}
+ModelLoader::Phase::Phase(const std::string &name, const double &seconds) : name(name),
+                                                                           seconds(seconds) {}
+
+ModelLoader::ModelLoader(const std::string &path) : model_data(new ModelData(path)),
+                                                    options(ModelLoader::ALL_OPTIONS),
+                                                    ready(false),
+                                                    status(false),
+                                                    stage(ModelLoader::READ),
+                                                    cache(nullptr),
+                                                    cached(false),
+                                                    levels(0U),
+                                                    vertex_size(sizeof(ModelLoader::Vertex)),
+                                                    vertex_data(nullptr),
+                                                    vertex_count(0U),
+                                                    index_data(nullptr),
+                                                    index_size(0U),
+                                                    uploaded(0U),
+                                                    headless(false) {}
+
+void ModelLoader::readAll()
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (cached)
+    {
+        cache = new MeshCache(model_data->model_path, vertex_size, options, levels);
+
+        if (!cache->isValid() || !readCache(*cache))
+        {
+            delete cache;
+            cache = nullptr;
+        }
+
+        measure("cache read", start);
+    }
+
+    if (cache != nullptr)
+    {
+        status = true;
+        vertex_data = cache->getVertices();
+        vertex_count = cache->getVertexCount();
+        index_data = cache->getIndices();
+        index_size = cache->getIndexSize();
+    }
+
+    else
+    {
+        status = read();
+        measure("parse", start);
+
+        if (status && (options & ModelLoader::OPTIMIZE))
+        {
+            optimize();
+            measure("optimize", start);
+        }
+
+        if (status && (options & ModelLoader::TANGENTS))
+        {
+            calcTangents();
+            measure("tangents", start);
+        }
+
+        if (status && (options & ModelLoader::LOD))
+        {
+            generateLods();
+            measure("lods", start);
+        }
+
+        if (status)
+        {
+            packIndices();
+            measure("indices", start);
+        }
+
+        // The cluster bounds need the full precision positions
+        if (status && (options & ModelLoader::CLUSTERS))
+        {
+            buildClusters();
+            measure("clusters", start);
+        }
+
+        if (status && (options & ModelLoader::QUANTIZE))
+        {
+            packVertices();
+            vertex_data = packed_stock.data();
+            vertex_count = packed_stock.size();
+            measure("quantize", start);
+        }
+
+        else
+        {
+            vertex_data = vertex_stock.data();
+            vertex_count = vertex_stock.size();
+        }
+
+        index_data = packed_index_stock.data();
+        index_size = packed_index_stock.size();
+
+        if (status && cached)
+        {
+            MeshCache::write(model_data->model_path, *model_data, library_stock, vertex_data, vertex_size, vertex_count, index_data, index_size, options, levels);
+            measure("cache write", start);
+        }
+    }
+
+    // The quantized positions are mapped back to the bounding box by the model matrix
+    if (status && (options & ModelLoader::QUANTIZE) && (vertex_count > 0U))
+    {
+        model_data->position_mat = glm::scale(glm::translate(glm::mat4(1.0F), model_data->min), model_data->max - model_data->min);
+        model_data->packed_vertices = true;
+    }
+
+    stage = status ? ModelLoader::VERTICES : ModelLoader::FINISHED;
+    ready.store(true, std::memory_order_release);
+}
+
+/** Records the time since `start' for a phase and restarts the clock */
+void ModelLoader::measure(const std::string &phase, std::chrono::steady_clock::time_point &start)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    phase_stock.emplace_back(phase, std::chrono::duration<double>(now - start).count());
+    start = now;
+}
+
+/** Gives the objects without a material the default one and fills the model sizes once the vertices and indices are read */
+void ModelLoader::finishRead(const std::size_t &positions)
+{
+    if (model_data->object_stock.empty())
+    {
+        Material *material = new Material("default");
+        model_data->material_stock.emplace_back(material);
+        model_data->object_stock.emplace_back(new ModelData::Object(static_cast<GLsizei>(index_stock.size()), 0, material));
+    }
+
+    glm::vec3 dim = model_data->max - model_data->min;
+    float min_dim = 1.0F / glm::max(glm::max(dim.x, dim.y), dim.z);
+    model_data->origin_mat = glm::translate(glm::scale(glm::mat4(1.0F), glm::vec3(min_dim)), (model_data->min + model_data->max) / -2.0F);
+
+    model_data->vertices = positions;
+    model_data->elements = vertex_stock.size();
+    model_data->triangles = index_stock.size() / 3U;
+    model_data->model_open = true;
+}
+
+/** Smooth normals for the vertices from `first_vertex' on, area weighted over the triangles from `first_index' on */
+void ModelLoader::calcNormals(const std::size_t &first_vertex, const std::size_t &first_index)
+{
+    for (std::size_t i = first_index; i + 2U < index_stock.size(); i += 3U)
+    {
+        ModelLoader::Vertex &a = vertex_stock[index_stock[i]];
+        ModelLoader::Vertex &b = vertex_stock[index_stock[i + 1U]];
+        ModelLoader::Vertex &c = vertex_stock[index_stock[i + 2U]];
+        const glm::vec3 normal = glm::cross(b.position - a.position, c.position - a.position);
+
+        a.normal += normal;
+        b.normal += normal;
+        c.normal += normal;
+    }
+
+    for (std::size_t i = first_vertex; i < vertex_stock.size(); i++)
+    {
+        const float length = glm::length(vertex_stock[i].normal);
+        vertex_stock[i].normal = length > 0.0F ? vertex_stock[i].normal / length : vertex_stock[i].normal;
+    }
+}
+
+/** Queues the decode of the textures of the materials read from `first_material' on, so they overlap the parse */
+void ModelLoader::decodeTextures(const std::size_t &first_material)
+{
+    for (std::size_t i = first_material; !headless && (i < model_data->material_stock.size()); i++)
+    {
+        model_data->material_stock[i]->decodeTextures();
+    }
+}
+
+bool ModelLoader::readCache(const MeshCache &cache)
+{
+    for (const std::string &library : cache.getLibraries())
+    {
+        readMaterial(library);
+    }
+
+    if (model_data->material_open)
+    {
+        for (const MeshCache::Object &object : cache.getObjects())
+        {
+            Material *material = nullptr;
+
+            for (Material *const candidate : model_data->material_stock)
+            {
+                if (candidate->getName() == object.material)
+                {
+                    material = candidate;
+                    break;
+                }
+            }
+
+            // The material libraries changed since the cache was written
+            if (material == nullptr)
+            {
+                const std::string path = model_data->model_path;
+                delete model_data;
+                model_data = new ModelData(path);
+                library_stock.clear();
+
+                return false;
+            }
+
+            model_data->object_stock.emplace_back(new ModelData::Object(object.count, object.offset, material, object.type, object.base_vertex));
+        }
+    }
+
+    else
+    {
+        Material *material = new Material("default");
+        model_data->material_stock.emplace_back(material);
+
+        for (const MeshCache::Object &object : cache.getObjects())
+        {
+            model_data->object_stock.emplace_back(new ModelData::Object(object.count, object.offset, material, object.type, object.base_vertex));
+        }
+    }
+
+    model_data->lod_stock = cache.getLods();
+    model_data->cluster_stock = cache.getClusters();
+
+    for (std::size_t i = 0U; i < model_data->cluster_stock.size(); i++)
+    {
+        ModelData::Object *const object = model_data->object_stock[model_data->cluster_stock[i].object];
+
+        if (object->first_cluster == object->last_cluster)
+        {
+            object->first_cluster = i;
+        }
+
+        object->last_cluster = i + 1U;
+    }
+
+    model_data->min = cache.getMin();
+    model_data->max = cache.getMax();
+    model_data->origin_mat = cache.getOriginMatrix();
+
+    cache.getStatistics(model_data->acmr_before, model_data->acmr_after, model_data->atvr_before, model_data->atvr_after);
+
+    model_data->vertices = cache.getPositions();
+    model_data->elements = cache.getVertexCount();
+    model_data->triangles = cache.getTriangles();
+    model_data->model_open = true;
+
+    return true;
+}
+
+/**
+ * Reorders the triangles of every object for the post-transform cache and then for overdraw,
+ * and the vertices in the order the new index buffer fetches them. The cache statistics before
+ * and after are kept in the model data.
+ */
+void ModelLoader::optimize()
+{
+    GLsizei *const index = index_stock.data();
+    const std::size_t vertices = vertex_stock.size();
+
+    MeshOptimizer::analyze(index, index_stock.size(), vertices, model_data->acmr_before, model_data->atvr_before);
+
+    std::vector<std::size_t> cluster_stock;
+    for (const ModelData::Object *const object : model_data->object_stock)
+    {
+        GLsizei *const first = index + object->offset / static_cast<GLsizei>(sizeof(GLsizei));
+        const std::size_t count = static_cast<std::size_t>(object->count);
+
+        MeshOptimizer::optimizeVertexCache(first, count, cluster_stock);
+        MeshOptimizer::optimizeOverdraw(first, count, vertex_stock.data(), sizeof(ModelLoader::Vertex), cluster_stock);
+    }
+
+    const std::vector<GLsizei> remap = MeshOptimizer::optimizeVertexFetch(index, index_stock.size(), vertices);
+    std::vector<ModelLoader::Vertex> optimized_stock(vertices);
+
+    for (std::size_t i = 0U; i < vertices; i++)
+    {
+        optimized_stock[static_cast<std::size_t>(remap[i])] = vertex_stock[i];
+    }
+
+    vertex_stock.swap(optimized_stock);
+
+    MeshOptimizer::analyze(index, index_stock.size(), vertices, model_data->acmr_after, model_data->atvr_after);
+}
+
+/**
+ * Computes the per vertex tangents from the finished index buffer.
+ * The face tangents are computed four at a time, then every thread sums its triangles into a private
+ * window covering the vertices they use, and the windows are reduced and orthonormalized by vertex ranges.
+ */
+void ModelLoader::calcTangents()
+{
+    const std::size_t triangles = index_stock.size() / 3U;
+    const std::size_t vertices = vertex_stock.size();
+
+    if ((triangles == 0U) || (vertices == 0U))
+    {
+        return;
+    }
+
+    const std::size_t threads = std::max<std::size_t>(1U, std::min<std::size_t>(std::thread::hardware_concurrency(), triangles / ModelLoader::MIN_TANGENT_BATCH));
+    const GLsizei *const index = index_stock.data();
+    const ModelLoader::Vertex *const vertex = vertex_stock.data();
+
+    std::vector<glm::vec3> face_tangent(triangles);
+    std::vector<std::vector<glm::vec3>> partial_stock(threads);
+    std::vector<std::size_t> window_stock(threads, 0U);
+
+    ModelLoader::runParallel(threads, [&](const std::size_t &thread) {
+        const std::size_t first = triangles * thread / threads;
+        const std::size_t last = triangles * (thread + 1U) / threads;
+        std::size_t face = first;
+
+#if defined(__SSE2__) || defined(_M_X64)
+        alignas(16) float lane[16][4];
+
+        for (; (face + 4U) <= last; face += 4U)
+        {
+            for (std::size_t i = 0U; i < 4U; i++)
+            {
+                const ModelLoader::Vertex &vertex_0 = vertex[index[3U * (face + i)]];
+                const ModelLoader::Vertex &vertex_1 = vertex[index[3U * (face + i) + 1U]];
+                const ModelLoader::Vertex &vertex_2 = vertex[index[3U * (face + i) + 2U]];
+
+                lane[0][i] = vertex_0.position.x;
+                lane[1][i] = vertex_0.position.y;
+                lane[2][i] = vertex_0.position.z;
+                lane[3][i] = vertex_1.position.x;
+                lane[4][i] = vertex_1.position.y;
+                lane[5][i] = vertex_1.position.z;
+                lane[6][i] = vertex_2.position.x;
+                lane[7][i] = vertex_2.position.y;
+                lane[8][i] = vertex_2.position.z;
+                lane[9][i] = vertex_0.uv_coord.s;
+                lane[10][i] = vertex_0.uv_coord.t;
+                lane[11][i] = vertex_1.uv_coord.s;
+                lane[12][i] = vertex_1.uv_coord.t;
+                lane[13][i] = vertex_2.uv_coord.s;
+                lane[14][i] = vertex_2.uv_coord.t;
+            }
+
+            const __m128 d0_s = _mm_sub_ps(_mm_load_ps(lane[11]), _mm_load_ps(lane[9]));
+            const __m128 d0_t = _mm_sub_ps(_mm_load_ps(lane[12]), _mm_load_ps(lane[10]));
+            const __m128 d1_s = _mm_sub_ps(_mm_load_ps(lane[13]), _mm_load_ps(lane[9]));
+            const __m128 d1_t = _mm_sub_ps(_mm_load_ps(lane[14]), _mm_load_ps(lane[10]));
+
+            // Absolute value of the UV determinant, clearing the sign bit
+            const __m128 determinant = _mm_andnot_ps(_mm_set1_ps(-0.0F), _mm_sub_ps(_mm_mul_ps(d0_s, d1_t), _mm_mul_ps(d1_s, d0_t)));
+
+            for (std::size_t axis = 0U; axis < 3U; axis++)
+            {
+                const __m128 p0 = _mm_load_ps(lane[axis]);
+                const __m128 l0 = _mm_sub_ps(_mm_load_ps(lane[axis + 3U]), p0);
+                const __m128 l1 = _mm_sub_ps(_mm_load_ps(lane[axis + 6U]), p0);
+
+                _mm_store_ps(lane[15], _mm_div_ps(_mm_sub_ps(_mm_mul_ps(l0, d1_t), _mm_mul_ps(l1, d0_t)), determinant));
+
+                for (std::size_t i = 0U; i < 4U; i++)
+                {
+                    face_tangent[face + i][axis] = lane[15][i];
+                }
+            }
+        }
+#endif
+
+        for (; face < last; face++)
+        {
+            const ModelLoader::Vertex &vertex_0 = vertex[index[3U * face]];
+            const ModelLoader::Vertex &vertex_1 = vertex[index[3U * face + 1U]];
+            const ModelLoader::Vertex &vertex_2 = vertex[index[3U * face + 2U]];
+
+            const glm::vec3 l0(vertex_1.position - vertex_0.position);
+            const glm::vec3 l1(vertex_2.position - vertex_0.position);
+
+            const glm::vec2 d0(vertex_1.uv_coord - vertex_0.uv_coord);
+            const glm::vec2 d1(vertex_2.uv_coord - vertex_0.uv_coord);
+
+            face_tangent[face] = (l0 * d1.t - l1 * d0.t) / glm::abs(d0.s * d1.t - d1.s * d0.t);
+        }
+
+        if (first == last)
+        {
+            return;
+        }
+
+        // Vertices are created in face order, so the window of a face range is small
+        const std::pair<const GLsizei *, const GLsizei *> bounds = std::minmax_element(index + 3U * first, index + 3U * last);
+        const std::size_t window = static_cast<std::size_t>(*bounds.first);
+        std::vector<glm::vec3> &partial = partial_stock[thread];
+
+        window_stock[thread] = window;
+        partial.assign(static_cast<std::size_t>(*bounds.second) - window + 1U, glm::vec3(0.0F));
+
+        for (std::size_t i = 3U * first; i < 3U * last; i++)
+        {
+            partial[static_cast<std::size_t>(index[i]) - window] += face_tangent[i / 3U];
+        }
+    });
+
+    ModelLoader::runParallel(threads, [&](const std::size_t &thread) {
+        const std::size_t first = vertices * thread / threads;
+        const std::size_t last = vertices * (thread + 1U) / threads;
+
+        for (std::size_t i = 0U; i < threads; i++)
+        {
+            const std::size_t begin = std::max(first, window_stock[i]);
+            const std::size_t end = std::min(last, window_stock[i] + partial_stock[i].size());
+
+            for (std::size_t j = begin; j < end; j++)
+            {
+                vertex_stock[j].tangent += partial_stock[i][j - window_stock[i]];
+            }
+        }
+
+        for (std::size_t j = first; j < last; j++)
+        {
+            ModelLoader::Vertex &current = vertex_stock[j];
+            current.tangent = glm::normalize(current.tangent - current.normal * glm::dot(current.normal, current.tangent));
+        }
+    });
+}
+
+/**
+ * Appends up to `levels' simplified copies of the objects, each one halving the triangles of the previous,
+ * and records the object range of every level. The chain stops once a level barely reduces the previous one.
+ */
+void ModelLoader::generateLods()
+{
+    const std::size_t objects = model_data->object_stock.size();
+    std::vector<std::vector<GLsizei>> level_stock(objects);
+    std::size_t triangles = 0U;
+    std::vector<std::size_t> cluster_stock;
+
+    for (std::size_t i = 0U; i < objects; i++)
+    {
+        const ModelData::Object *const object = model_data->object_stock[i];
+        const GLsizei *const first = index_stock.data() + object->offset / static_cast<GLsizei>(sizeof(GLsizei));
+
+        level_stock[i].assign(first, first + object->count);
+        triangles += static_cast<std::size_t>(object->count) / 3U;
+    }
+
+    model_data->lod_stock.clear();
+    model_data->lod_stock.emplace_back(0U, objects, triangles, 0.0F);
+
+    for (std::size_t level = 1U; level <= levels; level++)
+    {
+        ModelData::Lod lod(model_data->object_stock.size(), model_data->object_stock.size() + objects);
+        std::vector<std::vector<GLsizei>> simplified_stock(objects);
+
+        for (std::size_t i = 0U; i < objects; i++)
+        {
+            const std::vector<GLsizei> &source = level_stock[i];
+            std::vector<GLsizei> &simplified = simplified_stock[i];
+            float error = 0.0F;
+
+            if (source.size() / 3U <= ModelLoader::MIN_LOD_TRIANGLES)
+            {
+                simplified = source;
+            }
+            else
+            {
+                simplified = MeshSimplifier::simplify(source.data(), source.size(), vertex_stock.data(), sizeof(ModelLoader::Vertex), 3U * static_cast<std::size_t>(static_cast<float>(source.size() / 3U) * ModelLoader::LOD_REDUCTION), error);
+            }
+
+            if ((options & ModelLoader::OPTIMIZE) && !simplified.empty())
+            {
+                MeshOptimizer::optimizeVertexCache(simplified.data(), simplified.size(), cluster_stock);
+            }
+
+            lod.triangles += simplified.size() / 3U;
+            lod.error = std::max(lod.error, error);
+        }
+
+        // Every level is simplified from the previous one, so the errors add up
+        lod.error += model_data->lod_stock.back().error;
+
+        if (static_cast<float>(lod.triangles) > 0.8F * static_cast<float>(model_data->lod_stock.back().triangles))
+        {
+            break;
+        }
+
+        for (std::size_t i = 0U; i < objects; i++)
+        {
+            const GLsizei offset = static_cast<GLsizei>(index_stock.size());
+
+            index_stock.insert(index_stock.end(), simplified_stock[i].begin(), simplified_stock[i].end());
+            model_data->object_stock.emplace_back(new ModelData::Object(static_cast<GLsizei>(simplified_stock[i].size()), offset, model_data->object_stock[i]->material));
+        }
+
+        level_stock.swap(simplified_stock);
+        model_data->lod_stock.emplace_back(lod);
+    }
+}
+
+/**
+ * Splits every object into clusters of about a hundred triangles with a bounding sphere and a normal cone, so
+ * the hidden ones can be skipped when drawing. The triangles only move inside their object, which keeps the
+ * 16 bit ranges valid, and the cache statistics are measured again on the new order.
+ */
+void ModelLoader::buildClusters()
+{
+    const std::size_t drawn = model_data->lod_stock.empty() ? model_data->object_stock.size() : model_data->lod_stock.front().last;
+    std::vector<GLsizei> index;
+    std::vector<GLsizei> drawn_stock;
+    std::vector<std::size_t> cluster_stock;
+    std::vector<std::size_t> restart_stock;
+
+    model_data->cluster_stock.clear();
+
+    for (std::size_t i = 0U; i < model_data->object_stock.size(); i++)
+    {
+        ModelData::Object *const object = model_data->object_stock[i];
+        GLubyte *const data = packed_index_stock.data() + object->offset;
+        const std::size_t count = static_cast<std::size_t>(object->count);
+        const GLsizei type_size = ModelData::Object::getTypeSize(object->type);
+
+        index.resize(count);
+
+        for (std::size_t j = 0U; j < count; j++)
+        {
+            index[j] = object->type == GL_UNSIGNED_SHORT ? reinterpret_cast<const GLushort *>(data)[j] + object->base_vertex : reinterpret_cast<const GLsizei *>(data)[j];
+        }
+
+        MeshOptimizer::buildClusters(index.data(), count, vertex_stock.data(), sizeof(ModelLoader::Vertex), cluster_stock);
+        object->first_cluster = model_data->cluster_stock.size();
+
+        for (std::size_t j = 0U; j < cluster_stock.size(); j++)
+        {
+            const std::size_t first = 3U * cluster_stock[j];
+            const std::size_t last = j + 1U < cluster_stock.size() ? 3U * cluster_stock[j + 1U] : count;
+            ModelData::Cluster cluster;
+
+            if (options & ModelLoader::OPTIMIZE)
+            {
+                MeshOptimizer::optimizeVertexCache(index.data() + first, last - first, restart_stock);
+            }
+
+            cluster.object = i;
+            cluster.count = static_cast<GLsizei>(last - first);
+            cluster.offset = object->offset + type_size * static_cast<GLsizei>(first);
+            MeshOptimizer::computeBounds(index.data() + first, last - first, vertex_stock.data(), sizeof(ModelLoader::Vertex), cluster.center, cluster.radius, cluster.cone_axis, cluster.cone_cutoff);
+            model_data->cluster_stock.emplace_back(cluster);
+        }
+
+        object->last_cluster = model_data->cluster_stock.size();
+
+        for (std::size_t j = 0U; j < count; j++)
+        {
+            if (object->type == GL_UNSIGNED_SHORT)
+            {
+                reinterpret_cast<GLushort *>(data)[j] = static_cast<GLushort>(index[j] - object->base_vertex);
+            }
+
+            else
+            {
+                reinterpret_cast<GLsizei *>(data)[j] = index[j];
+            }
+        }
+
+        if (i < drawn)
+        {
+            drawn_stock.insert(drawn_stock.end(), index.begin(), index.end());
+        }
+    }
+
+    if (options & ModelLoader::OPTIMIZE)
+    {
+        MeshOptimizer::analyze(drawn_stock.data(), drawn_stock.size(), vertex_stock.size(), model_data->acmr_after, model_data->atvr_after);
+    }
+}
+
+/**
+ * Converts the vertices to the packed layout, roughly halving their size. The positions keep 16 bits
+ * per axis of the bounding box, the UVs are half floats and the normal and tangent octahedral pairs.
+ */
+void ModelLoader::packVertices()
+{
+    const glm::vec3 extent = model_data->max - model_data->min;
+    const glm::vec3 scale(extent.x > 0.0F ? 65535.0F / extent.x : 0.0F, extent.y > 0.0F ? 65535.0F / extent.y : 0.0F, extent.z > 0.0F ? 65535.0F / extent.z : 0.0F);
+
+    packed_stock.resize(vertex_stock.size());
+
+    for (std::size_t i = 0U; i < vertex_stock.size(); i++)
+    {
+        const ModelLoader::Vertex &vertex = vertex_stock[i];
+        ModelLoader::PackedVertex &packed = packed_stock[i];
+        const glm::vec3 position = glm::clamp((vertex.position - model_data->min) * scale + 0.5F, 0.0F, 65535.0F);
+
+        packed.position[0] = static_cast<GLushort>(position.x);
+        packed.position[1] = static_cast<GLushort>(position.y);
+        packed.position[2] = static_cast<GLushort>(position.z);
+        packed.position[3] = 0U;
+        packed.uv_coord[0] = glm::packHalf1x16(vertex.uv_coord.s);
+        packed.uv_coord[1] = glm::packHalf1x16(vertex.uv_coord.t);
+        ModelLoader::encodeOctahedral(vertex.normal, packed.normal);
+        ModelLoader::encodeOctahedral(vertex.tangent, packed.tangent);
+    }
+
+    std::vector<ModelLoader::Vertex>().swap(vertex_stock);
+}
+
+/**
+ * Builds the index buffer drawn by the objects. Objects whose vertices fit a 16 bit range take short indices
+ * relative to their first vertex, larger ones are split into such ranges with the same material unless the
+ * pieces would be shorter than `MIN_SHORT_RANGE' triangles on average, then they keep 32 bit indices.
+ * The few triangles wider than a range on their own are drawn last with 32 bit indices.
+ */
+void ModelLoader::packIndices()
+{
+    std::vector<ModelData::Object *> object_stock;
+    std::vector<std::pair<std::size_t, GLsizei>> range_stock;
+    std::vector<std::size_t> wide_stock;
+    std::vector<std::size_t> first_stock;
+
+    packed_index_stock.clear();
+    packed_index_stock.reserve(sizeof(GLuint) * index_stock.size());
+
+    for (ModelData::Object *const object : model_data->object_stock)
+    {
+        const GLsizei *const index = index_stock.data() + object->offset / static_cast<GLsizei>(sizeof(GLsizei));
+        const std::size_t triangles = static_cast<std::size_t>(object->count) / 3U;
+        GLsizei low = 0;
+        GLsizei high = 0;
+
+        first_stock.emplace_back(object_stock.size());
+
+        // Greedy ranges of triangles, with the first triangle and the lowest vertex of each
+        range_stock.clear();
+        wide_stock.clear();
+
+        for (std::size_t triangle = 0U; triangle < triangles; triangle++)
+        {
+            const std::pair<const GLsizei *, const GLsizei *> bounds = std::minmax_element(index + 3U * triangle, index + 3U * triangle + 3U);
+
+            if (*bounds.second - *bounds.first > 0xFFFF)
+            {
+                wide_stock.emplace_back(triangle);
+            }
+
+            else if (range_stock.empty() || (std::max(high, *bounds.second) - std::min(low, *bounds.first) > 0xFFFF))
+            {
+                low = *bounds.first;
+                high = *bounds.second;
+                range_stock.emplace_back(triangle, low);
+            }
+
+            else
+            {
+                low = std::min(low, *bounds.first);
+                high = std::max(high, *bounds.second);
+                range_stock.back().second = low;
+            }
+        }
+
+        // Both index types start on a four byte boundary
+        packed_index_stock.resize((packed_index_stock.size() + 3U) & ~static_cast<std::size_t>(3U));
+
+        if (range_stock.empty() || ((range_stock.size() > 1U) && ((triangles - wide_stock.size()) / range_stock.size() < ModelLoader::MIN_SHORT_RANGE)))
+        {
+            const std::size_t offset = packed_index_stock.size();
+
+            packed_index_stock.resize(offset + sizeof(GLuint) * 3U * triangles);
+            std::memcpy(packed_index_stock.data() + offset, index, sizeof(GLuint) * 3U * triangles);
+
+            object_stock.emplace_back(new ModelData::Object(object->count, static_cast<GLsizei>(offset / sizeof(GLuint)), object->material));
+            continue;
+        }
+
+        std::vector<std::size_t>::const_iterator wide = wide_stock.begin();
+
+        for (std::size_t range = 0U; range < range_stock.size(); range++)
+        {
+            const std::size_t first = range_stock[range].first;
+            const std::size_t last = range + 1U < range_stock.size() ? range_stock[range + 1U].first : triangles;
+            const GLsizei base_vertex = range_stock[range].second;
+            const std::size_t offset = packed_index_stock.size();
+
+            // Wide triangles ahead of the first range belong to none
+            while ((wide != wide_stock.end()) && (*wide < first))
+            {
+                wide++;
+            }
+
+            for (std::size_t triangle = first; triangle < last; triangle++)
+            {
+                if ((wide != wide_stock.end()) && (*wide == triangle))
+                {
+                    wide++;
+                    continue;
+                }
+
+                for (std::size_t i = 3U * triangle; i < 3U * triangle + 3U; i++)
+                {
+                    const GLushort packed = static_cast<GLushort>(index[i] - base_vertex);
+                    packed_index_stock.insert(packed_index_stock.end(), reinterpret_cast<const GLubyte *>(&packed), reinterpret_cast<const GLubyte *>(&packed) + sizeof(GLushort));
+                }
+            }
+
+            const std::size_t count = (packed_index_stock.size() - offset) / sizeof(GLushort);
+            object_stock.emplace_back(new ModelData::Object(static_cast<GLsizei>(count), static_cast<GLsizei>(offset / sizeof(GLushort)), object->material, GL_UNSIGNED_SHORT, base_vertex));
+        }
+
+        if (!wide_stock.empty())
+        {
+            packed_index_stock.resize((packed_index_stock.size() + 3U) & ~static_cast<std::size_t>(3U));
+            const std::size_t offset = packed_index_stock.size();
+
+            for (const std::size_t triangle : wide_stock)
+            {
+                packed_index_stock.insert(packed_index_stock.end(), reinterpret_cast<const GLubyte *>(index + 3U * triangle), reinterpret_cast<const GLubyte *>(index + 3U * triangle + 3U));
+            }
+
+            object_stock.emplace_back(new ModelData::Object(static_cast<GLsizei>(3U * wide_stock.size()), static_cast<GLsizei>(offset / sizeof(GLuint)), object->material));
+        }
+    }
+
+    for (const ModelData::Object *const object : model_data->object_stock)
+    {
+        delete object;
+    }
+
+    // The levels of detail follow their objects
+    first_stock.emplace_back(object_stock.size());
+    for (ModelData::Lod &lod : model_data->lod_stock)
+    {
+        lod.first = first_stock[lod.first];
+        lod.last = first_stock[lod.last];
+    }
+
+    model_data->object_stock.swap(object_stock);
+    std::vector<GLsizei>().swap(index_stock);
+}
+
+/** Projects a direction on the octahedron and unfolds it to the unit square as two signed normalized shorts */
+void ModelLoader::encodeOctahedral(const glm::vec3 &vector, GLshort *const packed)
+{
+    const float length = std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+
+    if (!(length > 0.0F))
+    {
+        packed[0] = 0;
+        packed[1] = 0;
+        return;
+    }
+
+    glm::vec2 point = glm::vec2(vector) / length;
+
+    if (vector.z < 0.0F)
+    {
+        point = (1.0F - glm::abs(glm::vec2(point.y, point.x))) * glm::vec2(point.x >= 0.0F ? 1.0F : -1.0F, point.y >= 0.0F ? 1.0F : -1.0F);
+    }
 
-void ModelLoader::load()
+    point = glm::round(glm::clamp(point, -1.0F, 1.0F) * 32767.0F);
+    packed[0] = static_cast<GLshort>(point.x);
+    packed[1] = static_cast<GLshort>(point.y);
+}
+
+void ModelLoader::runParallel(const std::size_t &threads, const std::function<void(const std::size_t &)> &task)
 {
-    glGenVertexArrays(1, &model_data->vao);
-    glBindVertexArray(model_data->vao);
+    std::vector<std::thread> worker_stock;
 
-    glGenBuffers(1, &model_data->vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, model_data->vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(ModelLoader::Vertex) * vertex_stock.size(), &vertex_stock[0], GL_STATIC_DRAW);
+    for (std::size_t i = 1U; i < threads; i++)
+    {
+        worker_stock.emplace_back(task, i);
+    }
 
-    glGenBuffers(1, &model_data->ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_data->ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * index_stock.size(), &index_stock[0], GL_STATIC_DRAW);
+    task(0U);
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, position)));
+    for (std::thread &worker : worker_stock)
+    {
+        worker.join();
+    }
+}
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, uv_coord)));
+/** Copies the next part of a buffer that fits in the budget, returns true once it is complete */
+bool ModelLoader::uploadBuffer(const GLuint &buffer, const void *const data, const std::size_t &size, std::size_t &budget)
+{
+    const std::size_t bytes = std::min(size - uploaded, budget);
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, normal)));
+    if (bytes > 0U)
+    {
+        // The copy target does not change the element buffer of the bound vertex array
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(uploaded), static_cast<GLsizeiptr>(bytes), static_cast<const char *>(data) + uploaded);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, GL_FALSE);
 
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, tangent)));
+        uploaded += bytes;
+        budget -= bytes;
+    }
 
-    glBindVertexArray(GL_FALSE);
+    if (uploaded < size)
+    {
+        return false;
+    }
 
-    vertex_stock.clear();
-    index_stock.clear();
+    uploaded = 0U;
+    return true;
 }
 
-ModelLoader::~ModelLoader() {}
+bool ModelLoader::isReady() const
+{
+    return ready.load(std::memory_order_acquire);
+}
 
-ModelData *ModelLoader::load(const std::string &path, const ModelLoader::Format &format)
+bool ModelLoader::update(std::size_t &budget)
+{
+    if (!isReady())
+    {
+        return false;
+    }
+
+    if (stage == ModelLoader::VERTICES)
+    {
+        if (model_data->vbo == GL_FALSE)
+        {
+            glGenVertexArrays(1, &model_data->vao);
+
+            glGenBuffers(1, &model_data->vbo);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, model_data->vbo);
+            glBufferData(GL_COPY_WRITE_BUFFER, vertex_size * vertex_count, nullptr, GL_STATIC_DRAW);
+
+            glGenBuffers(1, &model_data->ebo);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, model_data->ebo);
+            glBufferData(GL_COPY_WRITE_BUFFER, index_size, nullptr, GL_STATIC_DRAW);
+
+            glBindBuffer(GL_COPY_WRITE_BUFFER, GL_FALSE);
+        }
+
+        if (uploadBuffer(model_data->vbo, vertex_data, vertex_size * vertex_count, budget))
+        {
+            stage = ModelLoader::INDICES;
+        }
+    }
+
+    if ((stage == ModelLoader::INDICES) && uploadBuffer(model_data->ebo, index_data, index_size, budget))
+    {
+        stage = ModelLoader::ATTRIBUTES;
+    }
+
+    if (stage == ModelLoader::ATTRIBUTES)
+    {
+        glBindVertexArray(model_data->vao);
+        glBindBuffer(GL_ARRAY_BUFFER, model_data->vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_data->ebo);
+
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        glEnableVertexAttribArray(3);
+
+        // The normal and tangent only fill two components when packed, the shaders decode them
+        if (model_data->packed_vertices)
+        {
+            glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(ModelLoader::PackedVertex), reinterpret_cast<void *>(offsetof(ModelLoader::PackedVertex, position)));
+            glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(ModelLoader::PackedVertex), reinterpret_cast<void *>(offsetof(ModelLoader::PackedVertex, uv_coord)));
+            glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, sizeof(ModelLoader::PackedVertex), reinterpret_cast<void *>(offsetof(ModelLoader::PackedVertex, normal)));
+            glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(ModelLoader::PackedVertex), reinterpret_cast<void *>(offsetof(ModelLoader::PackedVertex, tangent)));
+        }
+
+        else
+        {
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, position)));
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, uv_coord)));
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, normal)));
+            glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, tangent)));
+        }
+
+        glBindVertexArray(GL_FALSE);
+
+        vertex_data = nullptr;
+        index_data = nullptr;
+        std::vector<ModelLoader::Vertex>().swap(vertex_stock);
+        std::vector<ModelLoader::PackedVertex>().swap(packed_stock);
+        std::vector<GLsizei>().swap(index_stock);
+        std::vector<GLubyte>().swap(packed_index_stock);
+
+        delete cache;
+        cache = nullptr;
+
+        stage = ModelLoader::TEXTURES;
+    }
+
+    // The textures decoded by the workers are uploaded as they complete, while the budget lasts
+    if (stage == ModelLoader::TEXTURES)
+    {
+        bool pending = false;
+
+        for (Material *const material : model_data->material_stock)
+        {
+            if (budget > 0U)
+            {
+                budget -= std::min(budget, material->loadTextures(false));
+            }
+
+            pending = pending || material->hasPendingTextures();
+        }
+
+        stage = pending ? ModelLoader::TEXTURES : ModelLoader::FINISHED;
+    }
+
+    return stage == ModelLoader::FINISHED;
+}
+
+ModelData *ModelLoader::release()
+{
+    ModelData *const data = model_data;
+    model_data = nullptr;
+
+    return data;
+}
+
+void ModelLoader::discard()
+{
+    // Only a read loader can own GL objects, and then no worker uses it anymore
+    if (!isReady() || (model_data == nullptr))
+    {
+        return;
+    }
+
+    glDeleteVertexArrays(1, &model_data->vao);
+    glDeleteBuffers(1, &model_data->vbo);
+    glDeleteBuffers(1, &model_data->ebo);
+
+    delete model_data;
+    model_data = nullptr;
+}
+
+ModelLoader::~ModelLoader()
+{
+    delete cache;
+    delete model_data;
+}
+
+ModelLoader *ModelLoader::create(const std::string &path, const ModelLoader::Format &format, const GLenum &options)
 {
     ModelLoader *loader = nullptr;
 
     switch (format)
     {
     case OBJ:
-        loader = static_cast<ModelLoader *>(new OBJLoader(path));
+        loader = static_cast<ModelLoader *>(new OBJLoader(path, OBJLoader::getMode(), OBJLoader::getThreads()));
+        break;
+
+    case PLY:
+        loader = static_cast<ModelLoader *>(new PLYLoader(path));
+        break;
+
+    case STL:
+        loader = static_cast<ModelLoader *>(new STLLoader(path));
+        break;
+
+    case GLTF:
+        loader = static_cast<ModelLoader *>(new GLTFLoader(path));
         break;
 
     default:
         std::cerr << "error " << format << std::endl;
+        return nullptr;
+    }
+
+    loader->options = options;
+    // The settings are copied on this thread, the GUI may change them while the loader reads
+    loader->levels = options & ModelLoader::LOD ? ModelLoader::lod_levels : 0U;
+    loader->cached = MeshCache::isEnabled();
+    loader->vertex_size = options & ModelLoader::QUANTIZE ? sizeof(ModelLoader::PackedVertex) : sizeof(ModelLoader::Vertex);
+    return loader;
+}
+
+ModelData *ModelLoader::load(const std::string &path, const ModelLoader::Format &format, const GLenum &options)
+{
+    ModelLoader *loader = ModelLoader::create(path, format, options);
+
+    if (loader == nullptr)
+    {
         return new ModelData(path);
     }
 
-    if (loader->read())
+    std::size_t budget = SIZE_MAX;
+
+    loader->readAll();
+    loader->update(budget);
+
+    // The decodes still running are waited for
+    for (Material *const material : loader->model_data->material_stock)
+    {
+        material->loadTextures();
+    }
+
+    ModelData *model_data = loader->release();
+    delete loader;
+
+    return model_data;
+}
+
+/**
+ * Runs only the read phases, so no GL context is needed, and returns the time spent in each of them.
+ * The model data has no buffers nor textures.
+ */
+ModelData *ModelLoader::loadHeadless(const std::string &path, const ModelLoader::Format &format, const GLenum &options, std::vector<ModelLoader::Phase> &phase_stock)
+{
+    ModelLoader *loader = ModelLoader::create(path, format, options);
+    phase_stock.clear();
+
+    if (loader == nullptr)
     {
-        loader->load();
+        return new ModelData(path);
     }
 
-    ModelData *model_data = loader->model_data;
+    loader->headless = true;
+    loader->readAll();
+    phase_stock.swap(loader->phase_stock);
+
+    ModelData *model_data = loader->release();
     delete loader;
 
     return model_data;
 }
 
+std::shared_ptr<ModelLoader> ModelLoader::loadAsync(const std::string &path, const ModelLoader::Format &format, const GLenum &options)
+{
+    static ThreadPool pool;
+
+    std::shared_ptr<ModelLoader> loader(ModelLoader::create(path, format, options));
+
+    if (loader == nullptr)
+    {
+        return loader;
+    }
+
+    pool.submit([loader]() { loader->readAll(); });
+
+    return loader;
+}
+
 std::vector<Material *> ModelLoader::loadMaterial(const std::string &path, const ModelLoader::Format &format)
 {
-    ModelLoader *loader = nullptr;
+    ModelLoader *loader = ModelLoader::create(path, format, 0U);
 
-    switch (format)
+    if (loader == nullptr)
     {
-    case OBJ:
-        loader = static_cast<ModelLoader *>(new OBJLoader(path));
-        break;
-    default:
-        std::cerr << "error " << format << std::endl;
         return std::vector<Material *>();
     }
 
@@ -88,14 +1084,271 @@ std::vector<Material *> ModelLoader::loadMaterial(const std::string &path, const
 
     std::vector<Material *> material_stock(loader->model_data->material_stock);
 
+    for (Material *const material : material_stock)
+    {
+        material->loadTextures();
+    }
+
     loader->model_data->material_stock.clear();
-    delete loader->model_data;
     delete loader;
 
     return material_stock;
 }
 
+/** Matches the extension without regard to case, anything unknown is read as OBJ */
+ModelLoader::Format ModelLoader::getFormat(const std::string &path)
+{
+    const std::size_t dot = path.find_last_of('.');
+    std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1U);
+
+    for (char &c : extension)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    if (extension == "ply")
+    {
+        return ModelLoader::PLY;
+    }
+
+    if (extension == "stl")
+    {
+        return ModelLoader::STL;
+    }
+
+    if ((extension == "gltf") || (extension == "glb"))
+    {
+        return ModelLoader::GLTF;
+    }
+
+    return ModelLoader::OBJ;
+}
+
+std::size_t ModelLoader::getLodLevels()
+{
+    return ModelLoader::lod_levels;
+}
+
+void ModelLoader::setLodLevels(const std::size_t &levels)
+{
+    ModelLoader::lod_levels = levels;
+}
+
 void ModelLoader::rtrim(std::string &str)
 {
     str.erase(str.find_last_not_of(ModelLoader::space) + 1);
+}
+
+bool ModelLoader::isLittleEndian()
+{
+    const std::uint16_t probe = 1U;
+    return *reinterpret_cast<const unsigned char *>(&probe) == 1U;
+}
+
+/** Copies `size' bytes of an unaligned binary value, reversing them when its byte order is not the native one */
+void ModelLoader::readBinary(const char *const source, void *const target, const std::size_t &size, const bool &swap)
+{
+    std::memcpy(target, source, size);
+
+    if (swap)
+    {
+        unsigned char *const bytes = static_cast<unsigned char *>(target);
+        std::reverse(bytes, bytes + size);
+    }
+}
+
+bool ModelLoader::isSpace(const char &c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\f') || (c == '\v');
+}
+
+const char *ModelLoader::skipSpace(const char *cursor, const char *const end)
+{
+    while ((cursor < end) && ModelLoader::isSpace(*cursor))
+    {
+        cursor++;
+    }
+
+    return cursor;
+}
+
+const char *ModelLoader::skipToken(const char *cursor, const char *const end)
+{
+    while ((cursor < end) && !ModelLoader::isSpace(*cursor))
+    {
+        cursor++;
+    }
+
+    return cursor;
+}
+
+/**
+ * Parses a float without allocating, giving the same result as `std::istream >> float'.
+ * Short decimals are converted through an exact double product and only the
+ * ambiguous (or out of range) ones fall back to `std::strtof'.
+ */
+bool ModelLoader::parseFloat(const char *&cursor, const char *const end, float &value)
+{
+    static const double power[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char *const begin = ModelLoader::skipSpace(cursor, end);
+    const char *it = begin;
+
+    bool negative = false;
+    if ((it < end) && ((*it == '-') || (*it == '+')))
+    {
+        negative = *it == '-';
+        it++;
+    }
+
+    std::uint64_t mantissa = 0U;
+    int digits = 0;
+    int exponent = 0;
+    bool truncated = false;
+    bool valid = false;
+
+    for (; (it < end) && (*it >= '0') && (*it <= '9'); it++)
+    {
+        valid = true;
+
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10U + static_cast<std::uint64_t>(*it - '0');
+            digits += mantissa != 0U;
+        }
+        else
+        {
+            exponent++;
+            truncated |= *it != '0';
+        }
+    }
+
+    if ((it < end) && (*it == '.'))
+    {
+        for (it++; (it < end) && (*it >= '0') && (*it <= '9'); it++)
+        {
+            valid = true;
+
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10U + static_cast<std::uint64_t>(*it - '0');
+                digits += mantissa != 0U;
+                exponent--;
+            }
+            else
+            {
+                truncated |= *it != '0';
+            }
+        }
+    }
+
+    if (!valid)
+    {
+        cursor = it;
+        value = 0.0F;
+        return false;
+    }
+
+    if ((it < end) && ((*it == 'e') || (*it == 'E')))
+    {
+        const char *exp_it = it + 1;
+        bool exp_negative = false;
+
+        if ((exp_it < end) && ((*exp_it == '-') || (*exp_it == '+')))
+        {
+            exp_negative = *exp_it == '-';
+            exp_it++;
+        }
+
+        if ((exp_it < end) && (*exp_it >= '0') && (*exp_it <= '9'))
+        {
+            int exp_value = 0;
+            for (; (exp_it < end) && (*exp_it >= '0') && (*exp_it <= '9'); exp_it++)
+            {
+                if (exp_value < 100000)
+                {
+                    exp_value = exp_value * 10 + (*exp_it - '0');
+                }
+            }
+
+            exponent += exp_negative ? -exp_value : exp_value;
+            it = exp_it;
+        }
+    }
+
+    cursor = it;
+
+    if (!truncated && (mantissa <= (1ULL << 53)) && (exponent >= -22) && (exponent <= 22))
+    {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / power[-exponent] : result * power[exponent];
+
+        if (result == 0.0)
+        {
+            value = negative ? -0.0F : 0.0F;
+            return true;
+        }
+
+        // The double is correctly rounded, so rounding it again to float is only
+        // wrong when it lies exactly halfway between two floats
+        std::uint64_t bits;
+        std::memcpy(&bits, &result, sizeof(bits));
+
+        if ((result >= FLT_MIN) && (result <= FLT_MAX) && ((bits & 0x1FFFFFFFULL) != 0x10000000ULL))
+        {
+            value = static_cast<float>(negative ? -result : result);
+            return true;
+        }
+    }
+
+    char buffer[64];
+    const std::size_t length = static_cast<std::size_t>(it - begin);
+
+    if (length < sizeof(buffer))
+    {
+        std::memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+        value = std::strtof(buffer, nullptr);
+    }
+    else
+    {
+        value = std::strtof(std::string(begin, it).c_str(), nullptr);
+    }
+
+    // Out of range values are clamped like the stream extraction does
+    if ((value > FLT_MAX) || (value < -FLT_MAX))
+    {
+        value = value > 0.0F ? FLT_MAX : -FLT_MAX;
+        return false;
+    }
+
+    return true;
+}
+
+bool ModelLoader::parseInt(const char *&cursor, const char *const end, long &value)
+{
+    const char *it = ModelLoader::skipSpace(cursor, end);
+
+    bool negative = false;
+    if ((it < end) && ((*it == '-') || (*it == '+')))
+    {
+        negative = *it == '-';
+        it++;
+    }
+
+    if ((it == end) || (*it < '0') || (*it > '9'))
+    {
+        return false;
+    }
+
+    long result = 0;
+    for (; (it < end) && (*it >= '0') && (*it <= '9'); it++)
+    {
+        result = result * 10 + (*it - '0');
+    }
+
+    value = negative ? -result : result;
+    cursor = it;
+    return true;
 }
\ No newline at end of file
@@ -1,16 +1,52 @@
 #ifndef __MODEL_LOADER_HPP_
 #define __MODEL_LOADER_HPP_
 #include "modeldata.hpp"
+#include "meshcache.hpp"
+#include "../../threadpool.hpp"
 #include "../material.hpp"
 #include "../../glad/glad.h"
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 
 /** Model loader abstract class */
 class ModelLoader
 {
+public:
+    /** Source file format, picked from the extension by getFormat */
+    enum Format
+    {
+        OBJ,
+        PLY,
+        STL,
+        GLTF
+    };
+
+    /** Optional work done while reading, selected per model */
+    enum Option : GLenum
+    {
+        TANGENTS = 0x0001,
+        OPTIMIZE = 0x0002,
+        QUANTIZE = 0x0004,
+        LOD = 0x0008,
+        CLUSTERS = 0x0010,
+        ALL_OPTIONS = 0x001F
+    };
+
+    /** Time spent in one phase of a load */
+    struct Phase
+    {
+    public:
+        std::string name;
+        double seconds;
+        Phase(const std::string &name, const double &seconds);
+    };
+
 protected:
     /** Model vertex */
     struct Vertex
@@ -23,13 +59,53 @@ protected:
         Vertex();
     };
 
+    /** Quantized vertex, positions normalized to the bounding box, half float UVs and octahedral normal and tangent */
+    struct PackedVertex
+    {
+    public:
+        GLushort position[4];
+        GLushort uv_coord[2];
+        GLshort normal[2];
+        GLshort tangent[2];
+    };
+
+    /** Upload progress, the read stage runs on any thread and the others on the one owning the context */
+    enum Stage
+    {
+        READ,
+        VERTICES,
+        INDICES,
+        ATTRIBUTES,
+        TEXTURES,
+        FINISHED
+    };
+
     ModelData *model_data;
     std::vector<glm::vec3> position_stock;
     std::vector<glm::vec2> uv_coord_stock;
     std::vector<glm::vec3> normal_stock;
     std::map<std::string, GLsizei> parsed_vertex;
     std::vector<GLsizei> index_stock;
+    std::vector<GLubyte> packed_index_stock;
     std::vector<Vertex> vertex_stock;
+    std::vector<PackedVertex> packed_stock;
+    std::vector<std::string> library_stock;
+    std::vector<ModelLoader::Phase> phase_stock;
+
+    GLenum options;
+    std::atomic<bool> ready;
+    bool status;
+    ModelLoader::Stage stage;
+    MeshCache *cache;
+    bool cached;
+    std::size_t levels;
+    std::size_t vertex_size;
+    const void *vertex_data;
+    std::size_t vertex_count;
+    const void *index_data;
+    std::size_t index_size;
+    std::size_t uploaded;
+    bool headless;
 
     ModelLoader(const std::string &path);
     ModelLoader() = delete;
@@ -37,18 +113,49 @@ protected:
     ModelLoader &operator=(const ModelLoader &) = delete;
     virtual bool read() = 0;
     virtual bool readMaterial(const std::string &path) = 0;
-    void load();
+    void readAll();
+    void measure(const std::string &phase, std::chrono::steady_clock::time_point &start);
+    void finishRead(const std::size_t &positions);
+    void calcNormals(const std::size_t &first_vertex, const std::size_t &first_index);
+    void decodeTextures(const std::size_t &first_material);
+    bool readCache(const MeshCache &cache);
+    void optimize();
+    void calcTangents();
+    void generateLods();
+    void packIndices();
+    void buildClusters();
+    void packVertices();
+    bool uploadBuffer(const GLuint &buffer, const void *const data, const std::size_t &size, std::size_t &budget);
     static const std::string space;
+    static const std::size_t MIN_TANGENT_BATCH;
+    static const std::size_t MIN_SHORT_RANGE;
+    static const std::size_t MIN_LOD_TRIANGLES;
+    static const float LOD_REDUCTION;
+    static std::size_t lod_levels;
+    static void runParallel(const std::size_t &threads, const std::function<void(const std::size_t &)> &task);
+    static ModelLoader *create(const std::string &path, const ModelLoader::Format &format, const GLenum &options);
+    static void encodeOctahedral(const glm::vec3 &vector, GLshort *const packed);
+    static bool isLittleEndian();
+    static void readBinary(const char *const source, void *const target, const std::size_t &size, const bool &swap);
+    static bool isSpace(const char &c);
+    static const char *skipSpace(const char *cursor, const char *const end);
+    static const char *skipToken(const char *cursor, const char *const end);
+    static bool parseFloat(const char *&cursor, const char *const end, float &value);
+    static bool parseInt(const char *&cursor, const char *const end, long &value);
 
 public:
-    enum Format
-    {
-        OBJ
-    };
-
+    bool isReady() const;
+    bool update(std::size_t &budget);
+    ModelData *release();
+    void discard();
     virtual ~ModelLoader();
-    static ModelData *load(const std::string &path, const ModelLoader::Format &format);
+    static ModelData *load(const std::string &path, const ModelLoader::Format &format, const GLenum &options = ModelLoader::ALL_OPTIONS);
+    static ModelData *loadHeadless(const std::string &path, const ModelLoader::Format &format, const GLenum &options, std::vector<ModelLoader::Phase> &phase_stock);
+    static std::shared_ptr<ModelLoader> loadAsync(const std::string &path, const ModelLoader::Format &format, const GLenum &options = ModelLoader::ALL_OPTIONS);
     static std::vector<Material *> loadMaterial(const std::string &path, const ModelLoader::Format &format);
+    static ModelLoader::Format getFormat(const std::string &path);
+    static std::size_t getLodLevels();
+    static void setLodLevels(const std::size_t &levels);
     static void rtrim(std::string &str);
 };
 
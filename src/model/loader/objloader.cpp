@@ -1,15 +1,159 @@
 #include "objloader.hpp"
+#include "mappedfile.hpp"
 #include "../../dirsep.h"
 #include "../../glad/glad.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
+#include <glm/common.hpp>
 #include <algorithm>
 #include <vector>
 #include <cctype>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <thread>
+
+OBJLoader::Mode OBJLoader::mode = OBJLoader::MAPPED;
+std::size_t OBJLoader::threads = 0U;
+const std::size_t OBJLoader::MIN_CHUNK_SIZE = 1U << 22U;
+
+OBJLoader::Chunk::Chunk(const char *const begin, const char *const end) : begin(begin),
+                                                                          end(end),
+                                                                          min(INFINITY),
+                                                                          max(-INFINITY),
+                                                                          base{0, 0, 0},
+                                                                          first_vertex(0),
+                                                                          first_index(0U) {}
+
+void OBJLoader::parseChunk(OBJLoader::Chunk &chunk)
+{
+    const char *cursor = chunk.begin;
+    const char *const end = chunk.end;
+    glm::vec3 data(0.0F);
+
+    while (cursor < end)
+    {
+
+        const char *line = cursor;
+        const char *line_end = static_cast<const char *>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+
+        if (line_end == nullptr)
+        {
+            line_end = end;
+            cursor = end;
+        }
+        else
+        {
+            cursor = line_end + 1;
+        }
+
+        if ((line < line_end) && (*line == '#'))
+        {
+            continue;
+        }
+
+        while ((line < line_end) && ModelLoader::isSpace(*(line_end - 1)))
+        {
+            line_end--;
+        }
+
+        if (line == line_end)
+        {
+            continue;
+        }
+
+        const char *const token = ModelLoader::skipSpace(line, line_end);
+        const char *args = ModelLoader::skipToken(token, line_end);
+        const std::size_t length = static_cast<std::size_t>(args - token);
+
+        if ((length == 6U) && ((std::memcmp(token, "mtllib", 6U) == 0) || (std::memcmp(token, "usemtl", 6U) == 0)))
+        {
+            const OBJLoader::Directive directive = {token[0] == 'm', ModelLoader::skipSpace(args, line_end), line_end, chunk.face_stock.size(), 0U};
+            chunk.directive_stock.emplace_back(directive);
+        }
+
+        else if ((length == 1U) && (*token == 'v'))
+        {
+            ModelLoader::parseFloat(args, line_end, data.x) && ModelLoader::parseFloat(args, line_end, data.y) && ModelLoader::parseFloat(args, line_end, data.z);
+            chunk.position_stock.emplace_back(data);
+
+            chunk.min = glm::min(chunk.min, data);
+            chunk.max = glm::max(chunk.max, data);
+        }
+
+        else if ((length == 2U) && (token[0] == 'v') && (token[1] == 'n'))
+        {
+            ModelLoader::parseFloat(args, line_end, data.x) && ModelLoader::parseFloat(args, line_end, data.y) && ModelLoader::parseFloat(args, line_end, data.z);
+            chunk.normal_stock.emplace_back(data);
+        }
+
+        else if ((length == 2U) && (token[0] == 'v') && (token[1] == 't'))
+        {
+            ModelLoader::parseFloat(args, line_end, data.x) && ModelLoader::parseFloat(args, line_end, data.y);
+            chunk.uv_coord_stock.emplace_back(glm::vec2(data));
+        }
+
+        else if ((length == 1U) && (*token == 'f'))
+        {
+
+            const std::size_t first = chunk.corner_stock.size();
+
+            for (const char *it = ModelLoader::skipSpace(args, line_end); it < line_end; it = ModelLoader::skipSpace(args, line_end))
+            {
+                args = ModelLoader::skipToken(it, line_end);
+
+                OBJLoader::Corner corner = {{-1, -1, -1}, 0U};
+                const GLint stock_size[3] = {static_cast<GLint>(chunk.position_stock.size()),
+                                             static_cast<GLint>(chunk.uv_coord_stock.size()),
+                                             static_cast<GLint>(chunk.normal_stock.size())};
+
+                const char *component = it;
+                for (std::size_t i = 0; i < 3; i++)
+                {
+                    const char *const separator = std::find(component, args, '/');
+                    const char *number = component;
+                    long value;
+
+                    if ((component < separator) && ModelLoader::parseInt(number, separator, value))
+                    {
+                        if (value < 0)
+                        {
+                            corner.index[i] = stock_size[i] + static_cast<GLint>(value);
+                            corner.local |= static_cast<GLubyte>(1U << i);
+                        }
+                        else
+                        {
+                            corner.index[i] = static_cast<GLint>(value) - 1;
+                        }
+                    }
+
+                    if (separator == args)
+                    {
+                        break;
+                    }
+
+                    component = separator + 1;
+                }
+
+                chunk.corner_stock.emplace_back(corner);
+            }
+
+            const std::size_t size = chunk.corner_stock.size() - first;
+
+            if (size < 3U)
+            {
+                chunk.corner_stock.resize(first);
+            }
+            else
+            {
+                chunk.face_stock.emplace_back(static_cast<GLsizei>(size));
+            }
+        }
+    }
+}
 
 GLsizei OBJLoader::storeVertex(const std::string &vertex_str)
 {
@@ -53,26 +197,129 @@ GLsizei OBJLoader::storeVertex(const std::string &vertex_str)
     return index;
 }
 
-void OBJLoader::calcTangent(const GLsizei &ind_0, const GLsizei &ind_1, const GLsizei &ind_2)
+/**
+ * Resolves the corners of the chunk against its bases and splits its faces into fans, keeping each corner the first
+ * time it is used, so the merge only maps the unique corners of every chunk
+ */
+void OBJLoader::triangulateChunk(OBJLoader::Chunk &chunk)
 {
-    ModelLoader::Vertex &vertex_0 = vertex_stock.at(ind_0);
-    ModelLoader::Vertex &vertex_1 = vertex_stock.at(ind_1);
-    ModelLoader::Vertex &vertex_2 = vertex_stock.at(ind_2);
+    VertexMap corner_map;
+    corner_map.reserve(chunk.position_stock.size());
+    chunk.index_stock.reserve(3U * (chunk.corner_stock.size() - 2U * chunk.face_stock.size()));
+
+    std::vector<OBJLoader::Directive>::iterator directive = chunk.directive_stock.begin();
+    std::vector<OBJLoader::Corner>::const_iterator corner = chunk.corner_stock.begin();
+
+    for (std::size_t face = 0U; face < chunk.face_stock.size(); face++)
+    {
+
+        for (; (directive != chunk.directive_stock.end()) && (directive->face == face); directive++)
+        {
+            directive->index = chunk.index_stock.size();
+        }
+
+        const GLsizei size = chunk.face_stock[face];
+
+        for (GLsizei i = 2; i < size; i++)
+        {
+
+            const OBJLoader::Corner *const triangle[3] = {&*corner, &*(corner + i - 1), &*(corner + i)};
+
+            for (const OBJLoader::Corner *const source : triangle)
+            {
+                OBJLoader::Corner resolved = {{-1, -1, -1}, 0U};
 
-    const glm::vec3 l0(vertex_1.position - vertex_0.position);
-    const glm::vec3 l1(vertex_2.position - vertex_0.position);
+                for (std::size_t j = 0; j < 3; j++)
+                {
+                    resolved.index[j] = source->index[j] + ((source->local & (1U << j)) ? chunk.base[j] : 0);
+                }
+
+                const GLsizei new_index = static_cast<GLsizei>(chunk.vertex_stock.size());
+                const GLsizei result = corner_map.emplace(resolved.index, new_index);
+                chunk.index_stock.emplace_back(result);
+
+                if (result == new_index)
+                {
+                    chunk.vertex_stock.emplace_back(resolved);
+                }
+            }
+        }
 
-    const glm::vec2 d0(vertex_1.uv_coord - vertex_0.uv_coord);
-    const glm::vec2 d1(vertex_2.uv_coord - vertex_0.uv_coord);
+        corner += size;
+    }
 
-    const glm::vec3 tangent((l0 * d1.t - l1 * d0.t) / glm::abs(d0.s * d1.t - d1.s * d0.t));
+    for (; directive != chunk.directive_stock.end(); directive++)
+    {
+        directive->index = chunk.index_stock.size();
+    }
 
-    vertex_0.tangent += tangent;
-    vertex_1.tangent += tangent;
-    vertex_2.tangent += tangent;
+    std::vector<OBJLoader::Corner>().swap(chunk.corner_stock);
+    std::vector<GLsizei>().swap(chunk.face_stock);
+}
+
+ModelLoader::Vertex OBJLoader::getVertex(const GLint (&index)[3]) const
+{
+    ModelLoader::Vertex vertex;
+
+    if ((index[0] >= 0) && (static_cast<std::size_t>(index[0]) < position_stock.size()))
+    {
+        vertex.position = position_stock[index[0]];
+    }
+
+    if ((index[1] >= 0) && (static_cast<std::size_t>(index[1]) < uv_coord_stock.size()))
+    {
+        vertex.uv_coord = uv_coord_stock[index[1]];
+    }
+
+    if ((index[2] >= 0) && (static_cast<std::size_t>(index[2]) < normal_stock.size()))
+    {
+        vertex.normal = normal_stock[index[2]];
+    }
+
+    return vertex;
 }
 
 bool OBJLoader::read()
+{
+    switch (parse_mode)
+    {
+    case OBJLoader::STREAM:
+        return readStream();
+
+    case OBJLoader::MAPPED:
+        return readMapped();
+
+    case OBJLoader::COMPARE:
+    {
+        OBJLoader reference(model_data->model_path, OBJLoader::STREAM, parse_threads);
+
+        // The mapped parser runs first, with the cold file cache, so the reported speedup is conservative
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const bool status = readMapped();
+        const std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+        const bool reference_status = reference.readStream();
+        const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+        const double mapped_time = std::chrono::duration<double>(middle - start).count();
+        const double stream_time = std::chrono::duration<double>(stop - middle).count();
+
+        std::cout << "info: `" << model_data->model_path << "' stream parse " << stream_time << "s, mapped parse " << mapped_time << "s (" << (stream_time / mapped_time) << "x)" << std::endl;
+
+        if ((status != reference_status) || (status && !compare(reference)))
+        {
+            std::cerr << "error: the stream and mapped parsers disagree on `" << model_data->model_path << "'" << std::endl;
+        }
+
+        return status;
+    }
+
+    default:
+        std::cerr << "error: invalid OBJ parse mode `" << parse_mode << "'" << std::endl;
+        return false;
+    }
+}
+
+bool OBJLoader::readStream()
 {
 
     std::ifstream file(model_data->model_path);
@@ -182,12 +429,9 @@ bool OBJLoader::read()
             for (std::vector<std::string>::iterator it = face.begin() + 2; it != face.end(); it++)
             {
 
-                const GLsizei ind_0 = storeVertex(first);
-                const GLsizei ind_1 = storeVertex(*(it - 1));
-
-                const GLsizei ind_2 = storeVertex(*it);
-
-                calcTangent(ind_0, ind_1, ind_2);
+                storeVertex(first);
+                storeVertex(*(it - 1));
+                storeVertex(*it);
             }
 
             face.clear();
@@ -196,43 +440,237 @@ bool OBJLoader::read()
 
     file.close();
 
-    if (model_data->material_open)
+    finish(count);
+    return true;
+}
+
+void OBJLoader::applyDirective(const OBJLoader::Directive &directive, const std::string &relative, GLsizei &count)
+{
+    if (directive.library)
     {
-        model_data->object_stock.back()->count = static_cast<GLsizei>(index_stock.size()) - count;
+        readMaterial(relative + std::string(directive.begin, directive.end));
+        return;
+    }
+
+    if (!model_data->material_open)
+    {
+        return;
+    }
+
+    if (!model_data->object_stock.empty())
+    {
+        model_data->object_stock.back()->count = static_cast<GLsizei>(directive.index) - count;
+        count = static_cast<GLsizei>(directive.index);
+    }
+
+    const std::string name(directive.begin, directive.end);
+
+    for (Material *const material : model_data->material_stock)
+    {
+        if (material->getName() == name)
+        {
+            model_data->object_stock.emplace_back(new ModelData::Object(0, count, material));
+            break;
+        }
+    }
+}
+
+bool OBJLoader::readMapped()
+{
+
+    MappedFile file(model_data->model_path);
+    if (!file.isOpen())
+    {
+        std::cerr << "error " << model_data->model_path << " " << std::endl;
+        return false;
+    }
+
+    // Split the file at line boundaries, one chunk per thread
+    std::size_t chunks = parse_threads == 0U ? std::thread::hardware_concurrency() : parse_threads;
+    chunks = std::max<std::size_t>(1U, std::min(chunks, file.getSize() / OBJLoader::MIN_CHUNK_SIZE));
+
+    std::vector<OBJLoader::Chunk> chunk_stock;
+    chunk_stock.reserve(chunks);
+
+    const char *begin = file.getData();
+    const char *const end = file.getEnd();
+
+    for (std::size_t i = 1U; i <= chunks; i++)
+    {
+        const char *chunk_end = end;
+
+        if (i < chunks)
+        {
+            chunk_end = std::max(begin, file.getData() + (file.getSize() / chunks) * i);
+            chunk_end = static_cast<const char *>(std::memchr(chunk_end, '\n', static_cast<std::size_t>(end - chunk_end)));
+            chunk_end = chunk_end == nullptr ? end : chunk_end + 1;
+        }
+
+        chunk_stock.emplace_back(begin, chunk_end);
+        begin = chunk_end;
+    }
+
+    ModelLoader::runParallel(chunk_stock.size(), [&](const std::size_t &thread) {
+        OBJLoader::parseChunk(chunk_stock[thread]);
+    });
+
+    // The chunk bases renumber the relative indices
+    std::size_t positions = 0U;
+    std::size_t uv_coords = 0U;
+    std::size_t normals = 0U;
+
+    for (OBJLoader::Chunk &chunk : chunk_stock)
+    {
+        chunk.base[0] = static_cast<GLint>(positions);
+        chunk.base[1] = static_cast<GLint>(uv_coords);
+        chunk.base[2] = static_cast<GLint>(normals);
+
+        positions += chunk.position_stock.size();
+        uv_coords += chunk.uv_coord_stock.size();
+        normals += chunk.normal_stock.size();
+
+        model_data->min = glm::min(model_data->min, chunk.min);
+        model_data->max = glm::max(model_data->max, chunk.max);
+    }
+
+    position_stock.resize(positions);
+    uv_coord_stock.resize(uv_coords);
+    normal_stock.resize(normals);
+
+    // Each thread concatenates the attributes of its chunk and triangulates it
+    ModelLoader::runParallel(chunk_stock.size(), [&](const std::size_t &thread) {
+        OBJLoader::Chunk &chunk = chunk_stock[thread];
+        OBJLoader::triangulateChunk(chunk);
+
+        std::copy(chunk.position_stock.begin(), chunk.position_stock.end(), position_stock.begin() + chunk.base[0]);
+        std::copy(chunk.uv_coord_stock.begin(), chunk.uv_coord_stock.end(), uv_coord_stock.begin() + chunk.base[1]);
+        std::copy(chunk.normal_stock.begin(), chunk.normal_stock.end(), normal_stock.begin() + chunk.base[2]);
+
+        std::vector<glm::vec3>().swap(chunk.position_stock);
+        std::vector<glm::vec2>().swap(chunk.uv_coord_stock);
+        std::vector<glm::vec3>().swap(chunk.normal_stock);
+    });
+
+    // Most attributes are referenced by at least one vertex, size the table so it rarely grows
+    vertex_map.reserve(std::max(std::max(positions, uv_coords), normals));
+
+    // Map the unique corners in file order so the output does not depend on the number of chunks, the vertices
+    // first used by a chunk get consecutive indices from its first vertex
+    const std::string relative = model_data->model_path.substr(0U, model_data->model_path.find_last_of(DIR_SEP) + 1U);
+    GLsizei vertices = 0;
+    std::size_t indices = 0U;
+    GLsizei count = 0U;
+
+    for (OBJLoader::Chunk &chunk : chunk_stock)
+    {
+        chunk.first_vertex = vertices;
+        chunk.first_index = indices;
+        chunk.remap_stock.resize(chunk.vertex_stock.size());
+
+        for (std::size_t i = 0U; i < chunk.vertex_stock.size(); i++)
+        {
+            chunk.remap_stock[i] = vertex_map.emplace(chunk.vertex_stock[i].index, vertices);
+
+            if (chunk.remap_stock[i] == vertices)
+            {
+                vertices++;
+            }
+        }
+
+        for (OBJLoader::Directive &directive : chunk.directive_stock)
+        {
+            directive.index += indices;
+            applyDirective(directive, relative, count);
+        }
+
+        indices += chunk.index_stock.size();
     }
 
-    else
+    vertex_stock.resize(static_cast<std::size_t>(vertices));
+    index_stock.resize(indices);
+
+    ModelLoader::runParallel(chunk_stock.size(), [&](const std::size_t &thread) {
+        OBJLoader::Chunk &chunk = chunk_stock[thread];
+
+        for (std::size_t i = 0U; i < chunk.index_stock.size(); i++)
+        {
+            index_stock[chunk.first_index + i] = chunk.remap_stock[static_cast<std::size_t>(chunk.index_stock[i])];
+        }
+
+        for (std::size_t i = 0U; i < chunk.vertex_stock.size(); i++)
+        {
+            if (chunk.remap_stock[i] >= chunk.first_vertex)
+            {
+                vertex_stock[static_cast<std::size_t>(chunk.remap_stock[i])] = getVertex(chunk.vertex_stock[i].index);
+            }
+        }
+
+        std::vector<OBJLoader::Corner>().swap(chunk.vertex_stock);
+        std::vector<GLsizei>().swap(chunk.index_stock);
+        std::vector<GLsizei>().swap(chunk.remap_stock);
+    });
+
+    finish(count);
+    return true;
+}
+
+bool OBJLoader::compare(OBJLoader &other) const
+{
+    const ModelData *const other_data = other.model_data;
+
+    if ((vertex_stock.size() != other.vertex_stock.size()) || (index_stock != other.index_stock) ||
+        (std::memcmp(vertex_stock.data(), other.vertex_stock.data(), sizeof(ModelLoader::Vertex) * vertex_stock.size()) != 0))
     {
-        Material *material = new Material("default");
-        model_data->material_stock.emplace_back(material);
-        model_data->object_stock.emplace_back(new ModelData::Object(static_cast<GLsizei>(index_stock.size()), 0, material));
+        return false;
     }
 
-    for (ModelLoader::Vertex &vertex : vertex_stock)
+    if ((std::memcmp(&model_data->min, &other_data->min, sizeof(glm::vec3)) != 0) ||
+        (std::memcmp(&model_data->max, &other_data->max, sizeof(glm::vec3)) != 0) ||
+        (std::memcmp(&model_data->origin_mat, &other_data->origin_mat, sizeof(glm::mat4)) != 0) ||
+        (model_data->vertices != other_data->vertices) || (model_data->elements != other_data->elements) ||
+        (model_data->triangles != other_data->triangles) || (model_data->textures != other_data->textures) ||
+        (model_data->object_stock.size() != other_data->object_stock.size()) ||
+        (model_data->material_stock.size() != other_data->material_stock.size()))
     {
-        vertex.tangent = glm::normalize(vertex.tangent - vertex.normal * glm::dot(vertex.normal, vertex.tangent));
+        return false;
+    }
+
+    for (std::size_t i = 0U; i < model_data->object_stock.size(); i++)
+    {
+        const ModelData::Object *const object = model_data->object_stock[i];
+        const ModelData::Object *const other_object = other_data->object_stock[i];
+
+        if ((object->count != other_object->count) || (object->offset != other_object->offset) ||
+            (object->material->getName() != other_object->material->getName()))
+        {
+            return false;
+        }
     }
 
-    glm::vec3 dim = model_data->max - model_data->min;
-    float min_dim = 1.0F / glm::max(glm::max(dim.x, dim.y), dim.z);
-    model_data->origin_mat = glm::translate(glm::scale(glm::mat4(1.0F), glm::vec3(min_dim)), (model_data->min + model_data->max) / -2.0F);
+    return true;
+}
+
+void OBJLoader::finish(const GLsizei &count)
+{
+    if (model_data->material_open && !model_data->object_stock.empty())
+    {
+        model_data->object_stock.back()->count = static_cast<GLsizei>(index_stock.size()) - count;
+    }
 
-    model_data->vertices = position_stock.size();
-    model_data->elements = vertex_stock.size();
-    model_data->triangles = index_stock.size() / 3U;
+    finishRead(position_stock.size());
 
     parsed_vertex.clear();
+    vertex_map.clear();
     position_stock.clear();
     uv_coord_stock.clear();
     normal_stock.clear();
-
-    model_data->model_open = true;
-    return true;
 }
 
 bool OBJLoader::readMaterial(const std::string &mtl)
 {
+    const std::size_t first_material = model_data->material_stock.size();
 
+    library_stock.emplace_back(mtl);
     model_data->material_path = mtl;
     const std::string relative = model_data->material_path.substr(0U, model_data->material_path.find_last_of(DIR_SEP) + 1U);
 
@@ -276,7 +714,7 @@ bool OBJLoader::readMaterial(const std::string &mtl)
 
             if (load_cube_map)
             {
-                material->setCubeMapTexturePath(cube_map_path);
+                material->setCubeMapTexturePath(cube_map_path, false);
 
                 load_cube_map = false;
                 for (int i = 0; i < 6; i++)
@@ -344,7 +782,7 @@ bool OBJLoader::readMaterial(const std::string &mtl)
         {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::AMBIENT, relative + token);
+            material->setTexturePath(Material::AMBIENT, relative + token, false);
             model_data->textures++;
         }
 
@@ -352,7 +790,7 @@ bool OBJLoader::readMaterial(const std::string &mtl)
         {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::DIFFUSE, relative + token);
+            material->setTexturePath(Material::DIFFUSE, relative + token, false);
             model_data->textures++;
         }
 
@@ -360,7 +798,7 @@ bool OBJLoader::readMaterial(const std::string &mtl)
         {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::SPECULAR, relative + token);
+            material->setTexturePath(Material::SPECULAR, relative + token, false);
             model_data->textures++;
         }
 
@@ -368,7 +806,7 @@ bool OBJLoader::readMaterial(const std::string &mtl)
         {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::SHININESS, relative + token);
+            material->setTexturePath(Material::SHININESS, relative + token, false);
             model_data->textures++;
         }
 
@@ -376,7 +814,7 @@ bool OBJLoader::readMaterial(const std::string &mtl)
         {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::NORMAL, relative + token);
+            material->setTexturePath(Material::NORMAL, relative + token, false);
             model_data->textures++;
         }
 
@@ -384,7 +822,7 @@ bool OBJLoader::readMaterial(const std::string &mtl)
         {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::DISPLACEMENT, relative + token);
+            material->setTexturePath(Material::DISPLACEMENT, relative + token, false);
             model_data->textures++;
         }
 
@@ -453,9 +891,32 @@ bool OBJLoader::readMaterial(const std::string &mtl)
     }
 
     file.close();
+    decodeTextures(first_material);
 
     model_data->material_open = true;
     return true;
 }
 
-OBJLoader::OBJLoader(const std::string &path) : ModelLoader(path) {}
\ No newline at end of file
+OBJLoader::OBJLoader(const std::string &path, const OBJLoader::Mode &parse_mode, const std::size_t &parse_threads) : ModelLoader(path),
+                                                                                                                 parse_mode(parse_mode),
+                                                                                                                 parse_threads(parse_threads) {}
+
+OBJLoader::Mode OBJLoader::getMode()
+{
+    return OBJLoader::mode;
+}
+
+void OBJLoader::setMode(const OBJLoader::Mode &new_mode)
+{
+    OBJLoader::mode = new_mode;
+}
+
+std::size_t OBJLoader::getThreads()
+{
+    return OBJLoader::threads;
+}
+
+void OBJLoader::setThreads(const std::size_t &count)
+{
+    OBJLoader::threads = count;
+}
\ No newline at end of file
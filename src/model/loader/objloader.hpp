@@ -1,21 +1,93 @@
 #ifndef __OBJ_LOADER_HPP_
 #define __OBJ_LOADER_HPP_
 #include "modelloader.hpp"
+#include "vertexmap.hpp"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 #include <string>
+#include <vector>
 
 class OBJLoader : public ModelLoader
 {
+public:
+    /** Parsing strategy */
+    enum Mode
+    {
+        STREAM,
+        MAPPED,
+        COMPARE
+    };
+
 private:
+    /** Face vertex, relative indices are resolved against the chunk and marked as local */
+    struct Corner
+    {
+        GLint index[3];
+        GLubyte local;
+    };
+
+    /** mtllib or usemtl statement, applied before the face with the same index, which starts at the element index */
+    struct Directive
+    {
+        bool library;
+        const char *begin;
+        const char *end;
+        std::size_t face;
+        std::size_t index;
+    };
+
+    /**
+     * Range of lines parsed by a single thread. The thread also triangulates its faces into the unique corners of the
+     * chunk, which the merge maps to the vertices of the model.
+     */
+    struct Chunk
+    {
+        const char *begin;
+        const char *end;
+        glm::vec3 min;
+        glm::vec3 max;
+        GLint base[3];
+        GLsizei first_vertex;
+        std::size_t first_index;
+        std::vector<glm::vec3> position_stock;
+        std::vector<glm::vec2> uv_coord_stock;
+        std::vector<glm::vec3> normal_stock;
+        std::vector<Corner> corner_stock;
+        std::vector<GLsizei> face_stock;
+        std::vector<Directive> directive_stock;
+        std::vector<Corner> vertex_stock;
+        std::vector<GLsizei> index_stock;
+        std::vector<GLsizei> remap_stock;
+        Chunk(const char *const begin, const char *const end);
+    };
+
+    VertexMap vertex_map;
+    OBJLoader::Mode parse_mode;
+    std::size_t parse_threads;
     OBJLoader() = delete;
     OBJLoader(const OBJLoader &) = delete;
     OBJLoader &operator=(const OBJLoader &) = delete;
     GLsizei storeVertex(const std::string &vertex_str);
-    void calcTangent(const GLsizei &ind_0, const GLsizei &ind_1, const GLsizei &ind_2);
+    ModelLoader::Vertex getVertex(const GLint (&index)[3]) const;
+    void applyDirective(const OBJLoader::Directive &directive, const std::string &relative, GLsizei &count);
     bool read();
+    bool readStream();
+    bool readMapped();
+    bool compare(OBJLoader &other) const;
+    void finish(const GLsizei &count);
     bool readMaterial(const std::string &mtl);
+    static OBJLoader::Mode mode;
+    static std::size_t threads;
+    static const std::size_t MIN_CHUNK_SIZE;
+    static void parseChunk(OBJLoader::Chunk &chunk);
+    static void triangulateChunk(OBJLoader::Chunk &chunk);
 
 public:
-    OBJLoader(const std::string &path);
+    OBJLoader(const std::string &path, const OBJLoader::Mode &parse_mode, const std::size_t &parse_threads);
+    static OBJLoader::Mode getMode();
+    static void setMode(const OBJLoader::Mode &new_mode);
+    static std::size_t getThreads();
+    static void setThreads(const std::size_t &count);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,519 @@
+#include "plyloader.hpp"
+#include "mappedfile.hpp"
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+PLYLoader::PLYLoader(const std::string &path) : ModelLoader(path),
+                                                swap(false),
+                                                normals(false) {}
+
+PLYLoader::Type PLYLoader::parseType(const std::string &name)
+{
+    const char *const names[][2] = {{"char", "int8"}, {"uchar", "uint8"}, {"short", "int16"}, {"ushort", "uint16"}, {"int", "int32"}, {"uint", "uint32"}, {"float", "float32"}, {"double", "float64"}};
+
+    for (std::size_t i = 0U; i < PLYLoader::INVALID; i++)
+    {
+        if ((name == names[i][0]) || (name == names[i][1]))
+        {
+            return static_cast<PLYLoader::Type>(i);
+        }
+    }
+
+    return PLYLoader::INVALID;
+}
+
+std::size_t PLYLoader::getTypeSize(const PLYLoader::Type &type)
+{
+    const std::size_t sizes[] = {1U, 1U, 2U, 2U, 4U, 4U, 4U, 8U, 0U};
+    return sizes[type];
+}
+
+double PLYLoader::readScalar(const char *const source, const PLYLoader::Type &type) const
+{
+    switch (type)
+    {
+    case PLYLoader::CHAR:
+        return static_cast<double>(static_cast<signed char>(*source));
+
+    case PLYLoader::UCHAR:
+        return static_cast<double>(static_cast<unsigned char>(*source));
+
+    case PLYLoader::SHORT:
+    {
+        std::int16_t value;
+        ModelLoader::readBinary(source, &value, sizeof(value), swap);
+        return static_cast<double>(value);
+    }
+
+    case PLYLoader::USHORT:
+    {
+        std::uint16_t value;
+        ModelLoader::readBinary(source, &value, sizeof(value), swap);
+        return static_cast<double>(value);
+    }
+
+    case PLYLoader::INT:
+    {
+        std::int32_t value;
+        ModelLoader::readBinary(source, &value, sizeof(value), swap);
+        return static_cast<double>(value);
+    }
+
+    case PLYLoader::UINT:
+    {
+        std::uint32_t value;
+        ModelLoader::readBinary(source, &value, sizeof(value), swap);
+        return static_cast<double>(value);
+    }
+
+    case PLYLoader::FLOAT:
+    {
+        float value;
+        ModelLoader::readBinary(source, &value, sizeof(value), swap);
+        return static_cast<double>(value);
+    }
+
+    case PLYLoader::DOUBLE:
+    {
+        double value;
+        ModelLoader::readBinary(source, &value, sizeof(value), swap);
+        return value;
+    }
+
+    default:
+        return 0.0;
+    }
+}
+
+/** Parses the text header up to `end_header', leaving the cursor on the first byte of the binary body */
+bool PLYLoader::readHeader(const char *&cursor, const char *const end)
+{
+    const char *line_end = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+
+    if ((line_end == nullptr) || (std::string(cursor, line_end).compare(0U, 3U, "ply") != 0))
+    {
+        std::cerr << "error: `" << model_data->model_path << "' is not a PLY file" << std::endl;
+        return false;
+    }
+
+    bool binary = false;
+
+    while (true)
+    {
+        cursor = line_end + 1;
+        line_end = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+
+        if (line_end == nullptr)
+        {
+            std::cerr << "error: the PLY header of `" << model_data->model_path << "' has no end" << std::endl;
+            return false;
+        }
+
+        std::istringstream line(std::string(cursor, line_end));
+        std::string token;
+        line >> token;
+
+        if (token == "end_header")
+        {
+            cursor = line_end + 1;
+            break;
+        }
+
+        if (token == "format")
+        {
+            line >> token;
+            binary = (token == "binary_little_endian") || (token == "binary_big_endian");
+            swap = (token == "binary_big_endian") == ModelLoader::isLittleEndian();
+
+            if (!binary)
+            {
+                std::cerr << "error: the PLY format `" << token << "' of `" << model_data->model_path << "' is not supported, only binary files are read" << std::endl;
+                return false;
+            }
+        }
+
+        else if (token == "element")
+        {
+            PLYLoader::Element element;
+            line >> element.name >> element.count;
+            element.stride = 0U;
+            element_stock.emplace_back(element);
+        }
+
+        else if ((token == "property") && !element_stock.empty())
+        {
+            PLYLoader::Element &element = element_stock.back();
+            PLYLoader::Property property;
+            line >> token;
+
+            property.list = token == "list";
+            property.count_type = PLYLoader::INVALID;
+
+            if (property.list)
+            {
+                line >> token;
+                property.count_type = PLYLoader::parseType(token);
+                line >> token;
+            }
+
+            property.type = PLYLoader::parseType(token);
+            line >> property.name;
+
+            if ((property.type == PLYLoader::INVALID) || (property.list && (property.count_type == PLYLoader::INVALID)))
+            {
+                std::cerr << "error: unknown PLY property type in `" << model_data->model_path << "'" << std::endl;
+                return false;
+            }
+
+            element.property_stock.emplace_back(property);
+        }
+    }
+
+    if (!binary)
+    {
+        std::cerr << "error: the PLY header of `" << model_data->model_path << "' has no format" << std::endl;
+        return false;
+    }
+
+    // Rows without lists have a fixed size, so whole elements can be skipped or bounds checked at once
+    for (PLYLoader::Element &element : element_stock)
+    {
+        for (const PLYLoader::Property &property : element.property_stock)
+        {
+            if (property.list)
+            {
+                element.stride = 0U;
+                break;
+            }
+
+            element.stride += PLYLoader::getTypeSize(property.type);
+        }
+    }
+
+    return true;
+}
+
+bool PLYLoader::readVertices(const PLYLoader::Element &element, const char *&cursor, const char *const end)
+{
+    // Destination of each property: position, UV and normal components, or none
+    const char *const names[][4] = {{"x", "", "", ""}, {"y", "", "", ""}, {"z", "", "", ""}, {"u", "s", "texture_u", "texture_s"}, {"v", "t", "texture_v", "texture_t"}, {"nx", "", "", ""}, {"ny", "", "", ""}, {"nz", "", "", ""}};
+    std::vector<int> slot_stock(element.property_stock.size(), -1);
+
+    for (std::size_t i = 0U; i < element.property_stock.size(); i++)
+    {
+        for (int slot = 0; (slot < 8) && (slot_stock[i] < 0); slot++)
+        {
+            for (const char *const name : names[slot])
+            {
+                if ((*name != '\0') && !element.property_stock[i].list && (element.property_stock[i].name == name))
+                {
+                    slot_stock[i] = slot;
+                    normals = normals || (slot >= 5);
+                }
+            }
+        }
+    }
+
+    // Rows with lists take at least a byte, which bounds the count before the allocation
+    if (static_cast<std::size_t>(end - cursor) / std::max<std::size_t>(element.stride, 1U) < element.count)
+    {
+        std::cerr << "error: the PLY vertices of `" << model_data->model_path << "' are truncated" << std::endl;
+        return false;
+    }
+
+    // Native order float attributes in fixed size rows are copied straight from the mapped file
+    int offset[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+    bool direct = (element.stride > 0U) && !swap;
+
+    for (std::size_t i = 0U, position = 0U; i < element.property_stock.size(); position += PLYLoader::getTypeSize(element.property_stock[i].type), i++)
+    {
+        if (slot_stock[i] >= 0)
+        {
+            offset[slot_stock[i]] = static_cast<int>(position);
+            direct = direct && (element.property_stock[i].type == PLYLoader::FLOAT);
+        }
+    }
+
+    vertex_stock.resize(element.count);
+
+    for (ModelLoader::Vertex &vertex : vertex_stock)
+    {
+        float value[8] = {0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F};
+
+        for (std::size_t slot = 0U; direct && (slot < 8U); slot++)
+        {
+            if (offset[slot] >= 0)
+            {
+                std::memcpy(&value[slot], cursor + offset[slot], sizeof(float));
+            }
+        }
+
+        cursor += direct ? element.stride : 0U;
+
+        for (std::size_t i = 0U; !direct && (i < element.property_stock.size()); i++)
+        {
+            const PLYLoader::Property &property = element.property_stock[i];
+            std::size_t size = PLYLoader::getTypeSize(property.type);
+
+            if (property.list)
+            {
+                if (static_cast<std::size_t>(end - cursor) < PLYLoader::getTypeSize(property.count_type))
+                {
+                    std::cerr << "error: the PLY vertices of `" << model_data->model_path << "' are truncated" << std::endl;
+                    return false;
+                }
+
+                size *= static_cast<std::size_t>(readScalar(cursor, property.count_type));
+                cursor += PLYLoader::getTypeSize(property.count_type);
+            }
+
+            if (static_cast<std::size_t>(end - cursor) < size)
+            {
+                std::cerr << "error: the PLY vertices of `" << model_data->model_path << "' are truncated" << std::endl;
+                return false;
+            }
+
+            if (slot_stock[i] >= 0)
+            {
+                value[slot_stock[i]] = static_cast<float>(readScalar(cursor, property.type));
+            }
+
+            cursor += size;
+        }
+
+        vertex.position = glm::vec3(value[0], value[1], value[2]);
+        vertex.uv_coord = glm::vec2(value[3], value[4]);
+        vertex.normal = glm::vec3(value[5], value[6], value[7]);
+
+        model_data->min = glm::min(model_data->min, vertex.position);
+        model_data->max = glm::max(model_data->max, vertex.position);
+    }
+
+    return true;
+}
+
+/** Triangulates the polygons as fans, faces with an index out of range are dropped */
+bool PLYLoader::readFaces(const PLYLoader::Element &element, const char *&cursor, const char *const end)
+{
+    std::vector<GLsizei> corner_stock;
+    std::size_t invalid = 0U;
+    const std::size_t vertices = vertex_stock.size();
+    const std::size_t first = index_stock.size();
+
+    if (static_cast<std::size_t>(end - cursor) < element.count)
+    {
+        std::cerr << "error: the PLY faces of `" << model_data->model_path << "' are truncated" << std::endl;
+        return false;
+    }
+
+    index_stock.reserve(first + 3U * element.count);
+
+    // Triangles written as an uchar count and 32 bit indices in native order skip the generic walk
+    bool direct = (element.property_stock.size() == 1U) && !swap;
+
+    if (direct)
+    {
+        const PLYLoader::Property &list = element.property_stock.front();
+        direct = list.list && (list.count_type == PLYLoader::UCHAR) && ((list.type == PLYLoader::INT) || (list.type == PLYLoader::UINT));
+    }
+
+    for (std::size_t row = 0U; row < element.count; row++)
+    {
+        if (direct && (static_cast<std::size_t>(end - cursor) > 3U * sizeof(std::uint32_t)) && (static_cast<unsigned char>(*cursor) == 3U))
+        {
+            std::uint32_t corner[3];
+            std::memcpy(corner, cursor + 1, sizeof(corner));
+            cursor += 1U + sizeof(corner);
+
+            if ((corner[0] < vertices) && (corner[1] < vertices) && (corner[2] < vertices))
+            {
+                index_stock.emplace_back(static_cast<GLsizei>(corner[0]));
+                index_stock.emplace_back(static_cast<GLsizei>(corner[1]));
+                index_stock.emplace_back(static_cast<GLsizei>(corner[2]));
+            }
+
+            else
+            {
+                invalid++;
+            }
+
+            continue;
+        }
+
+        for (const PLYLoader::Property &property : element.property_stock)
+        {
+            const std::size_t size = PLYLoader::getTypeSize(property.type);
+            std::size_t count = 1U;
+
+            if (property.list)
+            {
+                if (static_cast<std::size_t>(end - cursor) < PLYLoader::getTypeSize(property.count_type))
+                {
+                    std::cerr << "error: the PLY faces of `" << model_data->model_path << "' are truncated" << std::endl;
+                    return false;
+                }
+
+                count = static_cast<std::size_t>(readScalar(cursor, property.count_type));
+                cursor += PLYLoader::getTypeSize(property.count_type);
+            }
+
+            if (static_cast<std::size_t>(end - cursor) / size < count)
+            {
+                std::cerr << "error: the PLY faces of `" << model_data->model_path << "' are truncated" << std::endl;
+                return false;
+            }
+
+            if (!property.list || ((property.name != "vertex_indices") && (property.name != "vertex_index")))
+            {
+                cursor += size * count;
+                continue;
+            }
+
+            bool valid = count >= 3U;
+            corner_stock.resize(count);
+
+            for (std::size_t i = 0U; i < count; i++, cursor += size)
+            {
+                const double index = readScalar(cursor, property.type);
+                valid = valid && (index >= 0.0) && (index < static_cast<double>(vertices));
+                corner_stock[i] = static_cast<GLsizei>(index);
+            }
+
+            if (!valid)
+            {
+                invalid++;
+                continue;
+            }
+
+            for (std::size_t i = 2U; i < count; i++)
+            {
+                index_stock.emplace_back(corner_stock[0U]);
+                index_stock.emplace_back(corner_stock[i - 1U]);
+                index_stock.emplace_back(corner_stock[i]);
+            }
+        }
+    }
+
+    if (invalid > 0U)
+    {
+        std::cerr << "warning: skipped " << invalid << " PLY faces with less than three vertices or invalid indices in `" << model_data->model_path << "'" << std::endl;
+    }
+
+    return true;
+}
+
+bool PLYLoader::skipElement(const PLYLoader::Element &element, const char *&cursor, const char *const end) const
+{
+    if (element.stride > 0U)
+    {
+        if (static_cast<std::size_t>(end - cursor) / element.stride < element.count)
+        {
+            std::cerr << "error: the PLY element `" << element.name << "' of `" << model_data->model_path << "' is truncated" << std::endl;
+            return false;
+        }
+
+        cursor += element.stride * element.count;
+        return true;
+    }
+
+    for (std::size_t row = 0U; row < element.count; row++)
+    {
+        for (const PLYLoader::Property &property : element.property_stock)
+        {
+            std::size_t size = PLYLoader::getTypeSize(property.type);
+
+            if (property.list)
+            {
+                if (static_cast<std::size_t>(end - cursor) < PLYLoader::getTypeSize(property.count_type))
+                {
+                    std::cerr << "error: the PLY element `" << element.name << "' of `" << model_data->model_path << "' is truncated" << std::endl;
+                    return false;
+                }
+
+                size *= static_cast<std::size_t>(readScalar(cursor, property.count_type));
+                cursor += PLYLoader::getTypeSize(property.count_type);
+            }
+
+            if (static_cast<std::size_t>(end - cursor) < size)
+            {
+                std::cerr << "error: the PLY element `" << element.name << "' of `" << model_data->model_path << "' is truncated" << std::endl;
+                return false;
+            }
+
+            cursor += size;
+        }
+    }
+
+    return true;
+}
+
+bool PLYLoader::read()
+{
+    MappedFile file(model_data->model_path);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "error: could not open the file `" << model_data->model_path << "'" << std::endl;
+        return false;
+    }
+
+    const char *cursor = file.getData();
+    const char *const end = file.getEnd();
+
+    if (!readHeader(cursor, end))
+    {
+        return false;
+    }
+
+    bool vertices = false;
+    bool faces = false;
+
+    for (const PLYLoader::Element &element : element_stock)
+    {
+        bool status;
+
+        if ((element.name == "vertex") && !vertices)
+        {
+            status = readVertices(element, cursor, end);
+            vertices = true;
+        }
+
+        else if ((element.name == "face") && vertices && !faces)
+        {
+            status = readFaces(element, cursor, end);
+            faces = true;
+        }
+
+        else
+        {
+            status = skipElement(element, cursor, end);
+        }
+
+        if (!status)
+        {
+            vertex_stock.clear();
+            index_stock.clear();
+            return false;
+        }
+    }
+
+    // Missing normals are made from the faces once they are all read
+    if (!normals)
+    {
+        calcNormals(0U, 0U);
+    }
+
+    finishRead(vertex_stock.size());
+    return true;
+}
+
+/** PLY files have no material libraries, the model is drawn with the default material */
+bool PLYLoader::readMaterial(const std::string &)
+{
+    return false;
+}
\ No newline at end of file
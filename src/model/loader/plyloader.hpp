@@ -0,0 +1,63 @@
+#ifndef __PLY_LOADER_HPP_
+#define __PLY_LOADER_HPP_
+#include "modelloader.hpp"
+#include <string>
+#include <vector>
+
+/** Binary little and big endian PLY reader, the vertex and face elements are read straight from the mapped file */
+class PLYLoader : public ModelLoader
+{
+private:
+    /** Scalar type of a property or of a list count */
+    enum Type
+    {
+        CHAR,
+        UCHAR,
+        SHORT,
+        USHORT,
+        INT,
+        UINT,
+        FLOAT,
+        DOUBLE,
+        INVALID
+    };
+
+    /** Element property, lists store their count before the items */
+    struct Property
+    {
+        std::string name;
+        PLYLoader::Type type;
+        PLYLoader::Type count_type;
+        bool list;
+    };
+
+    /** Block of rows declared in the header, the stride is zero when a list makes the rows variable */
+    struct Element
+    {
+        std::string name;
+        std::size_t count;
+        std::size_t stride;
+        std::vector<PLYLoader::Property> property_stock;
+    };
+
+    bool swap;
+    bool normals;
+    std::vector<PLYLoader::Element> element_stock;
+    PLYLoader() = delete;
+    PLYLoader(const PLYLoader &) = delete;
+    PLYLoader &operator=(const PLYLoader &) = delete;
+    bool readHeader(const char *&cursor, const char *const end);
+    bool readVertices(const PLYLoader::Element &element, const char *&cursor, const char *const end);
+    bool readFaces(const PLYLoader::Element &element, const char *&cursor, const char *const end);
+    bool skipElement(const PLYLoader::Element &element, const char *&cursor, const char *const end) const;
+    bool read();
+    bool readMaterial(const std::string &path);
+    double readScalar(const char *const source, const PLYLoader::Type &type) const;
+    static PLYLoader::Type parseType(const std::string &name);
+    static std::size_t getTypeSize(const PLYLoader::Type &type);
+
+public:
+    PLYLoader(const std::string &path);
+};
+
+#endif
\ No newline at end of file
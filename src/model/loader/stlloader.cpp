@@ -0,0 +1,199 @@
+#include "stlloader.hpp"
+#include "mappedfile.hpp"
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+const std::size_t STLLoader::HEADER_SIZE = 84U;
+const std::size_t STLLoader::TRIANGLE_SIZE = 50U;
+const float STLLoader::CREASE_COSINE = 0.7071F;
+
+STLLoader::STLLoader(const std::string &path) : ModelLoader(path) {}
+
+/**
+ * Splits the corners sharing a position into vertices whose faces are at most 45 degrees apart, then gives each
+ * vertex the area weighted normal of its faces. The vertices are renumbered by first use so fetches stay local.
+ */
+void STLLoader::weldNormals(const std::vector<glm::vec3> &face_stock)
+{
+    const std::size_t positions = position_stock.size();
+    std::vector<std::size_t> first_stock(positions + 1U, 0U);
+    std::vector<std::size_t> corner_stock(index_stock.size());
+
+    for (const GLsizei index : index_stock)
+    {
+        first_stock[index + 1U]++;
+    }
+
+    for (std::size_t i = 0U; i < positions; i++)
+    {
+        first_stock[i + 1U] += first_stock[i];
+    }
+
+    std::vector<std::size_t> fill_stock(first_stock.begin(), first_stock.end() - 1);
+
+    for (std::size_t i = 0U; i < index_stock.size(); i++)
+    {
+        corner_stock[fill_stock[index_stock[i]]++] = i;
+    }
+
+    std::vector<glm::vec3> seed_stock;
+    std::vector<ModelLoader::Vertex> welded_stock;
+    welded_stock.reserve(positions);
+    seed_stock.reserve(positions);
+
+    for (std::size_t position = 0U; position < positions; position++)
+    {
+        const std::size_t begin = welded_stock.size();
+
+        for (std::size_t i = first_stock[position]; i < first_stock[position + 1U]; i++)
+        {
+            const std::size_t corner = corner_stock[i];
+            const glm::vec3 &normal = face_stock[corner / 3U];
+            const float length = glm::length(normal);
+            const glm::vec3 unit = length > 0.0F ? normal / length : normal;
+            std::size_t vertex = begin;
+
+            // Faces without a direction join any vertex, and a vertex without one takes the first it meets
+            while ((vertex < welded_stock.size()) && (length > 0.0F) && (glm::dot(seed_stock[vertex], seed_stock[vertex]) > 0.0F) &&
+                   (glm::dot(seed_stock[vertex], unit) < STLLoader::CREASE_COSINE))
+            {
+                vertex++;
+            }
+
+            if (vertex == welded_stock.size())
+            {
+                welded_stock.emplace_back();
+                welded_stock.back().position = position_stock[position];
+                seed_stock.emplace_back(unit);
+            }
+
+            else if (glm::dot(seed_stock[vertex], seed_stock[vertex]) == 0.0F)
+            {
+                seed_stock[vertex] = unit;
+            }
+
+            welded_stock[vertex].normal += normal;
+            index_stock[corner] = static_cast<GLsizei>(vertex);
+        }
+    }
+
+    std::vector<GLsizei> remap_stock(welded_stock.size(), -1);
+    vertex_stock.clear();
+    vertex_stock.reserve(welded_stock.size());
+
+    for (GLsizei &index : index_stock)
+    {
+        if (remap_stock[index] < 0)
+        {
+            ModelLoader::Vertex &vertex = welded_stock[index];
+            const float length = glm::length(vertex.normal);
+
+            vertex.normal = length > 0.0F ? vertex.normal / length : vertex.normal;
+            remap_stock[index] = static_cast<GLsizei>(vertex_stock.size());
+            vertex_stock.emplace_back(vertex);
+        }
+
+        index = remap_stock[index];
+    }
+}
+
+bool STLLoader::read()
+{
+    MappedFile file(model_data->model_path);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "error: could not open the file `" << model_data->model_path << "'" << std::endl;
+        return false;
+    }
+
+    const char *cursor = file.getData();
+    const bool swap = !ModelLoader::isLittleEndian();
+    std::uint32_t triangles = 0U;
+
+    if (file.getSize() >= STLLoader::HEADER_SIZE)
+    {
+        ModelLoader::readBinary(cursor + STLLoader::HEADER_SIZE - sizeof(triangles), &triangles, sizeof(triangles), swap);
+    }
+
+    // An ASCII file starts with `solid' too, but its size never matches the triangle count
+    if ((file.getSize() < STLLoader::HEADER_SIZE) || ((file.getSize() - STLLoader::HEADER_SIZE) / STLLoader::TRIANGLE_SIZE < triangles))
+    {
+        if ((file.getSize() >= 5U) && (std::strncmp(cursor, "solid", 5U) == 0))
+        {
+            std::cerr << "error: ASCII STL files are not supported, `" << model_data->model_path << "' must be binary" << std::endl;
+        }
+
+        else
+        {
+            std::cerr << "error: the STL file `" << model_data->model_path << "' is truncated" << std::endl;
+        }
+
+        return false;
+    }
+
+    std::vector<glm::vec3> face_stock(triangles);
+    index_stock.resize(3U * triangles);
+    vertex_map.reserve(triangles / 2U);
+    cursor += STLLoader::HEADER_SIZE;
+
+    for (std::size_t i = 0U; i < triangles; i++, cursor += STLLoader::TRIANGLE_SIZE)
+    {
+        float value[12];
+        std::memcpy(value, cursor, sizeof(value));
+
+        for (std::size_t j = 0U; swap && (j < 12U); j++)
+        {
+            ModelLoader::readBinary(cursor + sizeof(float) * j, &value[j], sizeof(float), swap);
+        }
+
+        glm::vec3 corner[3];
+
+        for (std::size_t j = 0U; j < 3U; j++)
+        {
+            // Adding zero folds -0 into 0, so both weld to the same position
+            corner[j] = glm::vec3(value[3U * j + 3U], value[3U * j + 4U], value[3U * j + 5U]) + 0.0F;
+
+            GLint key[3];
+            std::memcpy(key, &corner[j], sizeof(key));
+
+            const GLsizei new_index = static_cast<GLsizei>(position_stock.size());
+            const GLsizei index = vertex_map.emplace(key, new_index);
+
+            if (index == new_index)
+            {
+                position_stock.emplace_back(corner[j]);
+                model_data->min = glm::min(model_data->min, corner[j]);
+                model_data->max = glm::max(model_data->max, corner[j]);
+            }
+
+            index_stock[3U * i + j] = index;
+        }
+
+        // The stored normal is only trusted for degenerate triangles, whose area gives no direction
+        face_stock[i] = glm::cross(corner[1] - corner[0], corner[2] - corner[0]);
+
+        if (glm::dot(face_stock[i], face_stock[i]) == 0.0F)
+        {
+            face_stock[i] = glm::vec3(value[0], value[1], value[2]);
+        }
+    }
+
+    weldNormals(face_stock);
+    finishRead(position_stock.size());
+
+    vertex_map.clear();
+    position_stock.clear();
+
+    return true;
+}
+
+/** STL files have no material libraries, the model is drawn with the default material */
+bool STLLoader::readMaterial(const std::string &)
+{
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef __STL_LOADER_HPP_
+#define __STL_LOADER_HPP_
+#include "modelloader.hpp"
+#include "vertexmap.hpp"
+#include <string>
+
+/** Binary STL reader, the unindexed triangles are welded by position and get smooth normals within a crease angle */
+class STLLoader : public ModelLoader
+{
+private:
+    VertexMap vertex_map;
+    STLLoader() = delete;
+    STLLoader(const STLLoader &) = delete;
+    STLLoader &operator=(const STLLoader &) = delete;
+    void weldNormals(const std::vector<glm::vec3> &face_stock);
+    bool read();
+    bool readMaterial(const std::string &path);
+    static const std::size_t HEADER_SIZE;
+    static const std::size_t TRIANGLE_SIZE;
+    static const float CREASE_COSINE;
+
+public:
+    STLLoader(const std::string &path);
+};
+
+#endif
\ No newline at end of file
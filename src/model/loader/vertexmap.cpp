@@ -0,0 +1,95 @@
+#include "vertexmap.hpp"
+#include <cstdint>
+
+VertexMap::VertexMap() : mask(0U),
+                         count(0U) {}
+
+std::size_t VertexMap::hash(const GLint (&key)[3])
+{
+    // Multiplicative mix of the three indices, the high bits are folded back into the low ones
+    std::uint64_t value = static_cast<std::uint32_t>(key[0]) * 0x9E3779B97F4A7C15ULL;
+    value ^= static_cast<std::uint32_t>(key[1]) * 0xC2B2AE3D27D4EB4FULL;
+    value ^= static_cast<std::uint32_t>(key[2]) * 0x165667B19E3779F9ULL;
+    value ^= value >> 29U;
+
+    return static_cast<std::size_t>(value ^ (value >> 32U));
+}
+
+void VertexMap::rehash(const std::size_t &capacity)
+{
+    std::vector<VertexMap::Slot> old_stock(capacity, VertexMap::Slot{{0, 0, 0}, -1});
+    old_stock.swap(slot_stock);
+    mask = capacity - 1U;
+
+    for (const VertexMap::Slot &slot : old_stock)
+    {
+        if (slot.value < 0)
+        {
+            continue;
+        }
+
+        std::size_t position = VertexMap::hash(slot.key) & mask;
+        while (slot_stock[position].value >= 0)
+        {
+            position = (position + 1U) & mask;
+        }
+
+        slot_stock[position] = slot;
+    }
+}
+
+void VertexMap::reserve(const std::size_t &elements)
+{
+    // Keep the load factor at or below one half
+    std::size_t capacity = 16U;
+    while (capacity < (elements * 2U))
+    {
+        capacity <<= 1U;
+    }
+
+    if (capacity > slot_stock.size())
+    {
+        rehash(capacity);
+    }
+}
+
+GLsizei VertexMap::emplace(const GLint (&key)[3], const GLsizei &value)
+{
+    if (((count + 1U) * 2U) > slot_stock.size())
+    {
+        reserve(count + 1U);
+    }
+
+    std::size_t position = VertexMap::hash(key) & mask;
+
+    for (;;)
+    {
+        VertexMap::Slot &slot = slot_stock[position];
+
+        if (slot.value < 0)
+        {
+            slot = VertexMap::Slot{{key[0], key[1], key[2]}, value};
+            count++;
+            return value;
+        }
+
+        if ((slot.key[0] == key[0]) && (slot.key[1] == key[1]) && (slot.key[2] == key[2]))
+        {
+            return slot.value;
+        }
+
+        position = (position + 1U) & mask;
+    }
+}
+
+std::size_t VertexMap::size() const
+{
+    return count;
+}
+
+void VertexMap::clear()
+{
+    std::vector<VertexMap::Slot>().swap(slot_stock);
+    mask = 0U;
+    count = 0U;
+}
\ No newline at end of file
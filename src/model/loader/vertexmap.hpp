@@ -0,0 +1,35 @@
+#ifndef __VERTEX_MAP_HPP_
+#define __VERTEX_MAP_HPP_
+#include "../../glad/glad.h"
+#include <cstddef>
+#include <vector>
+
+/** Open addressing hash map from position/uv/normal index triplets to vertex indices */
+class VertexMap
+{
+private:
+    /** Table entry, empty while the value is negative */
+    struct Slot
+    {
+        GLint key[3];
+        GLsizei value;
+    };
+
+    std::vector<Slot> slot_stock;
+    std::size_t mask;
+    std::size_t count;
+
+    VertexMap(const VertexMap &) = delete;
+    VertexMap &operator=(const VertexMap &) = delete;
+    void rehash(const std::size_t &capacity);
+    static std::size_t hash(const GLint (&key)[3]);
+
+public:
+    VertexMap();
+    void reserve(const std::size_t &elements);
+    GLsizei emplace(const GLint (&key)[3], const GLsizei &value);
+    std::size_t size() const;
+    void clear();
+};
+
+#endif
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include "material.hpp"
+#include "texturecache.hpp"
+#include "textureresidency.hpp"
+#include "texturestream.hpp"
 #define STBI_ASSERT(x)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
+#include <algorithm>
 #include <iostream>
 
 const Material::Attribute Material::TEXTURE_ATTRIBUTE[] = {
@@ -44,28 +48,21 @@ void Material::bindTexture(const GLenum &index, const GLuint &texture)
     glBindTexture(GL_TEXTURE_2D, texture);
 }
 
-GLuint Material::load2DTexture(const std::string &path)
+/**
+ * Creates the texture of a decoded image, unless its key was uploaded meanwhile, staging the texels through the
+ * upload ring. The whole mip chain is uploaded as it is, or only its tail when streamed. `bytes' counts the texels uploaded, as stored on the GPU.
+ */
+GLuint Material::upload2DTexture(const TextureCache::Image &image, std::size_t &bytes)
 {
+    bytes = 0U;
+    GLuint texture = TextureCache::acquire(image.key);
+    const TextureCodec::Chain &chain = image.chain;
 
-    if (path.empty())
+    if ((texture != GL_FALSE) || chain.data.empty())
     {
-        return GL_FALSE;
+        return texture;
     }
 
-    int width;
-    int height;
-    int channels;
-
-    stbi_set_flip_vertically_on_load(true);
-    stbi_uc *data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-
-    if (data == nullptr)
-    {
-        std::cerr << "error: could not open the texture `" << path << "'" << std::endl;
-        return GL_FALSE;
-    }
-
-    GLuint texture;
     glGenTextures(1, &texture);
     glBindTexture(GL_TEXTURE_2D, texture);
 
@@ -74,34 +71,112 @@ GLuint Material::load2DTexture(const std::string &path)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    if (TextureResidency::isEnabled())
+    {
+        bytes = TextureResidency::insert(texture, chain);
+    }
 
-    stbi_image_free(data);
+    else
+    {
+        const GLint levels = static_cast<GLint>(chain.level_stock.size()) - 1;
+
+        for (GLint i = 0; i < levels; i++)
+        {
+            TextureStream::uploadLevel(GL_TEXTURE_2D, chain, i);
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        bytes = chain.data.size();
+    }
+
+    TextureCache::insert(image.key, texture);
 
     return texture;
 }
 
-GLuint Material::loadCubeMapTexture(const std::string (&path)[6])
+/**
+ * Decodes the file at `path', or the image in `encoded' when there is one, then `path' only names it.
+ * Images already uploaded are shared through the texture cache, `bytes' counts the texels uploaded.
+ */
+GLuint Material::load2DTexture(const std::string &path, const std::vector<GLubyte> &encoded, const TextureCodec::Mode &mode, std::size_t &bytes)
+{
+    bytes = 0U;
+
+    if (path.empty() && encoded.empty())
+    {
+        return GL_FALSE;
+    }
+
+    const std::string key = Material::getTextureKey(path, encoded, mode);
+    const GLuint texture = TextureCache::acquire(key);
+
+    if (texture != GL_FALSE)
+    {
+        return texture;
+    }
+
+    const std::shared_ptr<TextureCache::Image> image = TextureCache::decode(key, path, encoded, STBI_rgb_alpha, mode);
+    image->done.wait();
+
+    return Material::upload2DTexture(*image, bytes);
+}
+
+/** Diffuse and specular maps are compressed as colors and normal maps keep two channels, the rest stay RGBA */
+TextureCodec::Mode Material::getCodecMode(const Material::Attribute &attrib)
+{
+    if (!TextureCodec::isEnabled())
+    {
+        return TextureCodec::NONE;
+    }
+
+    switch (attrib)
+    {
+    case Material::DIFFUSE:
+    case Material::SPECULAR:
+        return TextureCodec::COLOR;
+    case Material::NORMAL:
+        return TextureCodec::NORMAL;
+
+    default:
+        return TextureCodec::NONE;
+    }
+}
+
+/** The same image compressed or not makes different textures, so the mode is part of its key */
+std::string Material::getTextureKey(const std::string &path, const std::vector<GLubyte> &encoded, const TextureCodec::Mode &mode)
 {
-    int width[6] = {1};
-    int height[6] = {1};
-    int channels[6];
+    const std::string key = TextureCache::getKey(path, encoded);
 
-    stbi_set_flip_vertically_on_load(true);
-    stbi_uc *data[6];
+    return key.empty() || (mode == TextureCodec::NONE) ? key : key + '\n' + std::to_string(mode);
+}
+
+/** The six sides are decoded in parallel, but the map is uploaded before returning */
+GLuint Material::loadCubeMapTexture(const std::string (&path)[6], std::size_t &bytes)
+{
+    std::string key;
 
+    // The six sides make up a single key, a missing side keeps the map unshared
     for (int i = 0; i < 6; i++)
     {
-        data[i] = stbi_load(path[i].c_str(), &width[i], &height[i], &channels[i], STBI_rgb);
+        const std::string side = TextureCache::getKey(path[i], std::vector<GLubyte>());
+        key = side.empty() || ((i > 0) && key.empty()) ? std::string() : key + side + '\n';
+    }
 
-        if (data[i] == nullptr)
-        {
-            std::cerr << "error: could not open the texture `" << path << "' (cube side " << i << ")" << std::endl;
-        }
+    bytes = 0U;
+    GLuint texture = TextureCache::acquire(key);
+
+    if (texture != GL_FALSE)
+    {
+        return texture;
+    }
+
+    std::shared_ptr<TextureCache::Image> image[6];
+
+    for (int i = 0; i < 6; i++)
+    {
+        image[i] = TextureCache::decode(std::string(), path[i], std::vector<GLubyte>(), STBI_rgb);
     }
 
-    GLuint texture;
     glGenTextures(1, &texture);
     glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
 
@@ -113,14 +188,17 @@ GLuint Material::loadCubeMapTexture(const std::string (&path)[6])
 
     for (GLint i = 0; i < 6; i++)
     {
-        if (data[i] != nullptr)
+        image[i]->done.wait();
+
+        if (image[i]->pixels != nullptr)
         {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width[i], height[i], 0, GL_RGB, GL_UNSIGNED_BYTE, data[i]);
-            stbi_image_free(data[i]);
+            TextureStream::texImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, image[i]->width, image[i]->height, GL_RGB, 3U, image[i]->pixels);
+            bytes += static_cast<std::size_t>(image[i]->width) * static_cast<std::size_t>(image[i]->height) * 3U;
         }
     }
 
     glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    TextureCache::insert(key, texture);
 
     return texture;
 }
@@ -252,6 +330,20 @@ bool Material::isTextureEnabled(const Material::Attribute &attrib) const
     }
 }
 
+/** Whether the material has its own texture loaded and enabled, the default ones do not count */
+bool Material::hasTexture(const Material::Attribute &attrib) const
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (attrib == Material::TEXTURE_ATTRIBUTE[i])
+        {
+            return (texture[i] != GL_FALSE) && texture_enabled[i];
+        }
+    }
+
+    return (attrib & Material::CUBE_MAP) && (texture[6] != GL_FALSE) && texture_enabled[6];
+}
+
 std::string Material::getTexturePath(const Material::Attribute &attrib) const
 {
     switch (attrib)
@@ -381,8 +473,17 @@ void Material::setTextureEnabled(const Material::Attribute &attrib, const bool &
     }
 }
 
-void Material::setTexturePath(const Material::Attribute &attrib, const std::string &path)
+void Material::setTexturePath(const Material::Attribute &attrib, const std::string &path, const bool &reload)
 {
+    for (int i = 0; i < 6; i++)
+    {
+        if (attrib == Material::TEXTURE_ATTRIBUTE[i])
+        {
+            texture_data[i].clear();
+            texture_image[i].reset();
+        }
+    }
+
     switch (attrib)
     {
     case Material::AMBIENT:
@@ -426,37 +527,98 @@ void Material::setTexturePath(const Material::Attribute &attrib, const std::stri
         return;
     }
 
-    reloadTexture(attrib);
+    if (reload)
+    {
+        reloadTexture(attrib);
+    }
+}
+
+/** Sets an image embedded in the model file, still encoded, `name' is shown as its path */
+void Material::setTextureData(const Material::Attribute &attrib, const std::string &name, const std::vector<GLubyte> &data, const bool &reload)
+{
+    setTexturePath(attrib, name, false);
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (attrib == Material::TEXTURE_ATTRIBUTE[i])
+        {
+            texture_data[i] = data;
+        }
+    }
+
+    if (reload)
+    {
+        reloadTexture(attrib);
+    }
 }
 
-void Material::setCubeMapTexturePath(const std::string (&path)[6])
+void Material::setCubeMapTexturePath(const std::string (&path)[6], const bool &reload)
 {
     for (int i = 6, j = 1; j < 6; j++)
     {
         texture_path[i] = path[j];
     }
 
-    reloadTexture(Material::CUBE_MAP);
+    if (reload)
+    {
+        reloadTexture(Material::CUBE_MAP);
+    }
 }
 
-void Material::reloadTexture(const Material::Attribute &attrib)
+/** Returns the number of texel bytes uploaded, textures found in the cache cost nothing */
+std::size_t Material::reloadTexture(const Material::Attribute &attrib)
 {
+    std::size_t total = 0U;
+    std::size_t bytes;
+
     for (int i = 0; i < 6; i++)
     {
         if (attrib & Material::TEXTURE_ATTRIBUTE[i])
         {
-            glDeleteTextures(1, &texture[i]);
-            texture[i] = Material::load2DTexture(texture_path[i]);
+            const GLuint old_texture = texture[i];
+            texture_image[i].reset();
+            texture[i] = Material::load2DTexture(texture_path[i], texture_data[i], Material::getCodecMode(Material::TEXTURE_ATTRIBUTE[i]), bytes);
+            TextureCache::release(old_texture);
+            total += bytes;
         }
     }
 
     if (attrib & Material::CUBE_MAP)
     {
-        glDeleteTextures(1, &texture[6]);
-        texture[6] = Material::loadCubeMapTexture({texture_path[6], texture_path[7], texture_path[8], texture_path[9], texture_path[10], texture_path[11]});
+        const GLuint old_texture = texture[6];
+        texture[6] = Material::loadCubeMapTexture({texture_path[6], texture_path[7], texture_path[8], texture_path[9], texture_path[10], texture_path[11]}, bytes);
+        TextureCache::release(old_texture);
+        total += bytes;
     }
+
+    return total;
 }
 
+/** Asks for the streamed levels of the enabled textures, `pixels' is about their size on screen */
+void Material::requestTextures(const float &pixels) const
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if ((texture[i] != GL_FALSE) && texture_enabled[i])
+        {
+            TextureResidency::request(texture[i], pixels);
+        }
+    }
+}
+
+/** Writes the colors and values of the material block, only uploaded when one of them changed */
+void Material::updateBlock()
+{
+    const Material::MaterialBlock data = {glm::vec4(color[0], value[0]),
+                                          glm::vec4(color[1], value[1]),
+                                          glm::vec4(color[2], value[2]),
+                                          glm::vec4(color[3], 1.0F - value[3]),
+                                          glm::vec4(value[4], value[5], 0.0F, 0.0F)};
+
+    block.update(&data, sizeof(data));
+}
+
+/** Binds the block written by `updateBlock' and the textures, their units are set by `bindUnits' when the program links */
 void Material::bind(GLSLProgram *const program) const
 {
     if ((program == nullptr) || (!program->isValid()))
@@ -465,25 +627,7 @@ void Material::bind(GLSLProgram *const program) const
     }
 
     program->use();
-    program->setUniform("u_ambient", color[0]);
-    program->setUniform("u_diffuse", color[1]);
-    program->setUniform("u_specular", color[2]);
-    program->setUniform("u_transmision", color[3]);
-
-    program->setUniform("u_shininess", value[0]);
-    program->setUniform("u_roughness", value[1]);
-    program->setUniform("u_metalness", value[2]);
-    program->setUniform("u_alpha", (1.0F - value[3]));
-    program->setUniform("u_displacement", value[4]);
-    program->setUniform("u_refractive_index", value[5]);
-
-    program->setUniform("u_ambient_tex", 0);
-    program->setUniform("u_diffuse_tex", 1);
-    program->setUniform("u_specular_tex", 2);
-    program->setUniform("u_shininess_tex", 3);
-    program->setUniform("u_normal_tex", 4);
-    program->setUniform("u_displacement_tex", 5);
-    program->setUniform("u_cube_map_tex", 6);
+    block.bind(UniformBlock::MATERIAL);
 
     Material::bindTexture(0U, (texture[0] == GL_FALSE) || !texture_enabled[0] ? Material::default_texture[0] : texture[0]);
     Material::bindTexture(1U, (texture[1] == GL_FALSE) || !texture_enabled[1] ? Material::default_texture[0] : texture[1]);
@@ -494,9 +638,88 @@ void Material::bind(GLSLProgram *const program) const
     Material::bindTexture(6U, texture[6]);
 }
 
+/**
+ * Queues the decode of the textures whose path was set without reloading them, and returns at once.
+ * Textures already in the cache only get a placeholder, so they are not decoded again.
+ */
+void Material::decodeTextures()
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if ((texture[i] == GL_FALSE) && (texture_image[i] == nullptr) && !texture_path[i].empty())
+        {
+            const TextureCodec::Mode mode = Material::getCodecMode(Material::TEXTURE_ATTRIBUTE[i]);
+            texture_image[i] = TextureCache::decode(Material::getTextureKey(texture_path[i], texture_data[i], mode), texture_path[i], texture_data[i], STBI_rgb_alpha, mode);
+        }
+    }
+}
+
+bool Material::hasPendingTextures() const
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (texture_image[i] != nullptr)
+        {
+            return true;
+        }
+    }
+
+    return (texture[6] == GL_FALSE) && !texture_path[6].empty();
+}
+
+/**
+ * Uploads the queued textures whose decode is done, or waits for all of them when `wait' is set, which also
+ * loads the textures never queued. Returns the number of texel bytes uploaded, so callers can spread the work
+ * over several frames. The cube map is loaded whole once the other textures are done.
+ */
+std::size_t Material::loadTextures(const bool &wait)
+{
+    std::size_t total = 0U;
+    std::size_t bytes;
+    bool decoding = false;
+
+    if (wait)
+    {
+        decodeTextures();
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        if ((texture_image[i] == nullptr) || (!wait && !texture_image[i]->isReady()))
+        {
+            decoding = decoding || (texture_image[i] != nullptr);
+            continue;
+        }
+
+        const std::shared_ptr<TextureCache::Image> image = texture_image[i];
+        texture_image[i].reset();
+        image->done.wait();
+
+        texture[i] = Material::upload2DTexture(*image, bytes);
+        total += bytes;
+
+        // The cached texture was released since the placeholder was made
+        if ((texture[i] == GL_FALSE) && !image->decoded)
+        {
+            total += reloadTexture(Material::TEXTURE_ATTRIBUTE[i]);
+        }
+    }
+
+    if ((texture[6] == GL_FALSE) && !texture_path[6].empty() && !decoding)
+    {
+        total += reloadTexture(Material::CUBE_MAP);
+    }
+
+    return total;
+}
+
 Material::~Material()
 {
-    glDeleteTextures(6, &texture[0]);
+    // Materials read on a worker thread are destroyed without textures and without a context
+    for (int i = 0; i < 7; i++)
+    {
+        TextureCache::release(texture[i]);
+    }
 }
 
 void Material::createDefaultTextures()
@@ -513,8 +736,8 @@ void Material::createDefaultTextures()
 
     if (Material::default_texture[1] == GL_FALSE)
     {
-        color[0] = 0U;
-        color[1] = 0U;
+        color[0] = 128U;
+        color[1] = 128U;
         color[2] = 255U;
         Material::default_texture[1] = Material::createDefaultTexture(color);
     }
@@ -535,4 +758,16 @@ void Material::deleteDefaultTextures()
     Material::default_texture[0] = GL_FALSE;
     Material::default_texture[1] = GL_FALSE;
     Material::default_texture[2] = GL_FALSE;
+}
+
+/** Units of the material textures, set when a program links, the lighting pass sets its own units every frame */
+void Material::bindUnits(GLSLProgram *const program)
+{
+    program->setUniform("u_ambient_tex", 0);
+    program->setUniform("u_diffuse_tex", 1);
+    program->setUniform("u_specular_tex", 2);
+    program->setUniform("u_shininess_tex", 3);
+    program->setUniform("u_normal_tex", 4);
+    program->setUniform("u_displacement_tex", 5);
+    program->setUniform("u_cube_map_tex", 6);
 }
\ No newline at end of file
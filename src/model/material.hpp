@@ -1,10 +1,15 @@
 #ifndef __MATERIAL_HPP_
 #define __MATERIAL_HPP_
 
+#include "texturecache.hpp"
 #include "../scene/glslprogram.hpp"
+#include "../scene/uniformblock.hpp"
 #include "../glad/glad.h"
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 
 class Material {
     public:
@@ -30,41 +35,64 @@ class Material {
         };
 
     private:
+        /** Layout of the std140 material block */
+        struct MaterialBlock {
+            glm::vec4 ambient_shininess;
+            glm::vec4 diffuse_roughness;
+            glm::vec4 specular_metalness;
+            glm::vec4 transmision_alpha;
+            glm::vec4 displacement_refractive_index;
+        };
+
         std::string name;
         glm::vec3 color[4];
         float value[6];
         GLuint texture[7];
         bool texture_enabled[7];
         std::string texture_path[12];
+        std::vector<GLubyte> texture_data[6];
+        std::shared_ptr<TextureCache::Image> texture_image[6];
+        UniformBlock block;
         Material() = delete;
         Material(const Material &) = delete;
         Material &operator=(const Material &) = delete;
-        static const Material::Attribute TEXTURE_ATTRIBUTE[];
         static GLuint default_texture[3];
         static GLuint createDefaultTexture(const GLubyte *const color);
         static void bindTexture(const GLenum &index, const GLuint &texture);
-        static GLuint load2DTexture(const std::string &path);
-        static GLuint loadCubeMapTexture(const std::string (&path)[6]);
+        static GLuint upload2DTexture(const TextureCache::Image &image, std::size_t &bytes);
+        static GLuint load2DTexture(const std::string &path, const std::vector<GLubyte> &encoded, const TextureCodec::Mode &mode, std::size_t &bytes);
+        static TextureCodec::Mode getCodecMode(const Material::Attribute &attrib);
+        static std::string getTextureKey(const std::string &path, const std::vector<GLubyte> &encoded, const TextureCodec::Mode &mode);
+        static GLuint loadCubeMapTexture(const std::string (&path)[6], std::size_t &bytes);
 
     public:
+        static const Material::Attribute TEXTURE_ATTRIBUTE[];
         Material(const std::string &name);
         std::string getName() const;
         glm::vec3 getColor(const Material::Attribute &attrib) const;
         float getValue(const Material::Attribute &attrib) const;
         GLuint getTexture(const Material::Attribute &attrib) const;
         bool isTextureEnabled(const Material::Attribute &attrib) const;
+        bool hasTexture(const Material::Attribute &attrib) const;
         std::string getTexturePath(const Material::Attribute &attrib) const;
         void setName(const std::string &new_name);
         void setColor(const Material::Attribute &attrib, const glm::vec3 &new_color);
         void setValue(const Material::Attribute &attrib, const float &new_value);
         void setTextureEnabled(const Material::Attribute &attrib, const bool &status);
-        void setTexturePath(const Material::Attribute &attrib, const std::string &path);
-        void setCubeMapTexturePath(const std::string (&path)[6]);
-        void reloadTexture(const Material::Attribute &attrib);
+        void setTexturePath(const Material::Attribute &attrib, const std::string &path, const bool &reload = true);
+        void setTextureData(const Material::Attribute &attrib, const std::string &name, const std::vector<GLubyte> &data, const bool &reload = true);
+        void setCubeMapTexturePath(const std::string (&path)[6], const bool &reload = true);
+        std::size_t reloadTexture(const Material::Attribute &attrib);
+        void decodeTextures();
+        bool hasPendingTextures() const;
+        std::size_t loadTextures(const bool &wait = true);
+        void requestTextures(const float &pixels) const;
+        void updateBlock();
         void bind(GLSLProgram *const program) const;
         virtual ~Material();
         static void createDefaultTextures();
         static void deleteDefaultTextures();
+        static void bindUnits(GLSLProgram *const program);
 };
 
 #endif 
\ No newline at end of file
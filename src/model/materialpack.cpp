@@ -0,0 +1,362 @@
+#include "materialpack.hpp"
+#include "textureresidency.hpp"
+#include <algorithm>
+#include <cmath>
+
+const GLchar *const MaterialPack::ARRAY_UNIFORM[6] = {"u_ambient_array", "u_diffuse_array", "u_specular_array", "u_shininess_array", "u_normal_array", "u_displacement_array"};
+
+MaterialPack::MaterialPack() : array_size(0U),
+                               buffer(GL_FALSE),
+                               buffer_texture(GL_FALSE),
+                               packed(false) {}
+
+/** A material fits a group when each of its textures has the layout of its slot, or the slot is still free */
+bool MaterialPack::fits(const MaterialPack::Group &group, const GLuint *const texture, const std::unordered_map<GLuint, MaterialPack::Layout> &layout_map)
+{
+    for (std::size_t slot = 0U; slot < 6U; slot++)
+    {
+        const MaterialPack::Layout &taken = group.layout[slot];
+
+        if ((texture[slot] == GL_FALSE) || (taken.width == 0))
+        {
+            continue;
+        }
+
+        const MaterialPack::Layout &layout = layout_map.at(texture[slot]);
+
+        if ((taken.width != layout.width) || (taken.height != layout.height) || (taken.format != layout.format) || (taken.max_level != layout.max_level))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MaterialPack::deleteArrays()
+{
+    for (const MaterialPack::Group &group : group_stock)
+    {
+        glDeleteTextures(6, group.texture_array);
+    }
+
+    group_stock.clear();
+    TextureResidency::release(array_size);
+    array_size = 0U;
+}
+
+/**
+ * Puts each material in the first group whose layouts fit its textures and packs the slots of every group. Streamed
+ * textures are made resident first, the model stops requesting them while packed so they go back to their tail.
+ */
+bool MaterialPack::packTextures(const std::size_t &materials)
+{
+    std::unordered_map<GLuint, MaterialPack::Layout> layout_map;
+
+    deleteArrays();
+    layer_stock.assign(materials * 6U, -1.0F);
+    material_group.assign(materials, 0U);
+
+    for (const GLuint texture : texture_stock)
+    {
+        if ((texture == GL_FALSE) || (layout_map.count(texture) != 0U))
+        {
+            continue;
+        }
+
+        MaterialPack::Layout &layout = layout_map[texture];
+
+        TextureResidency::makeResident(texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &layout.width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &layout.height);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &layout.format);
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &layout.max_level);
+
+        if ((layout.width == 0) || (layout.height == 0))
+        {
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0U; i < materials; i++)
+    {
+        const GLuint *const texture = &texture_stock[i * 6U];
+        std::size_t group = 0U;
+
+        while ((group < group_stock.size()) && !MaterialPack::fits(group_stock[group], texture, layout_map))
+        {
+            group++;
+        }
+
+        if (group == group_stock.size())
+        {
+            group_stock.emplace_back();
+        }
+
+        for (std::size_t slot = 0U; slot < 6U; slot++)
+        {
+            if (texture[slot] != GL_FALSE)
+            {
+                group_stock[group].layout[slot] = layout_map[texture[slot]];
+            }
+        }
+
+        material_group[i] = group;
+    }
+
+    for (std::size_t group = 0U; group < group_stock.size(); group++)
+    {
+        for (std::size_t slot = 0U; slot < 6U; slot++)
+        {
+            std::vector<GLuint> source_stock;
+            std::unordered_map<GLuint, GLint> layer_map;
+
+            for (std::size_t i = 0U; i < materials; i++)
+            {
+                const GLuint texture = texture_stock[i * 6U + slot];
+
+                if ((material_group[i] != group) || (texture == GL_FALSE))
+                {
+                    continue;
+                }
+
+                if (layer_map.count(texture) == 0U)
+                {
+                    layer_map[texture] = static_cast<GLint>(source_stock.size());
+                    source_stock.push_back(texture);
+                }
+
+                layer_stock[i * 6U + slot] = static_cast<GLfloat>(layer_map[texture]);
+            }
+
+            if (!source_stock.empty())
+            {
+                packArray(group_stock[group], slot, source_stock);
+            }
+        }
+    }
+
+    return true;
+}
+
+/** Copies the textures of a slot of the group, all with its layout, into the layers of an array with every level */
+void MaterialPack::packArray(MaterialPack::Group &group, const std::size_t &slot, const std::vector<GLuint> &source_stock)
+{
+    const MaterialPack::Layout &layout = group.layout[slot];
+    const GLint levels = std::min(static_cast<GLint>(std::log2(static_cast<float>(std::max(layout.width, layout.height)))) + 1, layout.max_level + 1);
+    const GLsizei layers = static_cast<GLsizei>(source_stock.size());
+    std::vector<GLint> level_size(static_cast<std::size_t>(levels), 0);
+    GLint compressed = GL_FALSE;
+
+    glBindTexture(GL_TEXTURE_2D, source_stock.front());
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+
+    for (GLint level = 0; compressed && (level < levels); level++)
+    {
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &level_size[level]);
+    }
+
+    glGenTextures(1, &group.texture_array[slot]);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, group.texture_array[slot]);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+    std::size_t size = 0U;
+
+    for (GLint level = 0; level < levels; level++)
+    {
+        const GLsizei level_width = std::max(layout.width >> level, 1);
+        const GLsizei level_height = std::max(layout.height >> level, 1);
+
+        if (compressed)
+        {
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, static_cast<GLenum>(layout.format), level_width, level_height, layers, 0, level_size[level] * layers, nullptr);
+            size += static_cast<std::size_t>(level_size[level]) * layers;
+        }
+
+        else
+        {
+            // The uncompressed textures are all RGBA8
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, layout.format, level_width, level_height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            size += static_cast<std::size_t>(level_width) * level_height * 4U * layers;
+        }
+    }
+
+    TextureResidency::reserve(size);
+    array_size += size;
+
+    // The array must be complete before anything is copied into it
+    for (GLint level = 0; level < levels; level++)
+    {
+        for (GLint layer = 0; layer < layers; layer++)
+        {
+            glCopyImageSubData(source_stock[layer], GL_TEXTURE_2D, level, 0, 0, 0, group.texture_array[slot], GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, std::max(layout.width >> level, 1), std::max(layout.height >> level, 1), 1);
+        }
+    }
+}
+
+/** Writes the rows the shaders read for each material, only uploaded when a value changed */
+void MaterialPack::packRows(const std::vector<Material *> &material_stock)
+{
+    std::vector<glm::vec4> new_row_stock;
+    new_row_stock.reserve(material_stock.size() * MaterialPack::ROW_SIZE);
+
+    for (std::size_t i = 0U; i < material_stock.size(); i++)
+    {
+        const Material *const material = material_stock[i];
+        const GLfloat *const layer = &layer_stock[i * 6U];
+
+        new_row_stock.emplace_back(material->getColor(Material::AMBIENT), 1.0F - material->getValue(Material::TRANSPARENCY));
+        new_row_stock.emplace_back(material->getColor(Material::DIFFUSE), material->getValue(Material::SHININESS));
+        new_row_stock.emplace_back(material->getColor(Material::SPECULAR), material->getValue(Material::ROUGHNESS));
+        new_row_stock.emplace_back(material->getValue(Material::METALNESS), material->getValue(Material::DISPLACEMENT), material->getValue(Material::REFRACTIVE_INDEX), 0.0F);
+        new_row_stock.emplace_back(layer[0], layer[1], layer[2], layer[3]);
+        new_row_stock.emplace_back(layer[4], layer[5], 0.0F, 0.0F);
+    }
+
+    if (new_row_stock == row_stock)
+    {
+        return;
+    }
+
+    row_stock.swap(new_row_stock);
+
+    if (buffer == GL_FALSE)
+    {
+        glGenBuffers(1, &buffer);
+        glGenTextures(1, &buffer_texture);
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(row_stock.size() * sizeof(glm::vec4)), row_stock.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, GL_FALSE);
+
+    glBindTexture(GL_TEXTURE_BUFFER, buffer_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+}
+
+bool MaterialPack::isPacked() const
+{
+    return packed;
+}
+
+GLint MaterialPack::getIndex(const Material *const material) const
+{
+    const std::unordered_map<const Material *, GLint>::const_iterator result = index_map.find(material);
+    return result == index_map.end() ? -1 : result->second;
+}
+
+std::size_t MaterialPack::getGroup(const Material *const material) const
+{
+    const GLint index = getIndex(material);
+    return index < 0 ? 0U : material_group[static_cast<std::size_t>(index)];
+}
+
+/** Packs the materials again when their textures changed, or only their rows when a color or value did */
+void MaterialPack::update(const std::vector<Material *> &material_stock)
+{
+    if (!MaterialPack::isSupported() || material_stock.empty())
+    {
+        clear();
+        return;
+    }
+
+    std::vector<GLuint> new_texture_stock(material_stock.size() * 6U, GL_FALSE);
+    bool changed = index_map.size() != material_stock.size();
+
+    for (std::size_t i = 0U; i < material_stock.size(); i++)
+    {
+        for (std::size_t slot = 0U; slot < 6U; slot++)
+        {
+            const Material::Attribute attrib = Material::TEXTURE_ATTRIBUTE[slot];
+            new_texture_stock[i * 6U + slot] = material_stock[i]->hasTexture(attrib) ? material_stock[i]->getTexture(attrib) : GL_FALSE;
+        }
+
+        changed = changed || (getIndex(material_stock[i]) != static_cast<GLint>(i));
+    }
+
+    if (changed || (new_texture_stock != texture_stock))
+    {
+        texture_stock.swap(new_texture_stock);
+        index_map.clear();
+        row_stock.clear();
+
+        for (std::size_t i = 0U; i < material_stock.size(); i++)
+        {
+            index_map[material_stock[i]] = static_cast<GLint>(i);
+        }
+
+        // Textures that could not be read leave the model unpacked until they change
+        packed = packTextures(material_stock.size());
+    }
+
+    if (packed)
+    {
+        packRows(material_stock);
+    }
+}
+
+/** Binds the rows and the arrays of the first group */
+void MaterialPack::bind() const
+{
+    glActiveTexture(GL_TEXTURE13);
+    glBindTexture(GL_TEXTURE_BUFFER, buffer_texture);
+
+    bindGroup(0U);
+}
+
+void MaterialPack::bindGroup(const std::size_t &group) const
+{
+    for (GLenum i = 0U; i < 6U; i++)
+    {
+        glActiveTexture(GL_TEXTURE7 + i);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, group < group_stock.size() ? group_stock[group].texture_array[i] : GL_FALSE);
+    }
+}
+
+void MaterialPack::clear()
+{
+    // Nothing was created without a context
+    if (packed || (buffer != GL_FALSE))
+    {
+        deleteArrays();
+        glDeleteTextures(1, &buffer_texture);
+        glDeleteBuffers(1, &buffer);
+    }
+
+    buffer = GL_FALSE;
+    buffer_texture = GL_FALSE;
+    packed = false;
+    group_stock.clear();
+    material_group.clear();
+    texture_stock.clear();
+    layer_stock.clear();
+    row_stock.clear();
+    index_map.clear();
+}
+
+MaterialPack::~MaterialPack()
+{
+    clear();
+}
+
+bool MaterialPack::isSupported()
+{
+    return GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_copy_image;
+}
+
+/** The arrays and the buffer take their own units, samplers of different types can never share one */
+void MaterialPack::bindUnits(GLSLProgram *const program)
+{
+    for (GLint i = 0; i < 6; i++)
+    {
+        program->setUniform(MaterialPack::ARRAY_UNIFORM[i], 7 + i);
+    }
+
+    program->setUniform("u_material_buffer", 13);
+}
\ No newline at end of file
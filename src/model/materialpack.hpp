@@ -0,0 +1,73 @@
+#ifndef __MATERIAL_PACK_HPP_
+#define __MATERIAL_PACK_HPP_
+
+#include "material.hpp"
+#include "../scene/glslprogram.hpp"
+#include "../glad/glad.h"
+#include <glm/vec4.hpp>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Materials of a model packed for a single bind. The textures of each slot become the layers of a texture array
+ * and the colors, values and layers of every material are rows of a texture buffer, so each object only sets its
+ * material index. Materials whose textures differ in size or format from the others go to another group of
+ * arrays, which is bound when the drawn material changes group. The arrays hold every level, so their size is
+ * reserved from the texture residency budget.
+ */
+class MaterialPack
+{
+private:
+    /** Size and format of the textures a slot of a group takes, a zero width leaves the slot free */
+    struct Layout
+    {
+        GLint width;
+        GLint height;
+        GLint format;
+        GLint max_level;
+    };
+
+    /** Arrays of the materials sharing a layout in every slot */
+    struct Group
+    {
+        MaterialPack::Layout layout[6];
+        GLuint texture_array[6];
+    };
+
+    static const GLint ROW_SIZE = 6;
+    static const GLchar *const ARRAY_UNIFORM[6];
+
+    std::vector<MaterialPack::Group> group_stock;
+    std::vector<std::size_t> material_group;
+    std::size_t array_size;
+    GLuint buffer;
+    GLuint buffer_texture;
+    bool packed;
+    std::vector<GLuint> texture_stock;
+    std::vector<GLfloat> layer_stock;
+    std::vector<glm::vec4> row_stock;
+    std::unordered_map<const Material *, GLint> index_map;
+
+    MaterialPack(const MaterialPack &) = delete;
+    MaterialPack &operator=(const MaterialPack &) = delete;
+    static bool fits(const MaterialPack::Group &group, const GLuint *const texture, const std::unordered_map<GLuint, MaterialPack::Layout> &layout_map);
+    void deleteArrays();
+    bool packTextures(const std::size_t &materials);
+    void packArray(MaterialPack::Group &group, const std::size_t &slot, const std::vector<GLuint> &source_stock);
+    void packRows(const std::vector<Material *> &material_stock);
+
+public:
+    MaterialPack();
+    bool isPacked() const;
+    GLint getIndex(const Material *const material) const;
+    std::size_t getGroup(const Material *const material) const;
+    void update(const std::vector<Material *> &material_stock);
+    void bind() const;
+    void bindGroup(const std::size_t &group) const;
+    void clear();
+    ~MaterialPack();
+    static bool isSupported();
+    static void bindUnits(GLSLProgram *const program);
+};
+
+#endif
\ No newline at end of file
@@ -1,12 +1,25 @@
 #include "model.hpp"
 #include "../dirsep.h"
 #include "loader/modelloader.hpp"
+#include <glm/gtc/matrix_access.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
 #include <iostream>
 
 void Model::load()
 {
-    ModelData *model_data = ModelLoader::load(model_path, ModelLoader::OBJ);
+    loader = ModelLoader::loadAsync(model_path, ModelLoader::getFormat(model_path), options);
+}
+
+bool Model::update(std::size_t &budget)
+{
+    if ((loader == nullptr) || !loader->update(budget))
+    {
+        return false;
+    }
+
+    ModelData *model_data = loader->release();
+    loader.reset();
 
     model_open = model_data->model_open;
     material_open = model_data->material_open;
@@ -14,7 +27,8 @@ void Model::load()
     material_path = model_data->material_path;
 
     origin_mat = model_data->origin_mat;
-    model_origin_mat = model_mat * origin_mat;
+    position_mat = model_data->position_mat;
+    model_origin_mat = model_mat * origin_mat * position_mat;
     min = model_data->min;
     max = model_data->max;
 
@@ -24,32 +38,210 @@ void Model::load()
 
     material_stock = model_data->material_stock;
     object_stock = model_data->object_stock;
+    lod_stock = model_data->lod_stock;
+    cluster_stock = model_data->cluster_stock;
+    lod = 0U;
 
     vertices = model_data->vertices;
     elements = model_data->elements;
     triangles = model_data->triangles;
     textures = model_data->textures;
+    packed_vertices = model_data->packed_vertices;
+
+    acmr_before = model_data->acmr_before;
+    acmr_after = model_data->acmr_after;
+    atvr_before = model_data->atvr_before;
+    atvr_after = model_data->atvr_after;
 
     default_material = new Material("Default");
 
     model_data->object_stock.clear();
     model_data->material_stock.clear();
     delete model_data;
+
+    return true;
+}
+
+/** Pixels a model unit covers on screen, at the point of the bounds closest to the camera */
+float Model::getPixelsPerUnit(const Camera *const camera) const
+{
+    // The bounds are in model units, before the position dequantization
+    const glm::mat4 world_mat = model_mat * origin_mat;
+    const float scale = glm::max(glm::max(glm::length(glm::vec3(world_mat[0])), glm::length(glm::vec3(world_mat[1]))), glm::length(glm::vec3(world_mat[2])));
+    const glm::vec3 center = glm::vec3(world_mat * glm::vec4((min + max) / 2.0F, 1.0F));
+    const float radius = glm::length(max - min) / 2.0F * scale;
+    const float fov = glm::radians(camera->getFOV());
+    const float resolution = camera->getResolution().y;
+
+    if (camera->isOrthogonal())
+    {
+        return scale * resolution / (2.0F * std::atan(fov / 2.0F) * glm::length(camera->getPosition()));
+    }
+
+    const float distance = glm::max(glm::length(center - camera->getPosition()) - radius, camera->getClipping().x);
+    return scale * resolution / (2.0F * std::tan(fov / 2.0F) * distance);
+}
+
+/** Picks the coarsest level of detail whose error projects to at most `threshold' pixels from the camera */
+void Model::selectLod(const Camera *const camera, const float &threshold)
+{
+    lod = 0U;
+
+    if ((camera == nullptr) || (lod_stock.size() < 2U))
+    {
+        return;
+    }
+
+    const float pixels = getPixelsPerUnit(camera);
+
+    while ((lod + 1U < lod_stock.size()) && (lod_stock[lod + 1U].error * pixels <= threshold))
+    {
+        lod++;
+    }
+}
+
+/**
+ * Asks for the streamed texture levels the model needs, its textures are taken to span its bounds once. Models
+ * disabled, outside the view or with every cluster culled ask for nothing, so their textures go back to the tail.
+ */
+void Model::requestTextures(const Camera *const camera) const
+{
+    // Packed materials are drawn from their arrays, the textures of the materials can stay at their tail
+    if (!enabled || !model_open || (camera == nullptr) || material_pack.isPacked() || ((tested_clusters > 0U) && (frustum_culled + backface_culled == tested_clusters)))
+    {
+        return;
+    }
+
+    const float pixels = glm::length(max - min) * getPixelsPerUnit(camera);
+
+    for (const Material *const material : material_stock)
+    {
+        material->requestTextures(pixels);
+    }
+}
+
+/**
+ * Keeps the clusters of the drawn level inside the view frustum and, with `backfaces', not facing away from the
+ * camera, joining the visible neighbours of an object into one draw. Without a camera every cluster is drawn.
+ */
+void Model::cullClusters(const Camera *const camera, const bool &backfaces)
+{
+    const std::size_t first = lod_stock.empty() ? 0U : lod_stock[lod].first;
+    const std::size_t last = lod_stock.empty() ? object_stock.size() : lod_stock[lod].last;
+
+    batch_lod = lod;
+    batch_first = first;
+    batch_last = last;
+    batch_stock.clear();
+    draw_count_stock.clear();
+    draw_offset_stock.clear();
+    draw_base_stock.clear();
+    tested_clusters = 0U;
+    frustum_culled = 0U;
+    backface_culled = 0U;
+
+    // The planes, the eye and the bounds are all in model units, before the position dequantization
+    const glm::mat4 world_mat = model_mat * origin_mat;
+    glm::vec4 plane[6];
+    glm::vec3 eye(0.0F);
+    glm::vec3 view(0.0F);
+
+    if (camera != nullptr)
+    {
+        const glm::mat4 clip_mat = camera->getProjectionMatrix() * camera->getViewMatrix() * world_mat;
+        const glm::mat4 inverse_mat = glm::inverse(world_mat);
+        const glm::vec4 row[4] = {glm::row(clip_mat, 0), glm::row(clip_mat, 1), glm::row(clip_mat, 2), glm::row(clip_mat, 3)};
+
+        for (std::size_t i = 0U; i < 6U; i++)
+        {
+            plane[i] = i % 2U == 0U ? row[3] + row[i / 2U] : row[3] - row[i / 2U];
+            plane[i] /= glm::length(glm::vec3(plane[i]));
+        }
+
+        eye = glm::vec3(inverse_mat * glm::vec4(camera->getPosition(), 1.0F));
+        view = glm::normalize(glm::vec3(inverse_mat * glm::vec4(camera->getDirection(), 0.0F)));
+    }
+
+    for (std::size_t i = first; i < last; i++)
+    {
+        const ModelData::Object *const object = object_stock[i];
+        const std::size_t batch = draw_count_stock.size();
+
+        if ((camera == nullptr) || (object->first_cluster == object->last_cluster))
+        {
+            draw_count_stock.emplace_back(object->count);
+            draw_offset_stock.emplace_back(reinterpret_cast<const void *>(static_cast<intptr_t>(object->offset)));
+            draw_base_stock.emplace_back(object->base_vertex);
+            batch_stock.emplace_back(batch, 1U);
+            continue;
+        }
+
+        for (std::size_t j = object->first_cluster; j < object->last_cluster; j++)
+        {
+            const ModelData::Cluster &cluster = cluster_stock[j];
+            bool inside = true;
+            tested_clusters++;
+
+            for (std::size_t k = 0U; inside && (k < 6U); k++)
+            {
+                inside = glm::dot(glm::vec3(plane[k]), cluster.center) + plane[k].w >= -cluster.radius;
+            }
+
+            if (!inside)
+            {
+                frustum_culled++;
+                continue;
+            }
+
+            const bool backface = backfaces && (camera->isOrthogonal() ? glm::dot(view, cluster.cone_axis) >= cluster.cone_cutoff
+                                                                       : glm::dot(cluster.center - eye, cluster.cone_axis) >= cluster.cone_cutoff * glm::length(cluster.center - eye) + cluster.radius);
+
+            if (backface)
+            {
+                backface_culled++;
+                continue;
+            }
+
+            const GLsizei end = draw_count_stock.size() > batch ? static_cast<GLsizei>(reinterpret_cast<intptr_t>(draw_offset_stock.back())) + draw_count_stock.back() * ModelData::Object::getTypeSize(object->type) : -1;
+
+            if (end == cluster.offset)
+            {
+                draw_count_stock.back() += cluster.count;
+            }
+
+            else
+            {
+                draw_count_stock.emplace_back(cluster.count);
+                draw_offset_stock.emplace_back(reinterpret_cast<const void *>(static_cast<intptr_t>(cluster.offset)));
+                draw_base_stock.emplace_back(object->base_vertex);
+            }
+        }
+
+        batch_stock.emplace_back(batch, draw_count_stock.size() - batch);
+    }
 }
 
 void Model::clear()
 {
+    // A loader still reading is left to its worker thread
+    if (loader != nullptr)
+    {
+        loader->discard();
+        loader.reset();
+    }
+
     model_open = false;
     material_open = false;
     material_path.clear();
 
     origin_mat = glm::mat4(1.0F);
+    position_mat = glm::mat4(1.0F);
     min = glm::vec3(INFINITY);
     max = glm::vec3(-INFINITY);
 
     glDeleteBuffers(1, &ebo);
     glDeleteBuffers(1, &vbo);
-    glDeleteBuffers(1, &vao);
+    glDeleteVertexArrays(1, &vao);
 
     vao = GL_FALSE;
     vbo = GL_FALSE;
@@ -59,9 +251,40 @@ void Model::clear()
     elements = 0U;
     triangles = 0U;
     textures = 0U;
+    packed_vertices = false;
+
+    acmr_before = 0.0F;
+    acmr_after = 0.0F;
+    atvr_before = 0.0F;
+    atvr_after = 0.0F;
+
+    for (const ModelData::Object *const object : object_stock)
+    {
+        delete object;
+    }
+
+    for (const Material *const material : material_stock)
+    {
+        delete material;
+    }
 
     object_stock.clear();
     material_stock.clear();
+    lod_stock.clear();
+    cluster_stock.clear();
+    lod = 0U;
+    batch_lod = 0U;
+    batch_first = 0U;
+    batch_last = 0U;
+    batch_stock.clear();
+    draw_count_stock.clear();
+    draw_offset_stock.clear();
+    draw_base_stock.clear();
+    tested_clusters = 0U;
+    frustum_culled = 0U;
+    backface_culled = 0U;
+    material_pack.clear();
+    block.clear();
 
     if (default_material != nullptr)
     {
@@ -79,7 +302,7 @@ void Model::updateMatrices()
 
     const glm::mat4 translation_rotation_mat = translation_mat * rotation_mat;
     model_mat = translation_rotation_mat * scale_mat;
-    model_origin_mat = model_mat * origin_mat;
+    model_origin_mat = model_mat * origin_mat * position_mat;
     normal_mat = glm::inverse(glm::transpose(translation_rotation_mat));
 }
 
@@ -94,21 +317,37 @@ Model::Model() : ModelData(std::string()),
                  model_origin_mat(1.0F),
                  normal_mat(1.0F),
 
-                 default_material(nullptr)
+                 default_material(nullptr),
+                 options(ModelLoader::ALL_OPTIONS),
+                 lod(0U),
+                 batch_lod(0U),
+                 batch_first(0U),
+                 batch_last(0U),
+                 tested_clusters(0U),
+                 frustum_culled(0U),
+                 backface_culled(0U)
 {
 }
 
-Model::Model(const std::string &path) : ModelData(path),
+Model::Model(const std::string &path, const GLenum &options) : ModelData(path),
 
-                                        enabled(true),
-                                        position(0.0F),
-                                        rotation(glm::quat()),
-                                        dimension(1.0F),
-                                        model_mat(1.0F),
-                                        model_origin_mat(1.0F),
-                                        normal_mat(1.0F),
+                                                               enabled(true),
+                                                               position(0.0F),
+                                                               rotation(glm::quat()),
+                                                               dimension(1.0F),
+                                                               model_mat(1.0F),
+                                                               model_origin_mat(1.0F),
+                                                               normal_mat(1.0F),
 
-                                        default_material(nullptr)
+                                                               default_material(nullptr),
+                                                               options(options),
+                                                               lod(0U),
+                                                               batch_lod(0U),
+                                                               batch_first(0U),
+                                                               batch_last(0U),
+                                                               tested_clusters(0U),
+                                                               frustum_culled(0U),
+                                                               backface_culled(0U)
 {
 
     load();
@@ -124,6 +363,11 @@ bool Model::isOpen() const
     return model_open;
 }
 
+bool Model::isLoading() const
+{
+    return loader != nullptr;
+}
+
 bool Model::isMaterialOpen() const
 {
     return material_open;
@@ -230,6 +474,56 @@ std::size_t Model::getNumberOfTextures() const
     return textures;
 }
 
+float Model::getACMR(const bool &optimized) const
+{
+    return optimized ? acmr_after : acmr_before;
+}
+
+float Model::getATVR(const bool &optimized) const
+{
+    return optimized ? atvr_after : atvr_before;
+}
+
+std::size_t Model::getLod() const
+{
+    return lod;
+}
+
+std::size_t Model::getNumberOfLods() const
+{
+    return lod_stock.size();
+}
+
+std::size_t Model::getLodTriangles(const std::size_t &level) const
+{
+    return level < lod_stock.size() ? lod_stock[level].triangles : triangles;
+}
+
+float Model::getLodError(const std::size_t &level) const
+{
+    return level < lod_stock.size() ? lod_stock[level].error : 0.0F;
+}
+
+std::size_t Model::getNumberOfClusters() const
+{
+    return tested_clusters;
+}
+
+std::size_t Model::getFrustumCulledClusters() const
+{
+    return frustum_culled;
+}
+
+std::size_t Model::getBackfaceCulledClusters() const
+{
+    return backface_culled;
+}
+
+GLenum Model::getLoaderOptions() const
+{
+    return options;
+}
+
 void Model::setEnabled(const bool &status)
 {
     enabled = status;
@@ -241,6 +535,19 @@ void Model::setPath(const std::string &new_path)
     reload();
 }
 
+/** Reloads the model only when data it was loaded without is now needed */
+void Model::setLoaderOptions(const GLenum &new_options)
+{
+    // Packing changes the vertex layout, so it reloads both ways
+    const bool missing = ((new_options & ~options) | ((new_options ^ options) & ModelLoader::QUANTIZE)) != 0U;
+    options = new_options;
+
+    if (missing && !model_path.empty())
+    {
+        reload();
+    }
+}
+
 void Model::setPosition(const glm::vec3 &new_position)
 {
     position = new_position;
@@ -288,8 +595,9 @@ bool Model::reloadMaterial()
         delete default_material;
     }
     default_material = new Material("Default");
+    material_pack.clear();
 
-    std::vector<Material *> material_data(ModelLoader::loadMaterial(material_path, ModelLoader::OBJ));
+    std::vector<Material *> material_data(ModelLoader::loadMaterial(material_path, ModelLoader::getFormat(material_path)));
 
     const std::size_t materials = material_stock.size();
     if (material_data.size() != materials)
@@ -306,24 +614,23 @@ bool Model::reloadMaterial()
 
     for (ModelData::Object *const object : object_stock)
     {
-
-        const Material *const &old_material = object->material;
-
         for (std::size_t i = 0U; i < materials; i++)
         {
-            Material *&material = material_stock[i];
-            if (material == old_material)
+            if (material_stock[i] == object->material)
             {
-
-                delete old_material;
-
-                material = material_data[i];
-                object->material = material;
+                object->material = material_data[i];
                 break;
             }
         }
     }
 
+    // Objects share their materials, so the old ones are deleted once every object points to the new ones
+    for (std::size_t i = 0U; i < materials; i++)
+    {
+        delete material_stock[i];
+        material_stock[i] = material_data[i];
+    }
+
     return true;
 }
 
@@ -337,6 +644,56 @@ void Model::resetGeometry()
     updateMatrices();
 }
 
+/**
+ * Packed models, drawn with the location of the material index, only switch the index and the arrays when the
+ * material is in another group than `group'. The rows were bound once for the whole model.
+ */
+void Model::bindMaterial(GLSLProgram *const program, const Material *const material, const GLint &index_location, std::size_t &group) const
+{
+    if (index_location >= 0)
+    {
+        if (material_pack.getGroup(material) != group)
+        {
+            group = material_pack.getGroup(material);
+            material_pack.bindGroup(group);
+        }
+
+        glUniform1i(index_location, material_pack.getIndex(material));
+        return;
+    }
+
+    material->bind(program);
+}
+
+/** Keeps the textures of the materials packed into arrays while `status' is set, otherwise they are bound per object */
+void Model::packMaterials(const bool &status)
+{
+    if (status && model_open)
+    {
+        material_pack.update(material_stock);
+        return;
+    }
+
+    material_pack.clear();
+}
+
+/** Writes the object block and the block of each material, each one only uploaded when it changed */
+void Model::updateBlocks()
+{
+    if (!model_open)
+    {
+        return;
+    }
+
+    const Model::ObjectBlock data = {model_origin_mat, {glm::vec4(normal_mat[0], 0.0F), glm::vec4(normal_mat[1], 0.0F), glm::vec4(normal_mat[2], 0.0F)}, {static_cast<GLint>(packed_vertices), 0, 0, 0}};
+    block.update(&data, sizeof(data));
+
+    for (Material *const material : material_stock)
+    {
+        material->updateBlock();
+    }
+}
+
 void Model::draw(GLSLProgram *const program) const
 {
     if (!enabled || !model_open || (program == nullptr) || (!program->isValid()))
@@ -345,16 +702,49 @@ void Model::draw(GLSLProgram *const program) const
     }
 
     program->use();
-    program->setUniform("u_model_mat", model_origin_mat);
-    program->setUniform("u_normal_mat", normal_mat);
+    block.bind(UniformBlock::OBJECT);
+
+    // Programs without the packed path get the textures of each object, the index location is only looked up once
+    const GLint index_location = material_pack.isPacked() && program->isUniformActive("u_texture_array") ? program->getUniformLocation("u_material_index") : -1;
+    const bool packed = index_location >= 0;
+    program->setUniform("u_texture_array", static_cast<GLint>(packed));
+
+    // The first group is bound with the rows, the others as their materials are drawn
+    std::size_t group = 0U;
+    if (packed)
+    {
+        material_pack.bind();
+    }
 
     glBindVertexArray(vao);
 
-    for (const ModelData::Object *const object : object_stock)
+    // Without levels of detail every object is drawn
+    const std::size_t first = lod_stock.empty() ? 0U : lod_stock[lod].first;
+    const std::size_t last = lod_stock.empty() ? object_stock.size() : lod_stock[lod].last;
+
+    // The culled draws are used while they were built for the drawn level and its objects
+    const bool culled = (batch_lod == lod) && (batch_first == first) && (batch_last == last) && (batch_stock.size() == last - first);
+
+    for (std::size_t i = first; i < last; i++)
     {
-        object->material->bind(program);
+        const ModelData::Object *const object = object_stock[i];
+
+        if (!culled)
+        {
+            bindMaterial(program, object->material, index_location, group);
+            glDrawElementsBaseVertex(GL_TRIANGLES, object->count, object->type, reinterpret_cast<void *>(static_cast<intptr_t>(object->offset)), object->base_vertex);
+            continue;
+        }
+
+        const std::pair<std::size_t, std::size_t> &batch = batch_stock[i - first];
+
+        if (batch.second == 0U)
+        {
+            continue;
+        }
 
-        glDrawElements(GL_TRIANGLES, object->count, GL_UNSIGNED_INT, reinterpret_cast<void *>(static_cast<intptr_t>(object->offset)));
+        bindMaterial(program, object->material, index_location, group);
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, &draw_count_stock[batch.first], object->type, &draw_offset_stock[batch.first], static_cast<GLsizei>(batch.second), &draw_base_stock[batch.first]);
     }
 
     glBindVertexArray(GL_FALSE);
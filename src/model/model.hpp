@@ -4,18 +4,29 @@
 #include "loader/modelloader.hpp"
 #include "loader/modeldata.hpp"
 #include "material.hpp"
+#include "materialpack.hpp"
+#include "../scene/camera.hpp"
 #include "../scene/glslprogram.hpp"
 #include "../glad/glad.h"
 #include <glm/gtc/quaternion.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/mat3x3.hpp>
 #include <glm/vec3.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
 class Model : private ModelData
 {
 private:
+    /** Layout of the std140 object block, the normal matrix takes a column per row */
+    struct ObjectBlock
+    {
+        glm::mat4 model_mat;
+        glm::vec4 normal_mat[3];
+        GLint packed_vertex[4];
+    };
+
     bool enabled;
     glm::vec3 position;
     glm::quat rotation;
@@ -24,18 +35,36 @@ private:
     glm::mat4 model_origin_mat;
     glm::mat3 normal_mat;
     Material *default_material;
+    std::shared_ptr<ModelLoader> loader;
+    GLenum options;
+    std::size_t lod;
+    std::size_t batch_lod;
+    std::size_t batch_first;
+    std::size_t batch_last;
+    std::vector<std::pair<std::size_t, std::size_t>> batch_stock;
+    std::vector<GLsizei> draw_count_stock;
+    std::vector<const void *> draw_offset_stock;
+    std::vector<GLint> draw_base_stock;
+    std::size_t tested_clusters;
+    std::size_t frustum_culled;
+    std::size_t backface_culled;
+    MaterialPack material_pack;
+    UniformBlock block;
 
     Model(const Model &) = delete;
     Model &operator=(const Model &) = delete;
     void load();
     void clear();
     void updateMatrices();
+    float getPixelsPerUnit(const Camera *const camera) const;
+    void bindMaterial(GLSLProgram *const program, const Material *const material, const GLint &index_location, std::size_t &group) const;
 
 public:
     Model();
-    Model(const std::string &path);
+    Model(const std::string &path, const GLenum &options = ModelLoader::ALL_OPTIONS);
     bool isEnabled() const;
     bool isOpen() const;
+    bool isLoading() const;
     bool isMaterialOpen() const;
     std::string getName() const;
     std::string getPath() const;
@@ -56,8 +85,19 @@ public:
     std::size_t getNumberOfTriangles() const;
     std::size_t getNumberOfMaterials() const;
     std::size_t getNumberOfTextures() const;
+    float getACMR(const bool &optimized = true) const;
+    float getATVR(const bool &optimized = true) const;
+    std::size_t getLod() const;
+    std::size_t getNumberOfLods() const;
+    std::size_t getLodTriangles(const std::size_t &level) const;
+    float getLodError(const std::size_t &level) const;
+    std::size_t getNumberOfClusters() const;
+    std::size_t getFrustumCulledClusters() const;
+    std::size_t getBackfaceCulledClusters() const;
+    GLenum getLoaderOptions() const;
     void setEnabled(const bool &status);
     void setPath(const std::string &new_path);
+    void setLoaderOptions(const GLenum &new_options);
     void setPosition(const glm::vec3 &new_position);
     void setRotation(const glm::vec3 &new_rotation);
     void setRotation(const glm::quat &new_rotation);
@@ -65,6 +105,12 @@ public:
     void reload();
     bool reloadMaterial();
     void resetGeometry();
+    bool update(std::size_t &budget);
+    void selectLod(const Camera *const camera, const float &threshold);
+    void cullClusters(const Camera *const camera, const bool &backfaces = true);
+    void requestTextures(const Camera *const camera) const;
+    void packMaterials(const bool &status);
+    void updateBlocks();
     void draw(GLSLProgram *const program) const;
     void translate(const glm::vec3 &delta);
     void rotate(const glm::vec3 &delta);
@@ -0,0 +1,238 @@
+#include "texturecache.hpp"
+#include "textureresidency.hpp"
+#include "stb/stb_image.h"
+#include "../threadpool.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sys/stat.h>
+
+std::unordered_map<std::string, TextureCache::Entry> TextureCache::entry_map;
+std::unordered_map<GLuint, std::string> TextureCache::key_map;
+std::unordered_map<std::string, std::weak_ptr<TextureCache::Image>> TextureCache::pending_map;
+std::mutex TextureCache::mutex;
+
+TextureCache::Image::~Image()
+{
+    if (pixels != nullptr)
+    {
+        stbi_image_free(pixels);
+    }
+}
+
+bool TextureCache::Image::isReady() const
+{
+    return done.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/** Absolute path without links or dot segments, empty when the file does not exist */
+std::string TextureCache::getCanonicalPath(const std::string &path)
+{
+#if defined(_WIN32)
+    char *const canonical = _fullpath(nullptr, path.c_str(), 0U);
+#else
+    char *const canonical = realpath(path.c_str(), nullptr);
+#endif
+
+    if (canonical == nullptr)
+    {
+        return std::string();
+    }
+
+    const std::string result(canonical);
+    std::free(canonical);
+
+    return result;
+}
+
+/**
+ * Builds the key of an image file, or of an image embedded in a model when `encoded' holds it. Embedded images
+ * are stamped with a hash of their bytes instead of a time. An empty key means the image cannot be shared.
+ */
+std::string TextureCache::getKey(const std::string &path, const std::vector<GLubyte> &encoded)
+{
+    if (!encoded.empty())
+    {
+        std::uint64_t value = 0xCBF29CE484222325ULL;
+
+        for (const GLubyte byte : encoded)
+        {
+            value = (value ^ byte) * 0x100000001B3ULL;
+        }
+
+        return path + '\n' + std::to_string(encoded.size()) + '\n' + std::to_string(value);
+    }
+
+    const std::string canonical = TextureCache::getCanonicalPath(path);
+
+#if defined(_WIN32)
+    struct _stat64 status;
+    if (canonical.empty() || (_stat64(canonical.c_str(), &status) != 0))
+    {
+        return std::string();
+    }
+#else
+    struct stat status;
+    if (canonical.empty() || (::stat(canonical.c_str(), &status) != 0))
+    {
+        return std::string();
+    }
+#endif
+
+    return canonical + '\n' + std::to_string(static_cast<std::uint64_t>(status.st_size)) + '\n' + std::to_string(static_cast<std::int64_t>(status.st_mtime));
+}
+
+/**
+ * Queues the decode of an image with `channels' components per texel and returns at once. An image with the same
+ * key still being decoded is shared, and a key already uploaded only gets a placeholder. Empty keys are never shared.
+ * Unless `mode' is NONE the RGBA image is block compressed, and files are read from or written to their DDS cache.
+ */
+std::shared_ptr<TextureCache::Image> TextureCache::decode(const std::string &key, const std::string &path, const std::vector<GLubyte> &encoded, const int &channels, const TextureCodec::Mode &mode)
+{
+    static ThreadPool pool;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::unordered_map<std::string, std::weak_ptr<TextureCache::Image>>::iterator pending = key.empty() ? pending_map.end() : pending_map.find(key);
+    std::shared_ptr<TextureCache::Image> image = pending == pending_map.end() ? nullptr : pending->second.lock();
+
+    if (image != nullptr)
+    {
+        return image;
+    }
+
+    image = std::make_shared<TextureCache::Image>();
+    image->key = key;
+    image->width = 0;
+    image->height = 0;
+    image->pixels = nullptr;
+    image->decoded = entry_map.count(key) == 0U;
+
+    const std::shared_ptr<std::packaged_task<void()>> task = std::make_shared<std::packaged_task<void()>>([image, path, encoded, channels, mode]() {
+        int components;
+
+        // A warm start reads the compressed chain and never decodes the source
+        if (!image->decoded || (encoded.empty() && TextureCodec::read(path, mode, image->chain)))
+        {
+            return;
+        }
+
+        image->pixels = encoded.empty() ? stbi_load(path.c_str(), &image->width, &image->height, &components, channels) : stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &image->width, &image->height, &components, channels);
+
+        if (image->pixels == nullptr)
+        {
+            std::cerr << "error: could not open the texture `" << path << "'" << std::endl;
+            return;
+        }
+
+        if ((mode != TextureCodec::NONE) && (channels == STBI_rgb_alpha))
+        {
+            TextureCodec::compress(image->pixels, image->width, image->height, mode, image->chain);
+            stbi_image_free(image->pixels);
+            image->pixels = nullptr;
+
+            if (encoded.empty())
+            {
+                TextureCodec::write(path, mode, image->chain);
+            }
+        }
+
+        // The levels are built here as well, so uncompressed textures can be streamed like the compressed ones
+        else if (channels == STBI_rgb_alpha)
+        {
+            TextureCodec::mipmap(image->pixels, image->width, image->height, image->chain);
+            stbi_image_free(image->pixels);
+            image->pixels = nullptr;
+        }
+    });
+
+    image->done = task->get_future().share();
+
+    // Placeholders are finished here, the other tasks go to the pool
+    if (!image->decoded)
+    {
+        (*task)();
+        return image;
+    }
+
+    if (!key.empty())
+    {
+        pending_map[key] = image;
+    }
+
+    // Every caller flips the images the same way, so the global flag of stb_image can be shared
+    stbi_set_flip_vertically_on_load(true);
+    pool.submit([task]() { (*task)(); });
+
+    return image;
+}
+
+bool TextureCache::contains(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return !key.empty() && (entry_map.count(key) != 0U);
+}
+
+/** Returns a new reference to the texture stored under `key', or GL_FALSE when it still has to be loaded */
+GLuint TextureCache::acquire(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::unordered_map<std::string, TextureCache::Entry>::iterator entry = entry_map.find(key);
+
+    if (key.empty() || (entry == entry_map.end()))
+    {
+        return GL_FALSE;
+    }
+
+    entry->second.references++;
+    return entry->second.texture;
+}
+
+/** Stores a texture just loaded with a single reference, textures with an empty key are left unshared */
+void TextureCache::insert(const std::string &key, const GLuint &texture)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_map.erase(key);
+
+    if (key.empty() || (texture == GL_FALSE) || (entry_map.count(key) != 0U))
+    {
+        return;
+    }
+
+    entry_map[key] = TextureCache::Entry{texture, 1U};
+    key_map[texture] = key;
+}
+
+/** Drops a reference, the texture is deleted with the last one or right away when it was never shared */
+void TextureCache::release(const GLuint &texture)
+{
+    if (texture == GL_FALSE)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::unordered_map<GLuint, std::string>::iterator key = key_map.find(texture);
+
+    if (key != key_map.end())
+    {
+        TextureCache::Entry &entry = entry_map[key->second];
+
+        if (--entry.references > 0U)
+        {
+            return;
+        }
+
+        entry_map.erase(key->second);
+        key_map.erase(key);
+    }
+
+    TextureResidency::erase(texture);
+    glDeleteTextures(1, &texture);
+}
+
+std::size_t TextureCache::getSize()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entry_map.size();
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef __TEXTURE_CACHE_HPP_
+#define __TEXTURE_CACHE_HPP_
+
+#include "texturecodec.hpp"
+#include "../glad/glad.h"
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Process wide table of the uploaded textures. Images are keyed by their canonical path and modification time,
+ * so materials and models naming the same file share one GL name until the file changes. The images are decoded
+ * on a pool of workers from any thread, the textures are only created and released on the GL thread.
+ */
+class TextureCache
+{
+public:
+    /**
+     * Image decoded by a worker, done once `done' is ready. RGBA images fill `chain' with their levels instead of `pixels'.
+     * A placeholder is not decoded since its key was already uploaded.
+     */
+    struct Image
+    {
+        std::string key;
+        int width;
+        int height;
+        GLubyte *pixels;
+        TextureCodec::Chain chain;
+        bool decoded;
+        std::shared_future<void> done;
+
+        ~Image();
+        bool isReady() const;
+    };
+
+private:
+    /** Shared texture and the number of materials holding it */
+    struct Entry
+    {
+        GLuint texture;
+        std::size_t references;
+    };
+
+    static std::unordered_map<std::string, TextureCache::Entry> entry_map;
+    static std::unordered_map<GLuint, std::string> key_map;
+    static std::unordered_map<std::string, std::weak_ptr<TextureCache::Image>> pending_map;
+    static std::mutex mutex;
+
+    TextureCache() = delete;
+    static std::string getCanonicalPath(const std::string &path);
+
+public:
+    static std::string getKey(const std::string &path, const std::vector<GLubyte> &encoded);
+    static std::shared_ptr<TextureCache::Image> decode(const std::string &key, const std::string &path, const std::vector<GLubyte> &encoded, const int &channels, const TextureCodec::Mode &mode = TextureCodec::NONE);
+    static bool contains(const std::string &key);
+    static GLuint acquire(const std::string &key);
+    static void insert(const std::string &key, const GLuint &texture);
+    static void release(const GLuint &texture);
+    static std::size_t getSize();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,505 @@
+#include "texturecodec.hpp"
+#include "loader/mappedfile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+std::atomic<bool> TextureCodec::enabled(true);
+const std::uint32_t TextureCodec::STAMP = 0x56424A4FU;
+const std::uint32_t TextureCodec::VERSION = 1U;
+const std::string TextureCodec::EXTENSION[3] = {"", ".color.dds", ".normal.dds"};
+
+bool TextureCodec::readStatus(const std::string &path, std::uint64_t &size, std::int64_t &time)
+{
+#if defined(_WIN32)
+    struct _stat64 status;
+    if (_stat64(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+#else
+    struct stat status;
+    if (::stat(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+#endif
+
+    size = static_cast<std::uint64_t>(status.st_size);
+    time = static_cast<std::int64_t>(status.st_mtime);
+
+    return true;
+}
+
+std::uint16_t TextureCodec::packColor(const float *const color)
+{
+    const int r = static_cast<int>(std::lround(std::min(std::max(color[0], 0.0F), 255.0F) * 31.0F / 255.0F));
+    const int g = static_cast<int>(std::lround(std::min(std::max(color[1], 0.0F), 255.0F) * 63.0F / 255.0F));
+    const int b = static_cast<int>(std::lround(std::min(std::max(color[2], 0.0F), 255.0F) * 31.0F / 255.0F));
+
+    return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void TextureCodec::unpackColor(const std::uint16_t &packed, int *const color)
+{
+    const int r = (packed >> 11) & 0x1F;
+    const int g = (packed >> 5) & 0x3F;
+    const int b = packed & 0x1F;
+
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+/**
+ * Encodes 16 RGBA texels as a BC1 block. The endpoints lie on the principal axis of the colors, pulled in by a
+ * sixteenth of their range, and always use the four color mode.
+ */
+void TextureCodec::encodeColor(const GLubyte *const block, GLubyte *const target)
+{
+    float mean[3] = {0.0F, 0.0F, 0.0F};
+    float covariance[6] = {0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F};
+
+    for (std::size_t i = 0U; i < 16U; i++)
+    {
+        for (std::size_t c = 0U; c < 3U; c++)
+        {
+            mean[c] += block[4U * i + c] / 16.0F;
+        }
+    }
+
+    for (std::size_t i = 0U; i < 16U; i++)
+    {
+        const float r = block[4U * i] - mean[0];
+        const float g = block[4U * i + 1U] - mean[1];
+        const float b = block[4U * i + 2U] - mean[2];
+
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // A few power iterations are enough to find the dominant direction
+    float axis[3] = {1.0F, 1.0F, 1.0F};
+
+    for (std::size_t i = 0U; i < 8U; i++)
+    {
+        const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        const float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+
+        if (length == 0.0F)
+        {
+            break;
+        }
+
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    const float norm = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    float low = 0.0F;
+    float high = 0.0F;
+
+    for (std::size_t i = 0U; i < 16U; i++)
+    {
+        const float t = ((block[4U * i] - mean[0]) * axis[0] + (block[4U * i + 1U] - mean[1]) * axis[1] + (block[4U * i + 2U] - mean[2]) * axis[2]) / norm;
+
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+
+    const float inset = (high - low) / 16.0F;
+    float end[2][3];
+
+    for (std::size_t c = 0U; c < 3U; c++)
+    {
+        end[0][c] = mean[c] + axis[c] / norm * (high - inset);
+        end[1][c] = mean[c] + axis[c] / norm * (low + inset);
+    }
+
+    std::uint16_t color0 = TextureCodec::packColor(end[0]);
+    std::uint16_t color1 = TextureCodec::packColor(end[1]);
+
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    int palette[4][3];
+    std::uint32_t indices = 0U;
+
+    TextureCodec::unpackColor(color0, palette[0]);
+    TextureCodec::unpackColor(color1, palette[1]);
+
+    for (std::size_t c = 0U; c < 3U; c++)
+    {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    // Equal endpoints would switch to the three color mode, so every texel takes the first one
+    for (std::size_t i = 0U; (color0 != color1) && (i < 16U); i++)
+    {
+        int best = 0;
+        int best_distance = INT32_MAX;
+
+        for (int j = 0; j < 4; j++)
+        {
+            const int r = block[4U * i] - palette[j][0];
+            const int g = block[4U * i + 1U] - palette[j][1];
+            const int b = block[4U * i + 2U] - palette[j][2];
+            const int distance = r * r + g * g + b * b;
+
+            if (distance < best_distance)
+            {
+                best = j;
+                best_distance = distance;
+            }
+        }
+
+        indices |= static_cast<std::uint32_t>(best) << (2U * i);
+    }
+
+    const GLubyte packed[8] = {static_cast<GLubyte>(color0), static_cast<GLubyte>(color0 >> 8U), static_cast<GLubyte>(color1), static_cast<GLubyte>(color1 >> 8U),
+                               static_cast<GLubyte>(indices), static_cast<GLubyte>(indices >> 8U), static_cast<GLubyte>(indices >> 16U), static_cast<GLubyte>(indices >> 24U)};
+
+    std::memcpy(target, packed, sizeof(packed));
+}
+
+/** Encodes one channel of 16 RGBA texels as a BC4 block, the alpha of BC3 and each half of BC5 */
+void TextureCodec::encodeChannel(const GLubyte *const block, const std::size_t &channel, GLubyte *const target)
+{
+    int low = 255;
+    int high = 0;
+
+    for (std::size_t i = 0U; i < 16U; i++)
+    {
+        low = std::min(low, static_cast<int>(block[4U * i + channel]));
+        high = std::max(high, static_cast<int>(block[4U * i + channel]));
+    }
+
+    // The first endpoint is the larger, so the eight values mode interpolates between them
+    int palette[8] = {high, low};
+    std::uint64_t indices = 0U;
+
+    for (int i = 1; i < 7; i++)
+    {
+        palette[i + 1] = ((7 - i) * high + i * low + 3) / 7;
+    }
+
+    for (std::size_t i = 0U; (high != low) && (i < 16U); i++)
+    {
+        std::uint64_t best = 0U;
+        int best_distance = 256;
+
+        for (std::size_t j = 0U; j < 8U; j++)
+        {
+            const int distance = std::abs(block[4U * i + channel] - palette[j]);
+
+            if (distance < best_distance)
+            {
+                best = j;
+                best_distance = distance;
+            }
+        }
+
+        indices |= best << (3U * i);
+    }
+
+    target[0] = static_cast<GLubyte>(high);
+    target[1] = static_cast<GLubyte>(low);
+
+    for (std::size_t i = 0U; i < 6U; i++)
+    {
+        target[2U + i] = static_cast<GLubyte>(indices >> (8U * i));
+    }
+}
+
+/** Halves an RGBA level with a box filter, the normals of normal maps are made unit again */
+void TextureCodec::downsample(const std::vector<GLubyte> &source, const int &width, const int &height, const TextureCodec::Mode &mode, std::vector<GLubyte> &target)
+{
+    const int new_width = std::max(width / 2, 1);
+    const int new_height = std::max(height / 2, 1);
+    target.resize(4U * static_cast<std::size_t>(new_width) * static_cast<std::size_t>(new_height));
+
+    for (int y = 0; y < new_height; y++)
+    {
+        for (int x = 0; x < new_width; x++)
+        {
+            const int x0 = std::min(2 * x, width - 1);
+            const int x1 = std::min(2 * x + 1, width - 1);
+            const int y0 = std::min(2 * y, height - 1);
+            const int y1 = std::min(2 * y + 1, height - 1);
+            float texel[4];
+
+            for (std::size_t c = 0U; c < 4U; c++)
+            {
+                texel[c] = (source[4U * static_cast<std::size_t>(y0 * width + x0) + c] + source[4U * static_cast<std::size_t>(y0 * width + x1) + c] +
+                            source[4U * static_cast<std::size_t>(y1 * width + x0) + c] + source[4U * static_cast<std::size_t>(y1 * width + x1) + c]) /
+                           4.0F;
+            }
+
+            if (mode == TextureCodec::NORMAL)
+            {
+                const float nx = texel[0] / 127.5F - 1.0F;
+                const float ny = texel[1] / 127.5F - 1.0F;
+                const float nz = texel[2] / 127.5F - 1.0F;
+                const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+
+                if (length > 0.0F)
+                {
+                    texel[0] = (nx / length + 1.0F) * 127.5F;
+                    texel[1] = (ny / length + 1.0F) * 127.5F;
+                    texel[2] = (nz / length + 1.0F) * 127.5F;
+                }
+            }
+
+            for (std::size_t c = 0U; c < 4U; c++)
+            {
+                target[4U * static_cast<std::size_t>(y * new_width + x) + c] = static_cast<GLubyte>(std::lround(std::min(std::max(texel[c], 0.0F), 255.0F)));
+            }
+        }
+    }
+}
+
+/** Builds the whole mip chain of an RGBA image, color maps with any translucent texel use BC3 instead of BC1 */
+void TextureCodec::compress(const GLubyte *const pixels, const int &width, const int &height, const TextureCodec::Mode &mode, TextureCodec::Chain &chain)
+{
+    std::vector<GLubyte> level(pixels, pixels + 4U * static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    std::vector<GLubyte> next_level;
+    bool alpha = false;
+
+    for (std::size_t i = 3U; (mode == TextureCodec::COLOR) && !alpha && (i < level.size()); i += 4U)
+    {
+        alpha = level[i] != 255U;
+    }
+
+    chain.format = mode == TextureCodec::NORMAL ? GL_COMPRESSED_RG_RGTC2 : alpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    chain.width = width;
+    chain.height = height;
+    chain.data.clear();
+    chain.level_stock.assign(1U, 0U);
+
+    const std::size_t block_size = chain.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8U : 16U;
+
+    for (int level_width = width, level_height = height;;)
+    {
+        const int blocks_x = (level_width + 3) / 4;
+        const int blocks_y = (level_height + 3) / 4;
+        std::size_t offset = chain.data.size();
+        chain.data.resize(offset + block_size * static_cast<std::size_t>(blocks_x) * static_cast<std::size_t>(blocks_y));
+
+        for (int by = 0; by < blocks_y; by++)
+        {
+            for (int bx = 0; bx < blocks_x; bx++, offset += block_size)
+            {
+                GLubyte block[64];
+
+                // Blocks past the edge repeat the last row and column
+                for (int i = 0; i < 16; i++)
+                {
+                    const int x = std::min(4 * bx + i % 4, level_width - 1);
+                    const int y = std::min(4 * by + i / 4, level_height - 1);
+                    std::memcpy(&block[4 * i], &level[4U * static_cast<std::size_t>(y * level_width + x)], 4U);
+                }
+
+                if (chain.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+                {
+                    TextureCodec::encodeColor(block, &chain.data[offset]);
+                }
+
+                else if (chain.format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+                {
+                    TextureCodec::encodeChannel(block, 3U, &chain.data[offset]);
+                    TextureCodec::encodeColor(block, &chain.data[offset + 8U]);
+                }
+
+                else
+                {
+                    TextureCodec::encodeChannel(block, 0U, &chain.data[offset]);
+                    TextureCodec::encodeChannel(block, 1U, &chain.data[offset + 8U]);
+                }
+            }
+        }
+
+        chain.level_stock.emplace_back(chain.data.size());
+
+        if ((level_width == 1) && (level_height == 1))
+        {
+            break;
+        }
+
+        TextureCodec::downsample(level, level_width, level_height, mode, next_level);
+        level.swap(next_level);
+        level_width = std::max(level_width / 2, 1);
+        level_height = std::max(level_height / 2, 1);
+    }
+}
+
+/** Builds the whole mip chain of an RGBA image without compressing it, for the textures streamed uncompressed */
+void TextureCodec::mipmap(const GLubyte *const pixels, const int &width, const int &height, TextureCodec::Chain &chain)
+{
+    std::vector<GLubyte> level(pixels, pixels + 4U * static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    std::vector<GLubyte> next_level;
+
+    chain.format = GL_RGBA8;
+    chain.width = width;
+    chain.height = height;
+    chain.data.clear();
+    chain.data.reserve(level.size() + level.size() / 3U + 4U);
+    chain.level_stock.assign(1U, 0U);
+
+    for (int level_width = width, level_height = height;;)
+    {
+        chain.data.insert(chain.data.end(), level.begin(), level.end());
+        chain.level_stock.emplace_back(chain.data.size());
+
+        if ((level_width == 1) && (level_height == 1))
+        {
+            break;
+        }
+
+        TextureCodec::downsample(level, level_width, level_height, TextureCodec::NONE, next_level);
+        level.swap(next_level);
+        level_width = std::max(level_width / 2, 1);
+        level_height = std::max(level_height / 2, 1);
+    }
+}
+
+/** Reads the chain stored for the source at `path', as long as the source did not change since it was written */
+bool TextureCodec::read(const std::string &path, const TextureCodec::Mode &mode, TextureCodec::Chain &chain)
+{
+    std::uint64_t source_size;
+    std::int64_t source_time;
+
+    if ((mode == TextureCodec::NONE) || !TextureCodec::readStatus(path, source_size, source_time))
+    {
+        return false;
+    }
+
+    const MappedFile file(path + TextureCodec::EXTENSION[mode]);
+    TextureCodec::Header header;
+
+    if (!file.isOpen() || (file.getSize() < 4U + sizeof(header)) || (std::strncmp(file.getData(), "DDS ", 4U) != 0))
+    {
+        return false;
+    }
+
+    std::memcpy(&header, file.getData() + 4, sizeof(header));
+
+    std::uint64_t stamp[2];
+    std::memcpy(stamp, &header.reserved[2], sizeof(stamp));
+
+    if ((header.reserved[0] != TextureCodec::STAMP) || (header.reserved[1] != TextureCodec::VERSION) || (stamp[0] != source_size) || (static_cast<std::int64_t>(stamp[1]) != source_time) ||
+        (header.width == 0U) || (header.height == 0U) || (header.width > 65536U) || (header.height > 65536U) || (header.mip_count == 0U) || (header.mip_count > 17U))
+    {
+        return false;
+    }
+
+    const char *const four_cc = reinterpret_cast<const char *>(&header.four_cc);
+
+    if ((mode == TextureCodec::NORMAL) && (std::strncmp(four_cc, "ATI2", 4U) == 0))
+    {
+        chain.format = GL_COMPRESSED_RG_RGTC2;
+    }
+
+    else if ((mode == TextureCodec::COLOR) && (std::strncmp(four_cc, "DXT1", 4U) == 0))
+    {
+        chain.format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+
+    else if ((mode == TextureCodec::COLOR) && (std::strncmp(four_cc, "DXT5", 4U) == 0))
+    {
+        chain.format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+
+    else
+    {
+        return false;
+    }
+
+    const std::size_t block_size = chain.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8U : 16U;
+    chain.width = static_cast<int>(header.width);
+    chain.height = static_cast<int>(header.height);
+    chain.level_stock.assign(1U, 0U);
+
+    for (std::uint32_t i = 0U; i < header.mip_count; i++)
+    {
+        const std::size_t blocks_x = (std::max(header.width >> i, 1U) + 3U) / 4U;
+        const std::size_t blocks_y = (std::max(header.height >> i, 1U) + 3U) / 4U;
+        chain.level_stock.emplace_back(chain.level_stock.back() + block_size * blocks_x * blocks_y);
+    }
+
+    if (file.getSize() - 4U - sizeof(header) < chain.level_stock.back())
+    {
+        return false;
+    }
+
+    chain.data.assign(file.getData() + 4U + sizeof(header), file.getData() + 4U + sizeof(header) + chain.level_stock.back());
+    return true;
+}
+
+/** Stores a chain as a DDS file, its rows go bottom up as they were uploaded */
+bool TextureCodec::write(const std::string &path, const TextureCodec::Mode &mode, const TextureCodec::Chain &chain)
+{
+    std::uint64_t stamp[2];
+    std::int64_t source_time;
+
+    if ((mode == TextureCodec::NONE) || !TextureCodec::readStatus(path, stamp[0], source_time))
+    {
+        return false;
+    }
+
+    stamp[1] = static_cast<std::uint64_t>(source_time);
+
+    TextureCodec::Header header;
+    std::memset(&header, 0, sizeof(header));
+
+    header.size = sizeof(header);
+    header.flags = 0x000A1007U;
+    header.height = static_cast<std::uint32_t>(chain.height);
+    header.width = static_cast<std::uint32_t>(chain.width);
+    header.linear_size = static_cast<std::uint32_t>(chain.level_stock[1]);
+    header.mip_count = static_cast<std::uint32_t>(chain.level_stock.size() - 1U);
+    header.reserved[0] = TextureCodec::STAMP;
+    header.reserved[1] = TextureCodec::VERSION;
+    std::memcpy(&header.reserved[2], stamp, sizeof(stamp));
+    header.format_size = 32U;
+    header.format_flags = 0x4U;
+    std::memcpy(&header.four_cc, chain.format == GL_COMPRESSED_RG_RGTC2 ? "ATI2" : chain.format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ? "DXT5" : "DXT1", 4U);
+    header.caps[0] = 0x00401008U;
+
+    std::ofstream file(path + TextureCodec::EXTENSION[mode], std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "warning: could not write the texture cache `" << path << TextureCodec::EXTENSION[mode] << "'" << std::endl;
+        return false;
+    }
+
+    file.write("DDS ", 4);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(chain.data.data()), static_cast<std::streamsize>(chain.data.size()));
+
+    return file.good();
+}
+
+/** Compression needs the S3TC formats, which the GL 3.3 core profile only has as an extension */
+bool TextureCodec::isEnabled()
+{
+    return TextureCodec::enabled && (GLAD_GL_EXT_texture_compression_s3tc != 0);
+}
+
+void TextureCodec::setEnabled(const bool &status)
+{
+    TextureCodec::enabled = status;
+}
\ No newline at end of file
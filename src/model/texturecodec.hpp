@@ -0,0 +1,80 @@
+#ifndef __TEXTURE_CODEC_HPP_
+#define __TEXTURE_CODEC_HPP_
+
+#include "../glad/glad.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Block compression of decoded images into BC1, BC3 or BC5 mip chains. The chains are stored as DDS files next to
+ * the source, stamped with its size and modification time, so warm starts skip decoding the source at all.
+ */
+class TextureCodec
+{
+public:
+    /** How an image is compressed, color maps pick BC1 or BC3 by their alpha and normal maps keep X and Y in BC5 */
+    enum Mode
+    {
+        NONE,
+        COLOR,
+        NORMAL
+    };
+
+    /** Mip chain, block compressed or `GL_RGBA8', the level `i' is stored from `level_stock[i]' to `level_stock[i + 1]' */
+    struct Chain
+    {
+        GLenum format;
+        int width;
+        int height;
+        std::vector<GLubyte> data;
+        std::vector<std::size_t> level_stock;
+    };
+
+private:
+    /** DDS header after the magic number, the reserved words keep the stamp of the source */
+    struct Header
+    {
+        std::uint32_t size;
+        std::uint32_t flags;
+        std::uint32_t height;
+        std::uint32_t width;
+        std::uint32_t linear_size;
+        std::uint32_t depth;
+        std::uint32_t mip_count;
+        std::uint32_t reserved[11];
+        std::uint32_t format_size;
+        std::uint32_t format_flags;
+        std::uint32_t four_cc;
+        std::uint32_t bit_count;
+        std::uint32_t mask[4];
+        std::uint32_t caps[4];
+        std::uint32_t reserved_end;
+    };
+
+    /** Read by the loader threads deciding how to decode their textures */
+    static std::atomic<bool> enabled;
+    static const std::uint32_t STAMP;
+    static const std::uint32_t VERSION;
+    static const std::string EXTENSION[3];
+
+    TextureCodec() = delete;
+    static bool readStatus(const std::string &path, std::uint64_t &size, std::int64_t &time);
+    static std::uint16_t packColor(const float *const color);
+    static void unpackColor(const std::uint16_t &packed, int *const color);
+    static void encodeColor(const GLubyte *const block, GLubyte *const target);
+    static void encodeChannel(const GLubyte *const block, const std::size_t &channel, GLubyte *const target);
+    static void downsample(const std::vector<GLubyte> &source, const int &width, const int &height, const TextureCodec::Mode &mode, std::vector<GLubyte> &target);
+
+public:
+    static void compress(const GLubyte *const pixels, const int &width, const int &height, const TextureCodec::Mode &mode, TextureCodec::Chain &chain);
+    static void mipmap(const GLubyte *const pixels, const int &width, const int &height, TextureCodec::Chain &chain);
+    static bool read(const std::string &path, const TextureCodec::Mode &mode, TextureCodec::Chain &chain);
+    static bool write(const std::string &path, const TextureCodec::Mode &mode, const TextureCodec::Chain &chain);
+    static bool isEnabled();
+    static void setEnabled(const bool &status);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "textureresidency.hpp"
+#include "texturestream.hpp"
+#include <algorithm>
+#include <cmath>
+
+bool TextureResidency::enabled = true;
+std::size_t TextureResidency::budget = 256U << 20U;
+std::size_t TextureResidency::resident = 0U;
+std::size_t TextureResidency::reserved = 0U;
+const int TextureResidency::TAIL_SIZE = 64;
+std::unordered_map<GLuint, TextureResidency::Entry> TextureResidency::entry_map;
+
+std::size_t TextureResidency::getLevelSize(const TextureResidency::Entry &entry, const GLint &level)
+{
+    return entry.chain.level_stock[level + 1] - entry.chain.level_stock[level];
+}
+
+std::size_t TextureResidency::getResidentSize(const TextureResidency::Entry &entry, const GLint &base)
+{
+    return entry.chain.level_stock.back() - entry.chain.level_stock[base];
+}
+
+/** Uploads the levels finer than the resident ones down to `base', or frees the ones above it */
+void TextureResidency::setBase(const GLuint &texture, TextureResidency::Entry &entry, const GLint &base)
+{
+    const TextureCodec::Chain &chain = entry.chain;
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    for (GLint i = entry.base - 1; i >= base; i--)
+    {
+        TextureStream::uploadLevel(GL_TEXTURE_2D, chain, i);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, base);
+
+    // An empty level releases its storage, the levels under the base are not part of the texture anyway
+    for (GLint i = entry.base; i < base; i++)
+    {
+        if (chain.format == GL_RGBA8)
+        {
+            glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+
+        else
+        {
+            glCompressedTexImage2D(GL_TEXTURE_2D, i, chain.format, 0, 0, 0, 0, nullptr);
+        }
+    }
+
+    resident = resident + TextureResidency::getResidentSize(entry, base) - TextureResidency::getResidentSize(entry, entry.base);
+    entry.base = base;
+}
+
+/**
+ * Takes a copy of the chain of the bound texture and uploads its mip tail, the levels no larger than `TAIL_SIZE'.
+ * Returns the number of bytes uploaded.
+ */
+std::size_t TextureResidency::insert(const GLuint &texture, const TextureCodec::Chain &chain)
+{
+    const GLint levels = static_cast<GLint>(chain.level_stock.size()) - 1;
+    GLint tail = 0;
+
+    while ((tail + 1 < levels) && (std::max(chain.width >> tail, chain.height >> tail) > TextureResidency::TAIL_SIZE))
+    {
+        tail++;
+    }
+
+    TextureResidency::erase(texture);
+    TextureResidency::Entry &entry = entry_map[texture];
+    entry = TextureResidency::Entry{chain, levels, tail, tail, 0.0F};
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    TextureResidency::setBase(texture, entry, enabled ? tail : 0);
+
+    return TextureResidency::getResidentSize(entry, entry.base);
+}
+
+void TextureResidency::erase(const GLuint &texture)
+{
+    const std::unordered_map<GLuint, TextureResidency::Entry>::iterator entry = entry_map.find(texture);
+
+    if (entry != entry_map.end())
+    {
+        resident -= TextureResidency::getResidentSize(entry->second, entry->second.base);
+        entry_map.erase(entry);
+    }
+}
+
+/** Asks for a texture covering about `pixels' pixels on screen this frame, the largest request wins */
+void TextureResidency::request(const GLuint &texture, const float &pixels)
+{
+    const std::unordered_map<GLuint, TextureResidency::Entry>::iterator entry = entry_map.find(texture);
+
+    if (entry != entry_map.end())
+    {
+        entry->second.pixels = std::max(entry->second.pixels, pixels);
+    }
+}
+
+/** Streams in every level at once, for copies that need the whole chain */
+void TextureResidency::makeResident(const GLuint &texture)
+{
+    const std::unordered_map<GLuint, TextureResidency::Entry>::iterator entry = entry_map.find(texture);
+
+    if ((entry != entry_map.end()) && (entry->second.base > 0))
+    {
+        TextureResidency::setBase(texture, entry->second, 0);
+    }
+}
+
+/** Counts memory that is not streamed as resident, so the streamed textures give up levels to stay in the budget */
+void TextureResidency::reserve(const std::size_t &bytes)
+{
+    reserved += bytes;
+}
+
+void TextureResidency::release(const std::size_t &bytes)
+{
+    reserved -= std::min(bytes, reserved);
+}
+
+/**
+ * Picks the level each texture needs for about a texel per pixel, gives up the finest levels of the largest ones
+ * while over the budget and evicts the levels not needed. The missing levels are streamed in, one per texture and
+ * pass, while `upload_budget' lasts. Returns the number of bytes uploaded.
+ */
+std::size_t TextureResidency::update(std::size_t &upload_budget)
+{
+    std::size_t total = reserved;
+
+    for (std::pair<const GLuint, TextureResidency::Entry> &entry_data : entry_map)
+    {
+        TextureResidency::Entry &entry = entry_data.second;
+        const float texels = static_cast<float>(std::max(entry.chain.width, entry.chain.height));
+
+        entry.target = !enabled ? 0 : entry.pixels <= 0.0F ? entry.tail : std::min(std::max(static_cast<GLint>(std::floor(std::log2(texels / entry.pixels))), 0), entry.tail);
+        entry.pixels = 0.0F;
+        total += TextureResidency::getResidentSize(entry, entry.target);
+    }
+
+    while (enabled && (total > budget))
+    {
+        TextureResidency::Entry *largest = nullptr;
+
+        for (std::pair<const GLuint, TextureResidency::Entry> &entry_data : entry_map)
+        {
+            TextureResidency::Entry &entry = entry_data.second;
+
+            if ((entry.target < entry.tail) && ((largest == nullptr) || (TextureResidency::getLevelSize(entry, entry.target) > TextureResidency::getLevelSize(*largest, largest->target))))
+            {
+                largest = &entry;
+            }
+        }
+
+        if (largest == nullptr)
+        {
+            break;
+        }
+
+        total -= TextureResidency::getLevelSize(*largest, largest->target);
+        largest->target++;
+    }
+
+    for (std::pair<const GLuint, TextureResidency::Entry> &entry_data : entry_map)
+    {
+        if (entry_data.second.target > entry_data.second.base)
+        {
+            TextureResidency::setBase(entry_data.first, entry_data.second, entry_data.second.target);
+        }
+    }
+
+    std::size_t bytes = 0U;
+    bool streaming = true;
+
+    while (streaming && (upload_budget > 0U))
+    {
+        streaming = false;
+
+        for (std::pair<const GLuint, TextureResidency::Entry> &entry_data : entry_map)
+        {
+            TextureResidency::Entry &entry = entry_data.second;
+
+            if ((entry.target >= entry.base) || (upload_budget == 0U))
+            {
+                continue;
+            }
+
+            const std::size_t size = TextureResidency::getLevelSize(entry, entry.base - 1);
+            TextureResidency::setBase(entry_data.first, entry, entry.base - 1);
+
+            upload_budget -= std::min(size, upload_budget);
+            bytes += size;
+            streaming = true;
+        }
+    }
+
+    return bytes;
+}
+
+bool TextureResidency::isEnabled()
+{
+    return enabled;
+}
+
+std::size_t TextureResidency::getBudget()
+{
+    return budget;
+}
+
+std::size_t TextureResidency::getResidentSize()
+{
+    return resident + reserved;
+}
+
+std::size_t TextureResidency::getSize()
+{
+    return entry_map.size();
+}
+
+void TextureResidency::setEnabled(const bool &status)
+{
+    enabled = status;
+}
+
+void TextureResidency::setBudget(const std::size_t &new_budget)
+{
+    budget = new_budget;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef __TEXTURE_RESIDENCY_HPP_
+#define __TEXTURE_RESIDENCY_HPP_
+
+#include "texturecodec.hpp"
+#include "../glad/glad.h"
+#include <cstddef>
+#include <unordered_map>
+
+/**
+ * Progressive residency of the mip chains, block compressed or RGBA. A texture starts with its mip tail and the finer
+ * levels are streamed in as the models using it need them on screen, limited by `GL_TEXTURE_BASE_LEVEL'. Textures no
+ * model asked for in a frame are evicted back to their tail, and the resident levels are kept within a fixed budget.
+ * The chains stay in system memory, since the evicted levels are uploaded again from them. Textures kept whole
+ * elsewhere, like the arrays of packed materials, are reserved from the budget. Only used from the GL thread.
+ */
+class TextureResidency
+{
+private:
+    /** Chain kept in memory, `base' is the finest level resident and `target' the one wanted this frame */
+    struct Entry
+    {
+        TextureCodec::Chain chain;
+        GLint base;
+        GLint target;
+        GLint tail;
+        float pixels;
+    };
+
+    static bool enabled;
+    static std::size_t budget;
+    static std::size_t resident;
+    static std::size_t reserved;
+    static const int TAIL_SIZE;
+    static std::unordered_map<GLuint, TextureResidency::Entry> entry_map;
+
+    TextureResidency() = delete;
+    static std::size_t getLevelSize(const TextureResidency::Entry &entry, const GLint &level);
+    static std::size_t getResidentSize(const TextureResidency::Entry &entry, const GLint &base);
+    static void setBase(const GLuint &texture, TextureResidency::Entry &entry, const GLint &base);
+
+public:
+    static std::size_t insert(const GLuint &texture, const TextureCodec::Chain &chain);
+    static void erase(const GLuint &texture);
+    static void request(const GLuint &texture, const float &pixels);
+    static void makeResident(const GLuint &texture);
+    static void reserve(const std::size_t &bytes);
+    static void release(const std::size_t &bytes);
+    static std::size_t update(std::size_t &upload_budget);
+    static bool isEnabled();
+    static std::size_t getBudget();
+    static std::size_t getResidentSize();
+    static std::size_t getSize();
+    static void setEnabled(const bool &status);
+    static void setBudget(const std::size_t &new_budget);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "texturestream.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+const std::size_t TextureStream::SLOT_SIZE = 4U << 20U;
+const std::size_t TextureStream::ALIGNMENT = 16U;
+const std::size_t TextureStream::FRAME_LIMIT = (TextureStream::SLOTS - 1U) * TextureStream::SLOT_SIZE;
+const GLuint64 TextureStream::WAIT_TIMEOUT = 1000000U;
+
+GLuint TextureStream::buffer = GL_FALSE;
+GLubyte *TextureStream::mapped = nullptr;
+GLsync TextureStream::fence[TextureStream::SLOTS] = {nullptr, nullptr, nullptr, nullptr};
+std::size_t TextureStream::slot = 0U;
+std::size_t TextureStream::used = 0U;
+std::size_t TextureStream::staged = 0U;
+
+/** Creates the ring on first use, persistently mapped when the context has buffer storage */
+bool TextureStream::createBuffer()
+{
+    if (buffer != GL_FALSE)
+    {
+        return true;
+    }
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(TextureStream::SLOTS * TextureStream::SLOT_SIZE);
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // Errors left by earlier calls would be taken for a failure below, a lost context keeps reporting one
+    for (int i = 0; (i < 16) && (glGetError() != GL_NO_ERROR); i++)
+    {
+    }
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+    if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)
+    {
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+        mapped = static_cast<GLubyte *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+    }
+
+    // Without a persistent mapping each write maps its own range
+    if (mapped == nullptr)
+    {
+        glDeleteBuffers(1, &buffer);
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_FALSE);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        std::cerr << "warning: could not create the texture upload buffer, uploading from client memory" << std::endl;
+        TextureStream::deleteBuffer();
+        return false;
+    }
+
+    return true;
+}
+
+/** Fences the uploads just issued from the open slot, the fence replaces the older one since they signal in order */
+void TextureStream::fenceSlot()
+{
+    if (fence[slot] != nullptr)
+    {
+        glDeleteSync(fence[slot]);
+    }
+
+    fence[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0U);
+}
+
+/** Waits up to `WAIT_TIMEOUT' nanoseconds for the uploads of a slot, returns false if they are still running */
+bool TextureStream::waitSlot(const std::size_t &index)
+{
+    if (fence[index] == nullptr)
+    {
+        return true;
+    }
+
+    const GLenum status = glClientWaitSync(fence[index], GL_SYNC_FLUSH_COMMANDS_BIT, TextureStream::WAIT_TIMEOUT);
+
+    if ((status != GL_ALREADY_SIGNALED) && (status != GL_CONDITION_SATISFIED))
+    {
+        return false;
+    }
+
+    glDeleteSync(fence[index]);
+    fence[index] = nullptr;
+    return true;
+}
+
+/**
+ * Copies `data' after the last write of the open slot and sets `offset' to its place in the ring, the buffer must be
+ * bound. A full slot is fenced and the next one is taken if its uploads are done. Returns false when the data has to
+ * be read from client memory instead, because the frame staged enough already or the next slot is still busy.
+ */
+bool TextureStream::write(const GLubyte *const data, const std::size_t &size, std::size_t &offset)
+{
+    std::size_t start = (used + TextureStream::ALIGNMENT - 1U) / TextureStream::ALIGNMENT * TextureStream::ALIGNMENT;
+
+    if (staged + size > TextureStream::FRAME_LIMIT)
+    {
+        return false;
+    }
+
+    if (start + size > TextureStream::SLOT_SIZE)
+    {
+        if (!TextureStream::waitSlot((slot + 1U) % TextureStream::SLOTS))
+        {
+            return false;
+        }
+
+        TextureStream::fenceSlot();
+        slot = (slot + 1U) % TextureStream::SLOTS;
+        start = 0U;
+    }
+
+    offset = slot * TextureStream::SLOT_SIZE + start;
+    used = start + size;
+    staged += size;
+
+    if (mapped != nullptr)
+    {
+        std::memcpy(mapped + offset, data, size);
+        return true;
+    }
+
+    // The fences already keep the range unused, so the driver does not need to synchronize
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    void *const target = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), access);
+
+    if (target != nullptr)
+    {
+        std::memcpy(target, data, size);
+    }
+
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    return true;
+}
+
+/**
+ * Allocates a level and fills it through the ring with glTexSubImage2D, in bands of rows when the image does not
+ * fit a slot. The bands the ring has no room for are read from client memory. The texels are tightly packed bytes
+ * with `components' per texel.
+ */
+void TextureStream::texImage2D(const GLenum &target, const GLint &level, const GLint &internal_format, const GLsizei &width, const GLsizei &height, const GLenum &format, const std::size_t &components, const GLubyte *const pixels)
+{
+    const std::size_t row = static_cast<std::size_t>(width) * components;
+
+    if ((row == 0U) || (row > TextureStream::SLOT_SIZE) || !TextureStream::createBuffer())
+    {
+        glTexImage2D(target, level, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+        return;
+    }
+
+    GLint alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexImage2D(target, level, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+    const GLsizei band = static_cast<GLsizei>(TextureStream::SLOT_SIZE / row);
+
+    for (GLsizei y = 0; y < height; y += band)
+    {
+        const GLsizei rows = std::min(band, height - y);
+        const GLubyte *const data = pixels + static_cast<std::size_t>(y) * row;
+        std::size_t offset;
+
+        if (TextureStream::write(data, static_cast<std::size_t>(rows) * row, offset))
+        {
+            glTexSubImage2D(target, level, 0, y, width, rows, format, GL_UNSIGNED_BYTE, reinterpret_cast<const void *>(offset));
+        }
+
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_FALSE);
+            glTexSubImage2D(target, level, 0, y, width, rows, format, GL_UNSIGNED_BYTE, data);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        }
+    }
+
+    TextureStream::fenceSlot();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_FALSE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+/** Uploads a compressed level through the ring, levels larger than a slot or without room in it are read from client memory */
+void TextureStream::compressedTexImage2D(const GLenum &target, const GLint &level, const GLenum &format, const GLsizei &width, const GLsizei &height, const std::size_t &size, const GLubyte *const data)
+{
+    std::size_t offset;
+
+    if ((size > TextureStream::SLOT_SIZE) || !TextureStream::createBuffer())
+    {
+        glCompressedTexImage2D(target, level, format, width, height, 0, static_cast<GLsizei>(size), data);
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+    if (TextureStream::write(data, size, offset))
+    {
+        glCompressedTexImage2D(target, level, format, width, height, 0, static_cast<GLsizei>(size), reinterpret_cast<const void *>(offset));
+        TextureStream::fenceSlot();
+    }
+
+    else
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_FALSE);
+        glCompressedTexImage2D(target, level, format, width, height, 0, static_cast<GLsizei>(size), data);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_FALSE);
+}
+
+/** Uploads the level `level' of a mip chain, compressed or not, to the same level of the bound texture */
+void TextureStream::uploadLevel(const GLenum &target, const TextureCodec::Chain &chain, const GLint &level)
+{
+    const GLsizei width = std::max(chain.width >> level, 1);
+    const GLsizei height = std::max(chain.height >> level, 1);
+    const GLubyte *const data = &chain.data[chain.level_stock[level]];
+
+    if (chain.format == GL_RGBA8)
+    {
+        TextureStream::texImage2D(target, level, GL_RGBA8, width, height, GL_RGBA, 4U, data);
+        return;
+    }
+
+    TextureStream::compressedTexImage2D(target, level, chain.format, width, height, chain.level_stock[level + 1] - chain.level_stock[level], data);
+}
+
+/** Starts the staging allowance of a new frame */
+void TextureStream::nextFrame()
+{
+    staged = 0U;
+}
+
+void TextureStream::deleteBuffer()
+{
+    for (std::size_t i = 0U; i < TextureStream::SLOTS; i++)
+    {
+        if (fence[i] != nullptr)
+        {
+            glDeleteSync(fence[i]);
+            fence[i] = nullptr;
+        }
+    }
+
+    if (buffer != GL_FALSE)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+        if (mapped != nullptr)
+        {
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_FALSE);
+        glDeleteBuffers(1, &buffer);
+    }
+
+    buffer = GL_FALSE;
+    mapped = nullptr;
+    slot = 0U;
+    used = 0U;
+    staged = 0U;
+}
\ No newline at end of file
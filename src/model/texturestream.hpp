@@ -0,0 +1,44 @@
+#ifndef __TEXTURE_STREAM_HPP_
+#define __TEXTURE_STREAM_HPP_
+
+#include "texturecodec.hpp"
+#include "../glad/glad.h"
+#include <cstddef>
+
+/**
+ * Ring of pixel buffer slots the texture uploads are staged through, so the driver copies them while the frame
+ * renders. The ring is persistently mapped when buffer storage is available and mapped unsynchronized otherwise,
+ * a fence after every upload guards its slot until the uploads reading it are done. A frame stages at most
+ * `FRAME_LIMIT' bytes and never waits long for a slot, the rest is read from client memory. Only used from the GL thread.
+ */
+class TextureStream
+{
+private:
+    static const std::size_t SLOTS = 4U;
+    static const std::size_t SLOT_SIZE;
+    static const std::size_t ALIGNMENT;
+    static const std::size_t FRAME_LIMIT;
+    static const GLuint64 WAIT_TIMEOUT;
+
+    static GLuint buffer;
+    static GLubyte *mapped;
+    static GLsync fence[SLOTS];
+    static std::size_t slot;
+    static std::size_t used;
+    static std::size_t staged;
+
+    TextureStream() = delete;
+    static bool createBuffer();
+    static void fenceSlot();
+    static bool waitSlot(const std::size_t &index);
+    static bool write(const GLubyte *const data, const std::size_t &size, std::size_t &offset);
+
+public:
+    static void texImage2D(const GLenum &target, const GLint &level, const GLint &internal_format, const GLsizei &width, const GLsizei &height, const GLenum &format, const std::size_t &components, const GLubyte *const pixels);
+    static void compressedTexImage2D(const GLenum &target, const GLint &level, const GLenum &format, const GLsizei &width, const GLsizei &height, const std::size_t &size, const GLubyte *const data);
+    static void uploadLevel(const GLenum &target, const TextureCodec::Chain &chain, const GLint &level);
+    static void nextFrame();
+    static void deleteBuffer();
+};
+
+#endif
\ No newline at end of file
@@ -184,19 +184,13 @@ void Camera::reset()
     updateProjectionMatrices();
 }
 
-void Camera::bind(GLSLProgram *const program) const
+/** Binds the frame block with the matrices and position, uploaded only when the camera changed */
+void Camera::bindBlock()
 {
-    if ((program == nullptr) || (!program->isValid()))
-    {
-        return;
-    }
+    const Camera::FrameBlock data = {view_mat, orthogonal ? orthogonal_mat : perspective_mat, glm::vec4(position, 0.0F)};
 
-    program->use();
-    program->setUniform("u_up_dir", up);
-    program->setUniform("u_view_dir", front);
-    program->setUniform("u_view_pos", position);
-    program->setUniform("u_view_mat", view_mat);
-    program->setUniform("u_projection_mat", orthogonal ? orthogonal_mat : perspective_mat);
+    block.update(&data, sizeof(data));
+    block.bind(UniformBlock::FRAME);
 }
 
 void Camera::travell(const Camera::Movement &direction, const double &time)
@@ -1,14 +1,22 @@
 #ifndef __CAMERA_HPP_
 #define __CAMERA_HPP_
 
-#include "../scene/glslprogram.hpp"
+#include "../scene/uniformblock.hpp"
 
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 
 class Camera {
     private:
+        /** Layout of the std140 frame block */
+        struct FrameBlock {
+            glm::mat4 view_mat;
+            glm::mat4 projection_mat;
+            glm::vec4 position;
+        };
+
         bool orthogonal;
         glm::vec3 position;
         glm::vec3 front;
@@ -30,6 +38,8 @@ class Camera {
         float pitch;
         float yaw;
 
+        UniformBlock block;
+
         Camera() = delete;
 
         void updateViewMatrix();
@@ -76,7 +86,7 @@ class Camera {
         void setResolution(const glm::vec2 &resolution);
         void setClipping(const glm::vec2 &clipping);
         void reset();
-        void bind(GLSLProgram *const program) const;
+        void bindBlock();
         void travell(const Camera::Movement &direction, const double &time = 1.0 / 30.0);
         void translate(const glm::vec3 &delta);
         void zoom(const double &direction);
@@ -1,10 +1,14 @@
 #include "glslprogram.hpp"
+#include "uniformblock.hpp"
+#include "../model/material.hpp"
+#include "../model/materialpack.hpp"
 #include <iostream>
 #include <fstream>
 
 GLuint GLSLProgram::current_program = GL_FALSE;
 
-GLint GLSLProgram::getUniformLocation(const GLchar *&name)
+/** Location of a uniform of the program in use, cached by name, -1 for any other program */
+GLint GLSLProgram::getUniformLocation(const GLchar *name)
 {
     if ((program == GL_FALSE) || (program != GLSLProgram::current_program))
     {
@@ -95,7 +99,8 @@ GLuint GLSLProgram::compileShaderSource(const GLchar *const &source, const GLenu
 }
 
 GLSLProgram::GLSLProgram() : program(GL_FALSE),
-                             shaders(0U) {}
+                             shaders(0U),
+                             attribute_mask(0U) {}
 
 GLSLProgram::GLSLProgram(const std::string &vert, const std::string &frag) :
 
@@ -104,7 +109,8 @@ GLSLProgram::GLSLProgram(const std::string &vert, const std::string &frag) :
                                                                              vert_path(vert),
                                                                              frag_path(frag),
 
-                                                                             shaders(0U)
+                                                                             shaders(0U),
+                                                                             attribute_mask(0U)
 {
 
     link();
@@ -118,7 +124,8 @@ GLSLProgram::GLSLProgram(const std::string &vert, const std::string &geom, const
                                                                                                       geom_path(geom),
                                                                                                       frag_path(frag),
 
-                                                                                                      shaders(0U)
+                                                                                                      shaders(0U),
+                                                                                                      attribute_mask(0U)
 {
 
     link();
@@ -129,6 +136,17 @@ bool GLSLProgram::isValid() const
     return program != GL_FALSE;
 }
 
+bool GLSLProgram::isAttributeActive(const GLuint &location) const
+{
+    return (location < 32U) && ((attribute_mask >> location) & 1U);
+}
+
+/** Only answers for the program in use, like the uniform setters */
+bool GLSLProgram::isUniformActive(const GLchar *name)
+{
+    return getUniformLocation(name) != -1;
+}
+
 GLuint GLSLProgram::getProgramObject() const
 {
     return program;
@@ -196,6 +214,11 @@ void GLSLProgram::setUniform(const GLchar *name, const glm::vec4 &vector)
     glUniform4fv(getUniformLocation(name), 1, &vector[0]);
 }
 
+void GLSLProgram::setUniform(const GLchar *name, const glm::ivec3 &vector)
+{
+    glUniform3iv(getUniformLocation(name), 1, &vector[0]);
+}
+
 void GLSLProgram::setUniform(const GLchar *name, const glm::mat3 &matrix)
 {
     glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
@@ -216,6 +239,8 @@ void GLSLProgram::link()
         program = GL_FALSE;
     }
 
+    attribute_mask = 0U;
+
     shaders = 0;
     bool mandatory_empty = false;
 
@@ -317,7 +342,36 @@ void GLSLProgram::link()
 
         glDeleteProgram(program);
         program = GL_FALSE;
+        return;
+    }
+
+    // Inputs the linker removed are not active, so the loaders can skip their data
+    GLint attributes;
+    GLint length;
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &attributes);
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length);
+
+    GLchar *name = new GLchar[length + 1];
+    for (GLint i = 0; i < attributes; i++)
+    {
+        GLint size;
+        GLenum type;
+        glGetActiveAttrib(program, static_cast<GLuint>(i), length + 1, nullptr, &size, &type, name);
+
+        const GLint location = glGetAttribLocation(program, name);
+        if ((location >= 0) && (location < 32))
+        {
+            attribute_mask |= 1U << location;
+        }
     }
+    delete[] name;
+
+    // The blocks and the sampler units of the geometry pass never change, so they are set once per program
+    UniformBlock::setBindings(program);
+
+    use();
+    Material::bindUnits(this);
+    MaterialPack::bindUnits(this);
 }
 
 void GLSLProgram::link(const std::string &vert, const std::string &frag)
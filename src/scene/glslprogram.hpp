@@ -23,9 +23,9 @@ private:
 
     std::size_t shaders;
     std::map<std::string, GLint> location_stock;
+    GLuint attribute_mask;
     GLSLProgram(const GLSLProgram &) = delete;
     GLSLProgram &operator=(const GLSLProgram &) = delete;
-    GLint getUniformLocation(const GLchar *&name);
     static GLuint current_program;
     static GLuint compileShaderFile(const std::string &path, const GLenum &type);
     static GLuint compileShaderSource(const GLchar *const &source, const GLenum &type);
@@ -35,6 +35,9 @@ public:
     GLSLProgram(const std::string &vert, const std::string &frag);
     GLSLProgram(const std::string &vert, const std::string &geom, const std::string &frag);
     bool isValid() const;
+    bool isAttributeActive(const GLuint &location) const;
+    bool isUniformActive(const GLchar *name);
+    GLint getUniformLocation(const GLchar *name);
     GLuint getProgramObject() const;
     std::string getShaderPath(const GLenum &type) const;
     std::size_t getNumberOfShaders() const;
@@ -44,6 +47,7 @@ public:
     void setUniform(const GLchar *name, const glm::vec2 &vector);
     void setUniform(const GLchar *name, const glm::vec3 &vector);
     void setUniform(const GLchar *name, const glm::vec4 &vector);
+    void setUniform(const GLchar *name, const glm::ivec3 &vector);
     void setUniform(const GLchar *name, const glm::mat3 &matrix);
     void setUniform(const GLchar *name, const glm::mat4 &matrix);
     void link();
@@ -2,6 +2,11 @@
 
 #include "customwidgets.hpp"
 
+#include "../../model/loader/meshcache.hpp"
+#include "../../model/loader/objloader.hpp"
+#include "../../model/texturecodec.hpp"
+#include "../../model/textureresidency.hpp"
+
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
@@ -19,6 +24,7 @@ const std::map<Material::Attribute, std::string> InteractiveScene::AVAILABLE_TEX
     {Material::DISPLACEMENT, "Displacement"}};
 
 const char *InteractiveScene::LIGHT_TYPE_LABEL[] = {"Directional", "Point", "Spotlight"};
+const char *InteractiveScene::LIGHTING_MODE_LABEL[] = {"Pass per light", "Single pass", "Clustered"};
 
 char InteractiveScene::repository_url[] = "";
 
@@ -271,6 +277,110 @@ void InteractiveScene::showMainGUIWindow()
             ImGui::TreePop();
         }
 
+        if (ImGui::TreeNode("OBJ loader"))
+        {
+            const OBJLoader::Mode mode = OBJLoader::getMode();
+            if (ImGui::RadioButton("Stream", mode == OBJLoader::STREAM))
+            {
+                OBJLoader::setMode(OBJLoader::STREAM);
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Mapped", mode == OBJLoader::MAPPED))
+            {
+                OBJLoader::setMode(OBJLoader::MAPPED);
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Compare", mode == OBJLoader::COMPARE))
+            {
+                OBJLoader::setMode(OBJLoader::COMPARE);
+            }
+            ImGui::HelpMarker("Compare parses with both methods,\nprints the timings and checks that\nthe results are the same");
+
+            int threads = static_cast<int>(OBJLoader::getThreads());
+            if (ImGui::SliderInt("Threads", &threads, 0, 32))
+            {
+                OBJLoader::setThreads(static_cast<std::size_t>(threads));
+            }
+            ImGui::HelpMarker("Threads used by the mapped parser,\n0 uses every hardware thread");
+
+            bool cache = MeshCache::isEnabled();
+            if (ImGui::Checkbox("Binary cache", &cache))
+            {
+                MeshCache::setEnabled(cache);
+            }
+            ImGui::HelpMarker("Stores the parsed models next to the\nsource as `.objcache' files and reads\nthem back while the source is unchanged");
+
+            bool compressed = TextureCodec::isEnabled();
+            if (ImGui::Checkbox("Compressed textures", &compressed))
+            {
+                TextureCodec::setEnabled(compressed);
+            }
+            ImGui::HelpMarker("Block compresses the diffuse, specular\nand normal maps of the next models read,\nstored as `.color.dds' and `.normal.dds'");
+
+            bool streaming = TextureResidency::isEnabled();
+            if (ImGui::Checkbox("Stream texture levels", &streaming))
+            {
+                TextureResidency::setEnabled(streaming);
+            }
+            ImGui::HelpMarker("Textures start with their smallest\nlevels and stream in the finer ones\nas they get closer on screen");
+
+            int texture_budget = static_cast<int>(TextureResidency::getBudget() >> 20U);
+            if (ImGui::SliderInt("Texture budget", &texture_budget, 16, 2048, "%d MiB"))
+            {
+                TextureResidency::setBudget(static_cast<std::size_t>(texture_budget) << 20U);
+            }
+            ImGui::HelpMarker("Memory kept by the streamed levels\nand the texture arrays, the largest\ntextures lose their finest levels first");
+            ImGui::Text("Resident: %.1f MiB in %lu textures", static_cast<double>(TextureResidency::getResidentSize()) / 1048576.0, TextureResidency::getSize());
+
+            bool optimize = optimize_meshes;
+            if (ImGui::Checkbox("Optimize meshes", &optimize))
+            {
+                setOptimizingMeshes(optimize);
+            }
+            ImGui::HelpMarker("Reorders triangles and vertices for\nthe vertex cache, overdraw and fetch");
+
+            bool pack = pack_vertices;
+            if (ImGui::Checkbox("Packed vertices", &pack))
+            {
+                setPackingVertices(pack);
+            }
+            ImGui::HelpMarker("Stores 20 instead of 44 bytes per vertex,\n16 bit positions, half float UVs and\noctahedral normals and tangents");
+
+            bool lods = generate_lods;
+            if (ImGui::Checkbox("Levels of detail", &lods))
+            {
+                setGeneratingLods(lods);
+            }
+            ImGui::HelpMarker("Simplifies every object into a chain of\nlevels with half the triangles each, the\ndrawn level is picked by its screen error");
+
+            int levels = static_cast<int>(ModelLoader::getLodLevels());
+            if (ImGui::SliderInt("LOD levels", &levels, 0, 8))
+            {
+                ModelLoader::setLodLevels(static_cast<std::size_t>(levels));
+            }
+            ImGui::HelpMarker("Simplified levels generated by the\nnext loads, besides the full model");
+
+            ImGui::DragFloat("LOD error", &lod_threshold, 0.05F, 0.0F, 64.0F, "%.2f px");
+            ImGui::HelpMarker("Largest simplification error allowed\non screen, in pixels");
+
+            ImGui::Checkbox("Cluster culling", &cull_clusters);
+            ImGui::HelpMarker("Skips the clusters of about 128 triangles\noutside the view frustum");
+
+            ImGui::Checkbox("Backface clusters", &cull_backfaces);
+            ImGui::HelpMarker("Also skips the clusters facing away from\nthe camera, the faces are counter clockwise\nand open meshes lose their inner side");
+
+            ImGui::Checkbox("Texture arrays", &pack_materials);
+            ImGui::HelpMarker("Packs the textures of each model into\narrays, one group of arrays per texture\nsize, so the materials are bound once\nper group, needs OpenGL 4.3 or\nARB_copy_image");
+
+            int budget = static_cast<int>(upload_budget >> 20U);
+            if (ImGui::SliderInt("Upload budget", &budget, 1, 256, "%d MiB"))
+            {
+                upload_budget = static_cast<std::size_t>(budget) << 20U;
+            }
+            ImGui::HelpMarker("Bytes uploaded to the GPU per frame\nwhile models load in the background");
+            ImGui::TreePop();
+        }
+
         if (ImGui::TreeNode("Statistics*"))
         {
 
@@ -279,14 +389,22 @@ void InteractiveScene::showMainGUIWindow()
             std::size_t triangles = 0U;
             std::size_t materials = 0U;
             std::size_t textures = 0U;
+            std::size_t drawn = 0U;
+            std::size_t clusters = 0U;
+            std::size_t frustum_culled = 0U;
+            std::size_t backface_culled = 0U;
 
             for (const std::pair<const std::size_t, const std::pair<const Model *const, const std::size_t>> &program_data : model_stock)
             {
+                drawn += program_data.second.first->getLodTriangles(program_data.second.first->getLod());
                 vertices += program_data.second.first->getNumberOfVertices();
                 elements += program_data.second.first->getNumberOfElements();
                 triangles += program_data.second.first->getNumberOfTriangles();
                 materials += program_data.second.first->getNumberOfMaterials();
                 textures += program_data.second.first->getNumberOfTextures();
+                clusters += program_data.second.first->getNumberOfClusters();
+                frustum_culled += program_data.second.first->getFrustumCulledClusters();
+                backface_culled += program_data.second.first->getBackfaceCulledClusters();
             }
 
             std::size_t shaders = 0U;
@@ -308,6 +426,27 @@ void InteractiveScene::showMainGUIWindow()
                 ImGui::SameLine(210.0F);
                 ImGui::Text("Textures:  %lu", textures);
                 ImGui::Text("Triangles: %lu", triangles);
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Drawn:     %lu", drawn);
+                ImGui::HelpMarker("Triangles of the current levels of detail");
+                ImGui::Text("Clusters:  %lu", clusters);
+                ImGui::HelpMarker("Clusters tested by the culling pass");
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Culled:    %.1f%%", clusters == 0U ? 0.0F : 100.0F * static_cast<float>(frustum_culled + backface_culled) / static_cast<float>(clusters));
+                ImGui::HelpMarker("Outside the view frustum or facing away");
+                ImGui::Text("Frustum:   %.1f%%", clusters == 0U ? 0.0F : 100.0F * static_cast<float>(frustum_culled) / static_cast<float>(clusters));
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Backface:  %.1f%%", clusters == 0U ? 0.0F : 100.0F * static_cast<float>(backface_culled) / static_cast<float>(clusters));
+                ImGui::TreePop();
+            }
+
+            if (ImGui::TreeNodeEx("lightstats", ImGuiTreeNodeFlags_DefaultOpen, "Lights: %lu", light_stock.size()))
+            {
+                ImGui::Text("Buffered:  %lu", lighting_mode != Scene::PER_LIGHT ? light_grid.getNumberOfLights() : 0U);
+                ImGui::HelpMarker("Lights reaching the view in the last frame");
+                ImGui::SameLine(210.0F);
+                ImGui::Text("Indices:   %lu", lighting_mode == Scene::CLUSTERED ? light_grid.getNumberOfIndices() : 0U);
+                ImGui::HelpMarker("Light references kept by all the clusters");
                 ImGui::TreePop();
             }
 
@@ -487,6 +626,30 @@ void InteractiveScene::showMainGUIWindow()
             ImGui::EndCombo();
         }
         ImGui::PopItemWidth();
+
+        ImGui::PushItemWidth(-25.0F);
+        if (ImGui::BeginCombo("###lighting_mode", InteractiveScene::LIGHTING_MODE_LABEL[lighting_mode]))
+        {
+            for (GLint i = Scene::PER_LIGHT; i <= Scene::CLUSTERED; i++)
+            {
+
+                const Scene::LightingMode new_mode = static_cast<Scene::LightingMode>(i);
+                bool selected = lighting_mode == new_mode;
+
+                if (ImGui::Selectable(InteractiveScene::LIGHTING_MODE_LABEL[new_mode], selected))
+                {
+                    lighting_mode = new_mode;
+                }
+
+                if (selected)
+                {
+                    ImGui::SetItemDefaultFocus();
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::PopItemWidth();
+        ImGui::HelpMarker("A single pass reads the geometry buffer\nonce and loops over every light, the\nclustered one only over the lights\nreaching the cluster of each fragment");
         ImGui::Unindent();
 
         for (std::pair<const std::size_t, std::pair<GLSLProgram *, std::string>> &program_data : program_stock)
@@ -628,7 +791,11 @@ bool InteractiveScene::modelWidget(std::pair<Model *, std::size_t> &model_data)
 
     if (!model->isOpen())
     {
-        if (!model->Model::getPath().empty())
+        if (model->isLoading())
+        {
+            ImGui::TextColored(ImVec4(0.80F, 0.64F, 0.16F, 1.00F), "Loading...");
+        }
+        else if (!model->Model::getPath().empty())
         {
             ImGui::TextColored(ImVec4(0.80F, 0.16F, 0.16F, 1.00F), "Could not open the model");
         }
@@ -646,6 +813,18 @@ bool InteractiveScene::modelWidget(std::pair<Model *, std::size_t> &model_data)
         ImGui::SameLine(210.0F);
         ImGui::Text("Textures:  %lu", model->getNumberOfTextures());
         ImGui::Text("Triangles: %lu", model->getNumberOfTriangles());
+        if (model->getLoaderOptions() & ModelLoader::OPTIMIZE)
+        {
+            ImGui::Text("ACMR:      %.3f -> %.3f", model->getACMR(false), model->getACMR());
+            ImGui::HelpMarker("Average cache miss ratio, vertex\nshader runs per triangle with a\nFIFO cache of 16 vertices");
+            ImGui::Text("ATVR:      %.3f -> %.3f", model->getATVR(false), model->getATVR());
+            ImGui::HelpMarker("Average transformed vertex ratio,\nvertex shader runs per vertex");
+        }
+        for (std::size_t i = 0U; i < model->getNumberOfLods(); i++)
+        {
+            const ImVec4 color = i == model->getLod() ? ImVec4(0.16F, 0.80F, 0.16F, 1.00F) : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+            ImGui::TextColored(color, "LOD %lu:     %lu triangles, error %.4g", i, model->getLodTriangles(i), model->getLodError(i));
+        }
         ImGui::TreePop();
     }
 
@@ -667,7 +846,11 @@ bool InteractiveScene::modelWidget(std::pair<Model *, std::size_t> &model_data)
                 new_program = program_data.first;
             }
         }
-        model_data.second = new_program;
+        if (new_program != model_data.second)
+        {
+            model_data.second = new_program;
+            model->setLoaderOptions(getLoaderOptions(new_program));
+        }
         ImGui::EndCombo();
     }
 
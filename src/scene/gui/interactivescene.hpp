@@ -35,6 +35,7 @@ class InteractiveScene : public Scene {
         void processKeyboardInput();
         static const std::map<Material::Attribute, std::string> AVAILABLE_TEXTURE;
         static const char *LIGHT_TYPE_LABEL[];
+        static const char *LIGHTING_MODE_LABEL[];
         static char repository_url[];
 
         static void framebufferSizeCallback(GLFWwindow *window, int width, int height);
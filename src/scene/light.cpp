@@ -1,6 +1,12 @@
 #include "light.hpp"
 
 #include <glm/trigonometric.hpp>
+#include <glm/matrix.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+
+const float Light::THRESHOLD = 1.0F / 256.0F;
 
 Light::Light(const Light::Type &type) :
 
@@ -96,6 +102,54 @@ float Light::getShininess() const
     return shininess;
 }
 
+/**
+ * Distance where the attenuation takes the brightest color of the light under `THRESHOLD', infinite for the
+ * directional lights and the ones with no falloff. A negative range means the light is always below it.
+ */
+float Light::getRange() const
+{
+    if (type == Light::DIRECTIONAL)
+    {
+        return INFINITY;
+    }
+
+    const glm::vec3 color = ambient_level * ambient_color + diffuse_level * diffuse_color + specular_level * specular_color;
+    const float limit = std::max(std::max(color.r, color.g), color.b) / Light::THRESHOLD - attenuation.x;
+
+    if (limit <= 0.0F)
+    {
+        return -1.0F;
+    }
+
+    if (attenuation.z > 0.0F)
+    {
+        return (std::sqrt(attenuation.y * attenuation.y + 4.0F * attenuation.z * limit) - attenuation.y) / (2.0F * attenuation.z);
+    }
+
+    return attenuation.y > 0.0F ? limit / attenuation.y : INFINITY;
+}
+
+/** Spotlights lighting nothing outside their cone, the ambient term is not cut by the cutoff */
+bool Light::hasConeVolume() const
+{
+    return (type == Light::SPOTLIGHT) && (ambient_level * ambient_color == glm::vec3(0.0F)) && (std::max(cutoff.x, cutoff.y) < glm::radians(80.0F));
+}
+
+/** Transform of the unit sphere bounding the range, or of the unit cone pointing down -Z for `hasConeVolume' */
+glm::mat4 Light::getVolumeMatrix() const
+{
+    const float range = getRange();
+
+    if (!hasConeVolume())
+    {
+        return glm::scale(glm::translate(glm::mat4(1.0F), position), glm::vec3(range));
+    }
+
+    const float radius = range * std::tan(std::max(cutoff.x, cutoff.y));
+    const glm::vec3 up = std::abs(direction.y) > 0.99F ? glm::vec3(1.0F, 0.0F, 0.0F) : glm::vec3(0.0F, 1.0F, 0.0F);
+    return glm::scale(glm::inverse(glm::lookAt(position, position - direction, up)), glm::vec3(radius, radius, range));
+}
+
 void Light::setEnabled(const bool &status)
 {
     enabled = status;
@@ -166,47 +220,28 @@ void Light::setShininess(const float &value)
     shininess = value;
 }
 
-void Light::bind(GLSLProgram *const program) const
+/** Binds the light block with the volume transform, uploaded only when the light changed */
+void Light::bindBlock()
 {
+    const float range = getRange();
+    Light::LightBlock data = {glm::mat4(1.0F), direction, type, position, shininess, glm::vec4(attenuation, 0.0F), glm::vec4(glm::cos(cutoff), 0.0F, 0.0F),
+                              glm::vec4(ambient_level * ambient_color, 0.0F), glm::vec4(diffuse_level * diffuse_color, 0.0F), glm::vec4(specular_level * specular_color, 0.0F)};
 
-    if ((program == nullptr) || (!program->isValid()))
+    // Only the lights with a finite range have a volume
+    if ((range >= 0.0F) && !std::isinf(range))
     {
-        return;
+        data.volume_mat = getVolumeMatrix();
     }
 
-    program->use();
-
-    if (enabled)
+    // A disabled light adds nothing
+    if (!enabled)
     {
-        program->setUniform("u_light_type", type);
-
-        if (type != Light::POINT)
-        {
-            program->setUniform("u_light_direction", direction);
-        }
-
-        if (type != Light::DIRECTIONAL)
-        {
-            program->setUniform("u_light_position", position);
-            program->setUniform("u_light_attenuation", attenuation);
-            if (type == Light::SPOTLIGHT)
-            {
-                program->setUniform("u_light_cutoff", glm::cos(cutoff));
-            }
-        }
-
-        program->setUniform("u_ambient", ambient_level * ambient_color);
-        program->setUniform("u_diffuse", diffuse_level * diffuse_color);
-        program->setUniform("u_specular", specular_level * specular_color);
-        program->setUniform("u_shininess", shininess);
+        data.type = Light::DIRECTIONAL;
+        data.ambient = glm::vec4(0.0F);
+        data.diffuse = glm::vec4(0.0F);
+        data.specular = glm::vec4(0.0F);
     }
 
-    else
-    {
-        program->setUniform("u_light_type", Light::DIRECTIONAL);
-
-        program->setUniform("u_ambient", glm::vec3(0.0F));
-        program->setUniform("u_diffuse", glm::vec3(0.0F));
-        program->setUniform("u_specular", glm::vec3(0.0F));
-    }
+    block.update(&data, sizeof(data));
+    block.bind(UniformBlock::LIGHT);
 }
\ No newline at end of file
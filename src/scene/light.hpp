@@ -1,9 +1,11 @@
 #ifndef __LIGHT_HPP_
 #define __LIGHT_HPP_
 
-#include "glslprogram.hpp"
+#include "uniformblock.hpp"
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 
 class Light
 {
@@ -16,6 +18,21 @@ public:
     };
 
 private:
+    /** Layout of the std140 light block */
+    struct LightBlock
+    {
+        glm::mat4 volume_mat;
+        glm::vec3 direction;
+        GLint type;
+        glm::vec3 position;
+        GLfloat shininess;
+        glm::vec4 attenuation;
+        glm::vec4 cutoff;
+        glm::vec4 ambient;
+        glm::vec4 diffuse;
+        glm::vec4 specular;
+    };
+
     bool enabled;
     bool grabbed;
     Light::Type type;
@@ -30,6 +47,11 @@ private:
     float diffuse_level;
     float specular_level;
     float shininess;
+    UniformBlock block;
+    static const float THRESHOLD;
+
+    Light(const Light &) = delete;
+    Light &operator=(const Light &) = delete;
 
 public:
     Light(const Light::Type &type = Light::DIRECTIONAL);
@@ -47,6 +69,9 @@ public:
     float getDiffuseLevel() const;
     float getSpecularLevel() const;
     float getShininess() const;
+    float getRange() const;
+    bool hasConeVolume() const;
+    glm::mat4 getVolumeMatrix() const;
     void setEnabled(const bool &status);
     void setGrabbed(const bool &status);
     void setType(const Light::Type &new_type);
@@ -61,7 +86,7 @@ public:
     void setDiffuseLevel(const float &value);
     void setSpecularLevel(const float &value);
     void setShininess(const float &value);
-    void bind(GLSLProgram *const program) const;
+    void bindBlock();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "lightgrid.hpp"
+#include <glm/trigonometric.hpp>
+#include <algorithm>
+#include <cmath>
+
+LightGrid::LightGrid() : buffer{GL_FALSE, GL_FALSE, GL_FALSE},
+                         buffer_texture{GL_FALSE, GL_FALSE, GL_FALSE},
+                         global_lights(0),
+                         grid_size(0),
+                         slice_depth(0.0F),
+                         view_mat(1.0F) {}
+
+/** Exponential slice of a view depth, the shaders use the same scale and bias */
+GLint LightGrid::getSlice(const float &depth) const
+{
+    return std::min(std::max(static_cast<GLint>(std::floor(std::log(depth) * slice_depth.x + slice_depth.y)), 0), LightGrid::SLICES - 1);
+}
+
+/** The rows the shaders read for a light, in the layout of the light uniforms */
+void LightGrid::addRows(const Light *const light)
+{
+    const glm::vec2 cutoff = glm::cos(glm::radians(light->getCutoff()));
+
+    row_stock.emplace_back(light->getPosition(), static_cast<GLfloat>(light->getType()));
+    row_stock.emplace_back(-light->getDirection(), cutoff.x);
+    row_stock.emplace_back(light->getAttenuation(), cutoff.y);
+    row_stock.emplace_back(light->getAmbientLevel() * light->getAmbientColor(), light->getShininess());
+    row_stock.emplace_back(light->getDiffuseLevel() * light->getDiffuseColor(), 0.0F);
+    row_stock.emplace_back(light->getSpecularLevel() * light->getSpecularColor(), 0.0F);
+}
+
+/**
+ * Adds the light to the clusters touched by the sphere of its range. The screen rectangle comes from the corners of
+ * the box around the sphere, cut at the near plane so every corner projects in front of the camera. Returns false
+ * when the light reaches no cluster.
+ */
+bool LightGrid::addLight(const GLuint &index, const Light *const light, const float &range, const Camera *const camera)
+{
+    const glm::vec2 clipping = camera->getClipping();
+    const glm::vec3 center(view_mat * glm::vec4(light->getPosition(), 1.0F));
+
+    if ((-center.z + range < clipping.x) || (-center.z - range > clipping.y))
+    {
+        return false;
+    }
+
+    const glm::mat4 projection_mat = camera->getProjectionMatrix();
+    glm::vec2 low(INFINITY);
+    glm::vec2 high(-INFINITY);
+
+    for (int i = 0; i < 8; i++)
+    {
+        const glm::vec3 corner(center.x + ((i & 1) ? range : -range), center.y + ((i & 2) ? range : -range), std::min(center.z + ((i & 4) ? range : -range), -clipping.x));
+        const glm::vec4 clip = projection_mat * glm::vec4(corner, 1.0F);
+
+        low = glm::min(low, glm::vec2(clip) / clip.w);
+        high = glm::max(high, glm::vec2(clip) / clip.w);
+    }
+
+    if ((high.x < -1.0F) || (high.y < -1.0F) || (low.x > 1.0F) || (low.y > 1.0F))
+    {
+        return false;
+    }
+
+    const GLint min_x = std::max(static_cast<GLint>(std::floor((low.x * 0.5F + 0.5F) * LightGrid::TILES_X)), 0);
+    const GLint min_y = std::max(static_cast<GLint>(std::floor((low.y * 0.5F + 0.5F) * LightGrid::TILES_Y)), 0);
+    const GLint max_x = std::min(static_cast<GLint>(std::floor((high.x * 0.5F + 0.5F) * LightGrid::TILES_X)), LightGrid::TILES_X - 1);
+    const GLint max_y = std::min(static_cast<GLint>(std::floor((high.y * 0.5F + 0.5F) * LightGrid::TILES_Y)), LightGrid::TILES_Y - 1);
+    const GLint min_z = getSlice(std::max(-center.z - range, clipping.x));
+    const GLint max_z = getSlice(std::min(-center.z + range, clipping.y));
+
+    for (GLint z = min_z; z <= max_z; z++)
+    {
+        for (GLint y = min_y; y <= max_y; y++)
+        {
+            for (GLint x = min_x; x <= max_x; x++)
+            {
+                cluster_stock[static_cast<std::size_t>((z * LightGrid::TILES_Y + y) * LightGrid::TILES_X + x)].push_back(index);
+            }
+        }
+    }
+
+    return true;
+}
+
+/** Replaces the contents of one of the texture buffers, orphaning the previous storage */
+void LightGrid::upload(const std::size_t &target, const GLenum &format, const void *const data, const std::size_t &size)
+{
+    const bool created = buffer[target] == GL_FALSE;
+
+    if (created)
+    {
+        glGenBuffers(1, &buffer[target]);
+        glGenTextures(1, &buffer_texture[target]);
+    }
+
+    // Texture buffers cannot be empty
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer[target]);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(std::max(size, sizeof(glm::vec4))), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+    glBindBuffer(GL_TEXTURE_BUFFER, GL_FALSE);
+
+    if (created)
+    {
+        glBindTexture(GL_TEXTURE_BUFFER, buffer_texture[target]);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, buffer[target]);
+    }
+}
+
+std::size_t LightGrid::getNumberOfLights() const
+{
+    return row_stock.size() / LightGrid::ROW_SIZE;
+}
+
+std::size_t LightGrid::getNumberOfIndices() const
+{
+    return index_stock.size();
+}
+
+/**
+ * Bins the enabled lights for the camera, the disabled ones and those too dim to be seen are left out. Unless
+ * `clustered', every light goes to the list all the fragments read.
+ */
+void LightGrid::update(const std::map<std::size_t, Light *> &light_stock, const Camera *const camera, const bool &clustered)
+{
+    const glm::vec2 clipping = camera->getClipping();
+    const float log_ratio = std::log(clipping.y / clipping.x);
+
+    view_mat = camera->getViewMatrix();
+    slice_depth = glm::vec2(LightGrid::SLICES / log_ratio, -LightGrid::SLICES * std::log(clipping.x) / log_ratio);
+    row_stock.clear();
+    index_stock.clear();
+    grid_size = clustered ? glm::ivec3(LightGrid::TILES_X, LightGrid::TILES_Y, LightGrid::SLICES) : glm::ivec3(1);
+    cluster_stock.resize(static_cast<std::size_t>(grid_size.x * grid_size.y * grid_size.z));
+
+    for (std::vector<GLuint> &cluster : cluster_stock)
+    {
+        cluster.clear();
+    }
+
+    // The lights reaching every cluster go first, the shaders read them by position
+    for (const std::pair<const std::size_t, Light *> &light_data : light_stock)
+    {
+        const float range = light_data.second->getRange();
+
+        if (light_data.second->isEnabled() && (std::isinf(range) || (!clustered && (range >= 0.0F))))
+        {
+            addRows(light_data.second);
+        }
+    }
+
+    global_lights = static_cast<GLint>(getNumberOfLights());
+
+    for (const std::pair<const std::size_t, Light *> &light_data : light_stock)
+    {
+        const float range = light_data.second->getRange();
+
+        if (clustered && light_data.second->isEnabled() && (range >= 0.0F) && !std::isinf(range) && addLight(static_cast<GLuint>(getNumberOfLights()), light_data.second, range, camera))
+        {
+            addRows(light_data.second);
+        }
+    }
+
+    // Offset and count of each cluster in the shared index list
+    cell_stock.clear();
+
+    for (const std::vector<GLuint> &cluster : cluster_stock)
+    {
+        cell_stock.push_back(static_cast<GLuint>(index_stock.size()));
+        cell_stock.push_back(static_cast<GLuint>(cluster.size()));
+        index_stock.insert(index_stock.end(), cluster.begin(), cluster.end());
+    }
+
+    upload(0U, GL_RGBA32F, row_stock.data(), row_stock.size() * sizeof(glm::vec4));
+    upload(1U, GL_RG32UI, cell_stock.data(), cell_stock.size() * sizeof(GLuint));
+    upload(2U, GL_R32UI, index_stock.data(), index_stock.size() * sizeof(GLuint));
+}
+
+void LightGrid::bind(GLSLProgram *const program) const
+{
+    program->setUniform("u_view_mat", view_mat);
+    program->setUniform("u_cluster_size", grid_size);
+    program->setUniform("u_cluster_depth", slice_depth);
+    program->setUniform("u_global_lights", global_lights);
+
+    for (GLenum i = 0U; i < 3U; i++)
+    {
+        glActiveTexture(GL_TEXTURE5 + i);
+        glBindTexture(GL_TEXTURE_BUFFER, buffer_texture[i]);
+    }
+}
+
+/** The texture buffers take the units after the geometry buffers, samplers of different types can never share one */
+void LightGrid::bindUnits(GLSLProgram *const program)
+{
+    program->setUniform("u_light_buffer", 5);
+    program->setUniform("u_cluster_buffer", 6);
+    program->setUniform("u_light_index_buffer", 7);
+}
+
+void LightGrid::clear()
+{
+    // Nothing was created without a context
+    if (buffer[0] != GL_FALSE)
+    {
+        glDeleteTextures(3, buffer_texture);
+        glDeleteBuffers(3, buffer);
+    }
+
+    std::fill(buffer, buffer + 3, GL_FALSE);
+    std::fill(buffer_texture, buffer_texture + 3, GL_FALSE);
+    global_lights = 0;
+    row_stock.clear();
+    cell_stock.clear();
+    index_stock.clear();
+    cluster_stock.clear();
+}
+
+LightGrid::~LightGrid()
+{
+    clear();
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef __LIGHT_GRID_HPP_
+#define __LIGHT_GRID_HPP_
+
+#include "camera.hpp"
+#include "light.hpp"
+#include "glslprogram.hpp"
+#include "../glad/glad.h"
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <map>
+#include <vector>
+
+/**
+ * Lights binned into clusters, screen tiles split in exponential depth slices, so the lighting pass shades every
+ * light in a single draw and each fragment only evaluates the lights reaching its cluster. The grid is built on the
+ * CPU each frame and read from texture buffers, which OpenGL 3.3 already has. Directional lights and the ones with
+ * no falloff reach every cluster and are kept apart. Without clustering the grid is a single empty cluster and every
+ light is kept apart, which saves the binning when there are only a few lights.
+ */
+class LightGrid
+{
+private:
+    static const GLint TILES_X = 16;
+    static const GLint TILES_Y = 8;
+    static const GLint SLICES = 16;
+    static const GLint ROW_SIZE = 6;
+
+    GLuint buffer[3];
+    GLuint buffer_texture[3];
+    GLint global_lights;
+    glm::ivec3 grid_size;
+    glm::vec2 slice_depth;
+    glm::mat4 view_mat;
+    std::vector<glm::vec4> row_stock;
+    std::vector<GLuint> cell_stock;
+    std::vector<GLuint> index_stock;
+    std::vector<std::vector<GLuint>> cluster_stock;
+
+    LightGrid(const LightGrid &) = delete;
+    LightGrid &operator=(const LightGrid &) = delete;
+    GLint getSlice(const float &depth) const;
+    void addRows(const Light *const light);
+    bool addLight(const GLuint &index, const Light *const light, const float &range, const Camera *const camera);
+    void upload(const std::size_t &target, const GLenum &format, const void *const data, const std::size_t &size);
+
+public:
+    LightGrid();
+    std::size_t getNumberOfLights() const;
+    std::size_t getNumberOfIndices() const;
+    void update(const std::map<std::size_t, Light *> &light_stock, const Camera *const camera, const bool &clustered = true);
+    void bind(GLSLProgram *const program) const;
+    void clear();
+    ~LightGrid();
+    static void bindUnits(GLSLProgram *const program);
+};
+
+#endif
\ No newline at end of file
@@ -1,8 +1,15 @@
 #include "scene.hpp"
+#include "../model/textureresidency.hpp"
+#include "../model/texturestream.hpp"
 
+#include <glm/matrix.hpp>
+#include <glm/gtc/constants.hpp>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
-#define TEXTURE_BUFFERS 6
+#define TEXTURE_BUFFERS 5
+#define COLOR_BUFFERS 4
 std::size_t Scene::instances = 0U;
 std::size_t Scene::element_id = 1U;
 bool Scene::initialized_glad = false;
@@ -11,8 +18,14 @@ GLsizei Scene::screen_height = 0U;
 GLuint Scene::square_vao = GL_FALSE;
 GLuint Scene::square_vbo = GL_FALSE;
 GLuint Scene::fbo = GL_FALSE;
-GLuint Scene::rbo = GL_FALSE;
 GLuint Scene::buffer_texture[TEXTURE_BUFFERS];
+GLuint Scene::lighting_fbo = GL_FALSE;
+GLuint Scene::lighting_rbo[2];
+GLuint Scene::volume_vao = GL_FALSE;
+GLuint Scene::volume_vbo = GL_FALSE;
+GLuint Scene::volume_ebo = GL_FALSE;
+GLsizei Scene::sphere_elements = 0;
+GLsizei Scene::cone_elements = 0;
 const GLubyte *Scene::opengl_vendor = nullptr;
 const GLubyte *Scene::opengl_renderer = nullptr;
 const GLubyte *Scene::opengl_version = nullptr;
@@ -24,44 +37,70 @@ void Scene::createGeometryFrameBuffer()
     glBindFramebuffer(GL_FRAMEBUFFER, Scene::fbo);
     glGenTextures(TEXTURE_BUFFERS, Scene::buffer_texture);
 
-    Scene::attachTextureToFrameBuffer(0, GL_RGB16F, GL_RGB, GL_FLOAT);
+    // Octahedral normal
+    Scene::attachTextureToFrameBuffer(0, GL_COLOR_ATTACHMENT0, GL_RG16, GL_RG, GL_UNSIGNED_SHORT);
 
-    Scene::attachTextureToFrameBuffer(1, GL_RGB16F, GL_RGB, GL_FLOAT);
+    // Diffuse color with the metalness, or zero alpha for transparent fragments
+    Scene::attachTextureToFrameBuffer(1, GL_COLOR_ATTACHMENT1, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
 
-    Scene::attachTextureToFrameBuffer(2, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE);
+    // Ambient color and shininess
+    Scene::attachTextureToFrameBuffer(2, GL_COLOR_ATTACHMENT2, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
 
-    Scene::attachTextureToFrameBuffer(3, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE);
+    // Specular color and roughness
+    Scene::attachTextureToFrameBuffer(3, GL_COLOR_ATTACHMENT3, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
 
-    Scene::attachTextureToFrameBuffer(4, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE);
+    // The position is rebuilt from the depth, the stencil lets it be blitted to the lighting frame buffer
+    Scene::attachTextureToFrameBuffer(4, GL_DEPTH_STENCIL_ATTACHMENT, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8);
 
-    Scene::attachTextureToFrameBuffer(5, GL_RGBA16F, GL_RGBA, GL_FLOAT);
-
-    GLenum attachment[TEXTURE_BUFFERS];
-    for (GLuint i = 0; i < TEXTURE_BUFFERS; i++)
+    GLenum attachment[COLOR_BUFFERS];
+    for (GLuint i = 0; i < COLOR_BUFFERS; i++)
     {
         attachment[i] = GL_COLOR_ATTACHMENT0 + i;
     }
 
-    glDrawBuffers(TEXTURE_BUFFERS, attachment);
+    glDrawBuffers(COLOR_BUFFERS, attachment);
+
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "error: the geometry frame buffer object status is not complete (" << status << ")" << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/**
+ * The lighting pass draws here and the result is blitted to the window. The light volumes test against a copy of
+ * the geometry depth, the shaders sample the original and it cannot be attached while they do.
+ */
+void Scene::createLightingFrameBuffer()
+{
+    glGenFramebuffers(1, &Scene::lighting_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, Scene::lighting_fbo);
+    glGenRenderbuffers(2, Scene::lighting_rbo);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, Scene::lighting_rbo[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, Scene::screen_width, Scene::screen_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, Scene::lighting_rbo[0]);
 
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, Scene::lighting_rbo[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Scene::screen_width, Scene::screen_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, Scene::lighting_rbo[1]);
 
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, Scene::screen_width, Scene::screen_height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, GL_FALSE);
 
     const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE)
     {
-        std::cerr << "error: the geometry frame buffer object status is not complete (" << status << ")" << std::endl;
+        std::cerr << "error: the lighting frame buffer object status is not complete (" << status << ")" << std::endl;
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void Scene::attachTextureToFrameBuffer(const GLenum &attachment, const GLint &internalFormat, const GLenum &format, const GLenum &type)
+void Scene::attachTextureToFrameBuffer(const GLuint &index, const GLenum &attachment, const GLint &internalFormat, const GLenum &format, const GLenum &type)
 {
-    glBindTexture(GL_TEXTURE_2D, Scene::buffer_texture[attachment]);
+    glBindTexture(GL_TEXTURE_2D, Scene::buffer_texture[index]);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -70,7 +109,7 @@ void Scene::attachTextureToFrameBuffer(const GLenum &attachment, const GLint &in
 
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, Scene::screen_width, Scene::screen_height, 0, format, type, nullptr);
 
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachment, GL_TEXTURE_2D, Scene::buffer_texture[attachment], 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, Scene::buffer_texture[index], 0);
 }
 
 void Scene::createSquare()
@@ -99,6 +138,80 @@ void Scene::createSquare()
     glBindVertexArray(GL_FALSE);
 }
 
+/**
+ * Unit sphere followed by the unit cone with its apex at the origin and its base at z = -1, both in one buffer. The
+ * meshes are scaled so their flat faces stay outside the shapes they stand for.
+ */
+void Scene::createVolumes()
+{
+    const GLuint SEGMENTS = 16U;
+    const GLuint RINGS = 8U;
+    const float sphere_radius = 1.0F / (std::cos(glm::pi<float>() / SEGMENTS) * std::cos(glm::pi<float>() / (2U * RINGS)));
+    const float cone_radius = 1.0F / std::cos(glm::pi<float>() / SEGMENTS);
+
+    std::vector<glm::vec3> vertex_stock;
+    std::vector<GLuint> index_stock;
+
+    for (GLuint ring = 0U; ring <= RINGS; ring++)
+    {
+        const float theta = glm::pi<float>() * ring / RINGS;
+
+        for (GLuint segment = 0U; segment < SEGMENTS; segment++)
+        {
+            const float phi = 2.0F * glm::pi<float>() * segment / SEGMENTS;
+            vertex_stock.emplace_back(sphere_radius * std::sin(theta) * std::cos(phi), sphere_radius * std::cos(theta), sphere_radius * std::sin(theta) * std::sin(phi));
+        }
+    }
+
+    for (GLuint ring = 0U; ring < RINGS; ring++)
+    {
+        for (GLuint segment = 0U; segment < SEGMENTS; segment++)
+        {
+            const GLuint top = ring * SEGMENTS;
+            const GLuint bottom = top + SEGMENTS;
+            const GLuint next = (segment + 1U) % SEGMENTS;
+            index_stock.insert(index_stock.end(), {top + segment, bottom + segment, top + next, top + next, bottom + segment, bottom + next});
+        }
+    }
+
+    Scene::sphere_elements = static_cast<GLsizei>(index_stock.size());
+
+    const GLuint apex = static_cast<GLuint>(vertex_stock.size());
+    vertex_stock.emplace_back(0.0F, 0.0F, 0.0F);
+    vertex_stock.emplace_back(0.0F, 0.0F, -1.0F);
+
+    for (GLuint segment = 0U; segment < SEGMENTS; segment++)
+    {
+        const float phi = 2.0F * glm::pi<float>() * segment / SEGMENTS;
+        vertex_stock.emplace_back(cone_radius * std::cos(phi), cone_radius * std::sin(phi), -1.0F);
+    }
+
+    for (GLuint segment = 0U; segment < SEGMENTS; segment++)
+    {
+        const GLuint rim = apex + 2U + segment;
+        const GLuint next = apex + 2U + (segment + 1U) % SEGMENTS;
+        index_stock.insert(index_stock.end(), {apex, rim, next, apex + 1U, next, rim});
+    }
+
+    Scene::cone_elements = static_cast<GLsizei>(index_stock.size()) - Scene::sphere_elements;
+
+    glGenVertexArrays(1, &Scene::volume_vao);
+    glBindVertexArray(Scene::volume_vao);
+
+    glGenBuffers(1, &Scene::volume_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, Scene::volume_vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_stock.size() * sizeof(glm::vec3)), vertex_stock.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &Scene::volume_ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Scene::volume_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(index_stock.size() * sizeof(GLuint)), index_stock.data(), GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), reinterpret_cast<void *>(0));
+
+    glBindVertexArray(GL_FALSE);
+}
+
 void Scene::errorCallback(int error, const char *description)
 {
     std::cerr << "error " << error << ": " << description << std::endl;
@@ -118,14 +231,116 @@ void Scene::framebufferSizeCallback(GLFWwindow *window, int width, int height)
     }
 }
 
+/** Loader options needed by a geometry pass program, tangents are only computed when the program reads them */
+GLenum Scene::getLoaderOptions(const std::size_t &program_id)
+{
+    std::map<std::size_t, std::pair<GLSLProgram *, std::string>>::const_iterator result = program_stock.find(program_id);
+    const GLSLProgram *const program = (result == program_stock.end() ? program_stock[0U] : result->second).first;
+
+    GLenum options = ModelLoader::ALL_OPTIONS;
+
+    if (!optimize_meshes)
+    {
+        options &= ~ModelLoader::OPTIMIZE;
+    }
+
+    if (!pack_vertices)
+    {
+        options &= ~ModelLoader::QUANTIZE;
+    }
+
+    if (!generate_lods)
+    {
+        options &= ~ModelLoader::LOD;
+    }
+
+    if (!program->isValid())
+    {
+        return options;
+    }
+
+    return program->isAttributeActive(3U) ? options : options & ~ModelLoader::TANGENTS;
+}
+
+void Scene::updateLoaderOptions()
+{
+    // Only the models missing an option, or changing their vertex layout, are read again
+    for (std::pair<const std::size_t, std::pair<Model *, std::size_t>> &model_data : model_stock)
+    {
+        model_data.second.first->setLoaderOptions(getLoaderOptions(model_data.second.second));
+    }
+}
+
+/**
+ * Marks in the stencil the pixels whose geometry lies inside the volume of the light. Back faces behind the geometry
+ * count up and front faces behind it count down, so only the pixels between both stay non zero. The volume transform
+ * is read from the light block, which must be bound. Leaves the stencil test set up for the light pass.
+ */
+void Scene::drawLightVolume(const Light *const light)
+{
+    glEnable(GL_STENCIL_TEST);
+    glClear(GL_STENCIL_BUFFER_BIT);
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+
+    // Volumes crossing the far plane are clamped instead of clipped
+    glEnable(GL_DEPTH_CLAMP);
+
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+    glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+
+    volume_program->use();
+
+    glBindVertexArray(Scene::volume_vao);
+
+    if (light->hasConeVolume())
+    {
+        glDrawElements(GL_TRIANGLES, Scene::cone_elements, GL_UNSIGNED_INT, reinterpret_cast<void *>(Scene::sphere_elements * sizeof(GLuint)));
+    }
+
+    else
+    {
+        glDrawElements(GL_TRIANGLES, Scene::sphere_elements, GL_UNSIGNED_INT, reinterpret_cast<void *>(0));
+    }
+
+    glDisable(GL_DEPTH_CLAMP);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_DEPTH_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+}
+
 void Scene::drawScene()
 {
     GLSLProgram *program;
 
+    // Models read in the background are uploaded a few megabytes per frame
+    std::size_t budget = upload_budget;
+    TextureStream::nextFrame();
+    for (std::pair<const std::size_t, std::pair<Model *, std::size_t>> &model_data : model_stock)
+    {
+        model_data.second.first->update(budget);
+        model_data.second.first->selectLod(active_camera, lod_threshold);
+        model_data.second.first->cullClusters(cull_clusters ? active_camera : nullptr, cull_backfaces);
+        model_data.second.first->requestTextures(active_camera);
+        model_data.second.first->packMaterials(pack_materials);
+        model_data.second.first->updateBlocks();
+    }
+
+    TextureResidency::update(budget);
+
     glBindFramebuffer(GL_FRAMEBUFFER, Scene::fbo);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glViewport(0, 0, screen_width, screen_height);
 
+    // The camera, model and material data are read from uniform blocks, only bound between draws
+    active_camera->bindBlock();
+
     for (const std::pair<const std::size_t, std::pair<const Model *const, const std::size_t>> model_data : model_stock)
     {
         if (!model_data.second.first->isOpen())
@@ -135,30 +350,38 @@ void Scene::drawScene()
 
         std::map<std::size_t, std::pair<GLSLProgram *, std::string>>::const_iterator result = program_stock.find(model_data.second.second);
         program = (result == program_stock.end() ? program_stock[0U] : result->second).first;
-        active_camera->bind(program);
         model_data.second.first->draw(program);
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, GL_FALSE);
+    // The light volumes test against a copy of the geometry depth
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, Scene::fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, Scene::lighting_fbo);
+    glBlitFramebuffer(0, 0, screen_width, screen_height, 0, 0, screen_width, screen_height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, Scene::lighting_fbo);
 
     glDisable(GL_DEPTH_TEST);
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE);
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glViewport(0, 0, width, height);
+    // The passes add to the background, the pixels no light reaches keep it
+    glClearColor(background_color.r, background_color.g, background_color.b, 1.0F);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(0.0F, 0.0F, 0.0F, 0.0F);
 
+    const glm::mat4 view_projection_mat = active_camera->getProjectionMatrix() * active_camera->getViewMatrix();
     std::map<std::size_t, std::pair<GLSLProgram *, std::string>>::const_iterator result = program_stock.find(lighting_program);
 
     program = (result == program_stock.end() ? program_stock[1U] : result->second).first;
     program->use();
     program->setUniform("u_view_pos", active_camera->getPosition());
-    program->setUniform("u_position_tex", 0);
-    program->setUniform("u_normal_tex", 1);
+    program->setUniform("u_inverse_view_projection_mat", glm::inverse(view_projection_mat));
+    program->setUniform("u_background_color", glm::vec3(0.0F));
+    program->setUniform("u_normal_tex", 0);
+    program->setUniform("u_diffuse_tex", 1);
     program->setUniform("u_ambient_tex", 2);
-    program->setUniform("u_diffuse_tex", 3);
-    program->setUniform("u_specular_tex", 4);
-    program->setUniform("u_metadata_tex", 5);
+    program->setUniform("u_specular_tex", 3);
+    program->setUniform("u_depth_tex", 4);
+    LightGrid::bindUnits(program);
 
     for (GLenum i = 0; i < TEXTURE_BUFFERS; i++)
     {
@@ -167,24 +390,62 @@ void Scene::drawScene()
     }
 
     glBindVertexArray(Scene::square_vao);
+    program->setUniform("u_buffered_lights", static_cast<GLint>(lighting_mode != Scene::PER_LIGHT));
 
-    int pass = 0;
-    for (const std::pair<const std::size_t, const Light *const> &light_data : light_stock)
+    // Every light in a single pass, read from the light buffer, clustered or not
+    if (lighting_mode != Scene::PER_LIGHT)
     {
-        if (pass < 2)
+        light_grid.update(light_stock, active_camera, lighting_mode == Scene::CLUSTERED);
+        light_grid.bind(program);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    else
+    {
+        // Programs without the light block, like the debug views, shade the whole screen for every light
+        const bool volumes = volume_program->isValid() && UniformBlock::isActive(program->getProgramObject(), UniformBlock::LIGHT);
+
+        for (const std::pair<const std::size_t, Light *> &light_data : light_stock)
         {
-            program->setUniform("u_background_color", pass == 0 ? background_color : glm::vec3(0.0F));
-            pass++;
+            Light *const light = light_data.second;
+            const float range = light->getRange();
+
+            // Disabled lights and the ones too dim to be seen draw nothing
+            if (!light->isEnabled() || (range < 0.0F))
+            {
+                continue;
+            }
+
+            // Lights with a finite range only shade the pixels inside their volume
+            const bool stencil = volumes && !std::isinf(range);
+            light->bindBlock();
+
+            if (stencil)
+            {
+                drawLightVolume(light);
+                glBindVertexArray(Scene::square_vao);
+                program->use();
+            }
+
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+            if (stencil)
+            {
+                glDisable(GL_STENCIL_TEST);
+            }
         }
-
-        light_data.second->bind(program);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
 
     glBindVertexArray(GL_FALSE);
 
     glEnable(GL_DEPTH_TEST);
     glDisable(GL_BLEND);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, Scene::lighting_fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GL_FALSE);
+    glBlitFramebuffer(0, 0, screen_width, screen_height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, GL_FALSE);
+    glViewport(0, 0, width, height);
 }
 
 Scene::Scene(const std::string &title, const int &width, const int &height, const int &context_ver_maj, const int &context_ver_min) : window(nullptr),
@@ -194,7 +455,17 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
 
                                                                                                                                       background_color(0.0F),
                                                                                                                                       active_camera(nullptr),
-                                                                                                                                      lighting_program(1U)
+                                                                                                                                      lighting_program(1U),
+                                                                                                                                      upload_budget(1U << 24U),
+                                                                                                                                      optimize_meshes(true),
+                                                                                                                                      pack_vertices(false),
+                                                                                                                                      generate_lods(true),
+                                                                                                                                      lod_threshold(1.0F),
+                                                                                                                                      cull_clusters(true),
+                                                                                                                                      cull_backfaces(false),
+                                                                                                                                      pack_materials(false),
+                                                                                                                                      lighting_mode(Scene::CLUSTERED),
+                                                                                                                                      volume_program(nullptr)
 {
 
     bool create_window = true;
@@ -258,6 +529,7 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
 
             program_stock[0U] = std::pair<GLSLProgram *, std::string>(new GLSLProgram(), "Empty (Default geometry pass)");
             program_stock[1U] = std::pair<GLSLProgram *, std::string>(new GLSLProgram(), "Empty (Default lighting pass)");
+            volume_program = new GLSLProgram();
         }
     }
 
@@ -267,7 +539,9 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
         Scene::screen_width = video_mode->width;
         Scene::screen_height = video_mode->height;
         Scene::createSquare();
+        Scene::createVolumes();
         Scene::createGeometryFrameBuffer();
+        Scene::createLightingFrameBuffer();
 
         Material::createDefaultTextures();
     }
@@ -366,11 +640,84 @@ double Scene::getFrames() const
     return kframes;
 }
 
+std::size_t Scene::getUploadBudget() const
+{
+    return upload_budget;
+}
+
+bool Scene::isOptimizingMeshes() const
+{
+    return optimize_meshes;
+}
+
+bool Scene::isPackingVertices() const
+{
+    return pack_vertices;
+}
+
+bool Scene::isGeneratingLods() const
+{
+    return generate_lods;
+}
+
+float Scene::getLodThreshold() const
+{
+    return lod_threshold;
+}
+
+bool Scene::isCullingClusters() const
+{
+    return cull_clusters;
+}
+
+bool Scene::isCullingBackfaces() const
+{
+    return cull_backfaces;
+}
+
 void Scene::setBackgroundColor(const glm::vec3 &color)
 {
     background_color = color;
 }
 
+void Scene::setUploadBudget(const std::size_t &budget)
+{
+    upload_budget = budget;
+}
+
+void Scene::setOptimizingMeshes(const bool &status)
+{
+    optimize_meshes = status;
+    updateLoaderOptions();
+}
+
+void Scene::setPackingVertices(const bool &status)
+{
+    pack_vertices = status;
+    updateLoaderOptions();
+}
+
+void Scene::setGeneratingLods(const bool &status)
+{
+    generate_lods = status;
+    updateLoaderOptions();
+}
+
+void Scene::setLodThreshold(const float &threshold)
+{
+    lod_threshold = threshold;
+}
+
+void Scene::setCullingClusters(const bool &status)
+{
+    cull_clusters = status;
+}
+
+void Scene::setCullingBackfaces(const bool &status)
+{
+    cull_backfaces = status;
+}
+
 bool Scene::selectCamera(const std::size_t &id)
 {
     std::map<std::size_t, Camera *>::const_iterator result = camera_stock.find(id);
@@ -398,7 +745,7 @@ std::size_t Scene::addModel()
 
 std::size_t Scene::addModel(const std::string &path, const std::size_t &program_id)
 {
-    model_stock[Scene::element_id] = std::pair<Model *, std::size_t>(new Model(path), program_id);
+    model_stock[Scene::element_id] = std::pair<Model *, std::size_t>(new Model(path, getLoaderOptions(program_id)), program_id);
     return Scene::element_id++;
 }
 
@@ -466,6 +813,12 @@ void Scene::setDefaultLightingPassProgramDescription(const std::string &desc)
     program_stock[1U].second = desc;
 }
 
+/** Program drawing the light volumes into the stencil, lights are shaded on the whole screen without it */
+void Scene::setLightVolumeProgram(const std::string &vert, const std::string &frag)
+{
+    volume_program->link(vert, frag);
+}
+
 void Scene::setTitle(const std::string &new_title)
 {
     title = new_title;
@@ -484,6 +837,7 @@ std::size_t Scene::setProgramToModel(const std::size_t &program_id, const std::s
 
     const std::size_t previous_program = result->second.second;
     result->second.second = program_id;
+    result->second.first->setLoaderOptions(getLoaderOptions(program_id));
     return previous_program;
 }
 
@@ -523,6 +877,13 @@ void Scene::reloadPrograms()
     {
         program_data.second.first->link();
     }
+
+    if (volume_program->getNumberOfShaders() > 0U)
+    {
+        volume_program->link();
+    }
+
+    updateLoaderOptions();
 }
 
 bool Scene::removeCamera(const std::size_t &id)
@@ -652,6 +1013,9 @@ Scene::~Scene()
         delete program_data.second.first;
     }
 
+    delete volume_program;
+    light_grid.clear();
+
     if (window != nullptr)
     {
         glfwDestroyWindow(window);
@@ -661,13 +1025,19 @@ Scene::~Scene()
     {
 
         glDeleteTextures(TEXTURE_BUFFERS, Scene::buffer_texture);
-        glDeleteRenderbuffers(1, &Scene::rbo);
         glDeleteFramebuffers(1, &Scene::fbo);
+        glDeleteRenderbuffers(2, Scene::lighting_rbo);
+        glDeleteFramebuffers(1, &Scene::lighting_fbo);
+
+        glDeleteBuffers(1, &Scene::volume_ebo);
+        glDeleteBuffers(1, &Scene::volume_vbo);
+        glDeleteVertexArrays(1, &Scene::volume_vao);
 
         glDeleteBuffers(1, &Scene::square_vbo);
         glDeleteBuffers(1, &Scene::square_vao);
 
         Material::deleteDefaultTextures();
+        TextureStream::deleteBuffer();
 
         glfwTerminate();
 
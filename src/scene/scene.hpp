@@ -4,6 +4,7 @@
 #include "camera.hpp"
 #include "../model/model.hpp"
 #include "light.hpp"
+#include "lightgrid.hpp"
 #include "glslprogram.hpp"
 #include "../glad/glad.h"
 #include <GLFW/glfw3.h>
@@ -14,6 +15,14 @@
 
 class Scene
 {
+public:
+    enum LightingMode : GLint
+    {
+        PER_LIGHT,
+        SINGLE_PASS,
+        CLUSTERED
+    };
+
 protected:
     GLFWwindow *window;
 
@@ -30,6 +39,17 @@ protected:
     std::size_t lighting_program;
     std::map<std::size_t, std::pair<GLSLProgram *, std::string>> program_stock;
     double kframes;
+    std::size_t upload_budget;
+    bool optimize_meshes;
+    bool pack_vertices;
+    bool generate_lods;
+    float lod_threshold;
+    bool cull_clusters;
+    bool cull_backfaces;
+    bool pack_materials;
+    Scene::LightingMode lighting_mode;
+    LightGrid light_grid;
+    GLSLProgram *volume_program;
 
     Scene() = delete;
 
@@ -38,6 +58,9 @@ protected:
     Scene &operator=(const Scene &) = delete;
 
     void drawScene();
+    void drawLightVolume(const Light *const light);
+    GLenum getLoaderOptions(const std::size_t &program_id);
+    void updateLoaderOptions();
     static std::size_t instances;
     static std::size_t element_id;
     static bool initialized_glad;
@@ -46,8 +69,14 @@ protected:
     static GLuint square_vao;
     static GLuint square_vbo;
     static GLuint fbo;
-    static GLuint rbo;
     static GLuint buffer_texture[];
+    static GLuint lighting_fbo;
+    static GLuint lighting_rbo[2];
+    static GLuint volume_vao;
+    static GLuint volume_vbo;
+    static GLuint volume_ebo;
+    static GLsizei sphere_elements;
+    static GLsizei cone_elements;
     static const GLubyte *opengl_vendor;
     static const GLubyte *opengl_renderer;
 
@@ -55,9 +84,11 @@ protected:
     static const GLubyte *glsl_version;
 
     static void createGeometryFrameBuffer();
+    static void createLightingFrameBuffer();
 
-    static void attachTextureToFrameBuffer(const GLenum &attachment, const GLint &internalFormat, const GLenum &format, const GLenum &type);
+    static void attachTextureToFrameBuffer(const GLuint &index, const GLenum &attachment, const GLint &internalFormat, const GLenum &format, const GLenum &type);
     static void createSquare();
+    static void createVolumes();
     static void errorCallback(int error, const char *description);
     static void framebufferSizeCallback(GLFWwindow *window, int width, int height);
 
@@ -80,7 +111,21 @@ public:
     GLSLProgram *getDefaultLightingPassProgram();
     std::string getDefaultLightingPassProgramDescription();
     double getFrames() const;
+    std::size_t getUploadBudget() const;
+    bool isOptimizingMeshes() const;
+    bool isPackingVertices() const;
+    bool isGeneratingLods() const;
+    float getLodThreshold() const;
+    bool isCullingClusters() const;
+    bool isCullingBackfaces() const;
     void setBackgroundColor(const glm::vec3 &color);
+    void setUploadBudget(const std::size_t &budget);
+    void setOptimizingMeshes(const bool &status);
+    void setPackingVertices(const bool &status);
+    void setGeneratingLods(const bool &status);
+    void setLodThreshold(const float &threshold);
+    void setCullingClusters(const bool &status);
+    void setCullingBackfaces(const bool &status);
     bool selectCamera(const std::size_t &id);
     std::size_t addCamera(const bool &orthogonal = false);
     std::size_t addModel();
@@ -95,6 +140,7 @@ public:
     void setDefaultGeometryPassProgramDescription(const std::string &desc);
     void setDefaultLightingPassProgram(const std::string &desc, const std::string &vert, const std::string &frag);
     void setDefaultLightingPassProgramDescription(const std::string &desc);
+    void setLightVolumeProgram(const std::string &vert, const std::string &frag);
     void setTitle(const std::string &new_title);
     std::size_t setProgramToModel(const std::size_t &program_id, const std::size_t &model_id);
     virtual void mainLoop();
@@ -0,0 +1,68 @@
+#include "uniformblock.hpp"
+#include <cstring>
+
+const GLchar *const UniformBlock::BLOCK_NAME[4] = {"FrameData", "ObjectData", "MaterialData", "LightData"};
+
+UniformBlock::UniformBlock() : buffer(GL_FALSE) {}
+
+void UniformBlock::update(const void *const new_data, const std::size_t &size)
+{
+    if ((buffer != GL_FALSE) && (data.size() == size) && (std::memcmp(data.data(), new_data, size) == 0))
+    {
+        return;
+    }
+
+    const GLubyte *const bytes = static_cast<const GLubyte *>(new_data);
+    data.assign(bytes, bytes + size);
+
+    if (buffer == GL_FALSE)
+    {
+        glGenBuffers(1, &buffer);
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), new_data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, GL_FALSE);
+}
+
+void UniformBlock::bind(const UniformBlock::Binding &binding) const
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+}
+
+void UniformBlock::clear()
+{
+    // Nothing was created without a context
+    if (buffer != GL_FALSE)
+    {
+        glDeleteBuffers(1, &buffer);
+    }
+
+    buffer = GL_FALSE;
+    data.clear();
+}
+
+UniformBlock::~UniformBlock()
+{
+    clear();
+}
+
+/** Binds the blocks the program declares to their points, the ones it lacks are skipped */
+void UniformBlock::setBindings(const GLuint &program)
+{
+    for (GLuint i = UniformBlock::FRAME; i <= UniformBlock::LIGHT; i++)
+    {
+        const GLuint index = glGetUniformBlockIndex(program, UniformBlock::BLOCK_NAME[i]);
+
+        if (index != GL_INVALID_INDEX)
+        {
+            glUniformBlockBinding(program, index, i);
+        }
+    }
+}
+
+/** Checks if the program declares the block, the linker may also leave out a block the program never reads */
+bool UniformBlock::isActive(const GLuint &program, const UniformBlock::Binding &binding)
+{
+    return glGetUniformBlockIndex(program, UniformBlock::BLOCK_NAME[binding]) != GL_INVALID_INDEX;
+}
\ No newline at end of file
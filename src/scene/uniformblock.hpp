@@ -0,0 +1,41 @@
+#ifndef __UNIFORM_BLOCK_HPP_
+#define __UNIFORM_BLOCK_HPP_
+
+#include "../glad/glad.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * Uniform buffer holding the std140 data of a block, uploaded only when it changes. Each block takes a fixed binding
+ * point set on every program when it is linked, GLSL 3.30 cannot choose it in the shader.
+ */
+class UniformBlock
+{
+public:
+    enum Binding : GLuint
+    {
+        FRAME,
+        OBJECT,
+        MATERIAL,
+        LIGHT
+    };
+
+private:
+    GLuint buffer;
+    std::vector<GLubyte> data;
+
+    UniformBlock(const UniformBlock &) = delete;
+    UniformBlock &operator=(const UniformBlock &) = delete;
+    static const GLchar *const BLOCK_NAME[4];
+
+public:
+    UniformBlock();
+    void update(const void *const new_data, const std::size_t &size);
+    void bind(const UniformBlock::Binding &binding) const;
+    void clear();
+    ~UniformBlock();
+    static void setBindings(const GLuint &program);
+    static bool isActive(const GLuint &program, const UniformBlock::Binding &binding);
+};
+
+#endif
\ No newline at end of file
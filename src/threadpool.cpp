@@ -0,0 +1,67 @@
+#include "threadpool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(const std::size_t &threads) : stop(false)
+{
+    const std::size_t count = threads == 0U ? std::max(1U, std::thread::hardware_concurrency()) : threads;
+
+    for (std::size_t i = 0U; i < count; i++)
+    {
+        worker_stock.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+void ThreadPool::work()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stop || !task_queue.empty(); });
+
+            if (stop)
+            {
+                return;
+            }
+
+            task = std::move(task_queue.front());
+            task_queue.pop_front();
+        }
+
+        task();
+    }
+}
+
+void ThreadPool::submit(const std::function<void()> &task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task_queue.emplace_back(task);
+    }
+
+    condition.notify_one();
+}
+
+std::size_t ThreadPool::getThreads() const
+{
+    return worker_stock.size();
+}
+
+ThreadPool::~ThreadPool()
+{
+    // Pending tasks are dropped, the running ones are waited for
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        task_queue.clear();
+    }
+
+    condition.notify_all();
+
+    for (std::thread &worker : worker_stock)
+    {
+        worker.join();
+    }
+}
\ No newline at end of file
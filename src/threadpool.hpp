@@ -0,0 +1,32 @@
+#ifndef __THREAD_POOL_HPP_
+#define __THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Fixed set of worker threads running the submitted tasks in order */
+class ThreadPool
+{
+private:
+    std::vector<std::thread> worker_stock;
+    std::deque<std::function<void()>> task_queue;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stop;
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    void work();
+
+public:
+    ThreadPool(const std::size_t &threads = 0U);
+    void submit(const std::function<void()> &task);
+    std::size_t getThreads() const;
+    virtual ~ThreadPool();
+};
+
+#endif
\ No newline at end of file